@@ -1,211 +1,666 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <chrono>
+#include <type_traits>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KB_USE_SSE2 1
+#endif
 
 using namespace std;
 
-//  Ʈ ϳ ũ ü
-struct Node {
-    int vertex;
-    Node* next;
+// 정점 번호 폭이 Id인 CSR 그래프 (BFS 커널 전용). 정점 u의 이웃은 target[offset[u] .. offset[u + 1])
+// 정점 수에 맞는 가장 좁은 Id를 쓰면 큐와 이웃 배열이 차지하는 캐시가 줄어듦
+template <typename Id>
+struct IdGraph {
+    size_t* offset = nullptr;
+    Id* target = nullptr;
+    int N = 0;
+};
+
+// 정점 수에 맞게 하나의 폭만 채운 커널용 그래프 묶음
+struct KernelGraphs {
+    int idBits = 32;
+    IdGraph<uint16_t> narrow;
+    IdGraph<uint32_t> regular;
+    IdGraph<uint64_t> wide;
+};
+
+// BFS 작업 공간: 탐색마다 필요한 배열과 큐. 스레드마다 하나씩 두고 재사용
+// dist는 stamp[v] == epoch일 때만 유효하므로 새 탐색은 epoch 증가만으로 초기화됨
+// 거리는 N - 1을 넘지 않으므로 번호와 같은 폭으로 저장
+template <typename Id>
+struct BfsWorkspace {
+    Id* dist = nullptr;
+    Id* queue = nullptr;
+    unsigned* stamp = nullptr;
+    unsigned epoch = 0;
+    int  N = 0;
+    size_t qHead = 0, qTail = 0;
+};
+
+// 읽기 전용 메모리 매핑 파일
+struct MappedFile {
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
 };
 
-// BFS  迭   ť
-int* distArr;
-int* prevArr;
-int* queueArr;
-int  Qsize, qHead, qTail;
-
-// ׷ о  Ʈ , N   ȯ
-Node** readGraph(const char* filename, int& N) {
-    ifstream infile(filename);
-    if (!infile) {
-        cerr << "  : " << filename << endl;
-        return nullptr;
-    }
-
-    infile >> N;
-    infile.ignore();  // ù   Һ
-
-    Node** adj = new Node * [N + 1];
-    for (int i = 1; i <= N; ++i) adj[i] = nullptr;
-
-    string line;
-    int linesRead = 0;
-    while (linesRead < N && getline(infile, line)) {
-        if (line.empty()) continue;
-        int idx = 0;
-        // u Ľ
-        while (idx < (int)line.size() && (line[idx] == ' ' || line[idx] == '\t')) ++idx;
-        int start = idx;
-        while (idx < (int)line.size() && line[idx] >= '0' && line[idx] <= '9') ++idx;
-        int u = 0;
-        for (int k = start; k < idx; ++k) u = u * 10 + (line[k] - '0');
-        // v Ľ
-        while (idx < (int)line.size()) {
-            if (line[idx] < '0' || line[idx] > '9') { ++idx; continue; }
-            start = idx;
-            while (idx < (int)line.size() && line[idx] >= '0' && line[idx] <= '9') ++idx;
-            int v = 0;
-            for (int k = start; k < idx; ++k) v = v * 10 + (line[k] - '0');
-            //   ߰
-            Node* n1 = new Node{ v, adj[u] }; adj[u] = n1;
-            Node* n2 = new Node{ u, adj[v] }; adj[v] = n2;
+bool mapFile(const char* filename, MappedFile& mf) {
+    mf.data = nullptr;
+    mf.size = 0;
+#ifdef _WIN32
+    mf.mapping = nullptr;
+    mf.file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (mf.file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(mf.file, &fileSize)) return false;
+    mf.size = (size_t)fileSize.QuadPart;
+    if (mf.size == 0) return true;
+    mf.mapping = CreateFileMappingA(mf.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mf.mapping) return false;
+    mf.data = (const char*)MapViewOfFile(mf.mapping, FILE_MAP_READ, 0, 0, 0);
+    return mf.data != nullptr;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return false; }
+    mf.size = (size_t)st.st_size;
+    if (mf.size == 0) { close(fd); return true; }
+    void* p = mmap(nullptr, mf.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) { mf.size = 0; return false; }
+    madvise(p, mf.size, MADV_SEQUENTIAL);
+    mf.data = (const char*)p;
+    return true;
+#endif
+}
+
+void unmapFile(MappedFile& mf) {
+#ifdef _WIN32
+    if (mf.data) UnmapViewOfFile(mf.data);
+    if (mf.mapping) CloseHandle(mf.mapping);
+    if (mf.file != INVALID_HANDLE_VALUE) CloseHandle(mf.file);
+#else
+    if (mf.data) munmap((void*)mf.data, mf.size);
+#endif
+    mf.data = nullptr;
+    mf.size = 0;
+}
+
+bool isDigitChar(char c) { return (unsigned char)(c - '0') < 10; }
+
+#ifdef KB_USE_SSE2
+// 16바이트 중 숫자인 위치의 비트 마스크
+unsigned digitMask16(const char* p) {
+    __m128i c = _mm_loadu_si128((const __m128i*)p);
+    __m128i ge = _mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1));
+    __m128i le = _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1));
+    return (unsigned)_mm_movemask_epi8(_mm_and_si128(ge, le));
+}
+
+unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (unsigned)idx;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+// 다음 숫자 시작 위치 (없으면 end)
+const char* skipToDigit(const char* p, const char* end) {
+#ifdef KB_USE_SSE2
+    for (; end - p >= 16; p += 16) {
+        unsigned m = digitMask16(p);
+        if (m) return p + lowestBit(m);
+    }
+#endif
+    while (p < end && !isDigitChar(*p)) ++p;
+    return p;
+}
+
+// 연속된 숫자의 길이
+size_t digitRunLength(const char* p, const char* end) {
+    const char* start = p;
+#ifdef KB_USE_SSE2
+    for (; end - p >= 16; p += 16) {
+        unsigned m = ~digitMask16(p) & 0xFFFFu;
+        if (m) return (size_t)(p - start) + lowestBit(m);
+    }
+#endif
+    while (p < end && isDigitChar(*p)) ++p;
+    return (size_t)(p - start);
+}
+
+// 숫자 변환: 8자리 이하이고 8바이트를 읽을 수 있으면 분기 없는 SWAR 방식 사용
+// 긴 숫자는 INT_MAX를 넘으면 더 누적하지 않음 (반환값이 INT_MAX보다 크면 범위 밖 번호, 오버플로로 작은 값이 되지 않음)
+long long parseDigits(const char* p, size_t len, const char* bufEnd) {
+    if (len >= 1 && len <= 8 && bufEnd - p >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        v -= 0x3030303030303030ULL;
+        v <<= 8 * (8 - len);
+        v = (v * 10) + (v >> 8);
+        v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+            (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+        return (long long)(uint32_t)v;
+    }
+    long long x = 0;
+    for (size_t k = 0; k < len && x <= INT_MAX; ++k) x = x * 10 + (p[k] - '0');
+    return x;
+}
+
+// [begin, end) 구간의 줄을 파싱해 (u, v) 간선을 스레드별 버퍼에 저장
+void parseChunk(const char* begin, const char* end, const char* bufEnd, int N, vector<int>& edges) {
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!lineEnd) lineEnd = end;
+        int u = -1;
+        while ((p = skipToDigit(p, lineEnd)) < lineEnd) {
+            size_t len = digitRunLength(p, lineEnd);
+            long long x = parseDigits(p, len, bufEnd);
+            p += len;
+            if (x < 1 || x > N) { if (u < 0) u = 0; continue; } // 범위 밖 번호는 무시
+            if (u < 0) { u = (int)x; continue; }
+            if (u == 0) continue;
+            edges.push_back(u);
+            edges.push_back((int)x);
         }
-        ++linesRead;
-    }
-    infile.close();
-    return adj;
-}
-
-// BFS 迭  ť ʱȭ
-void initBFS(int N) {
-    distArr = new int[N + 1];
-    prevArr = new int[N + 1];
-    queueArr = new int[N + 1];
-    Qsize = N + 1;
-}
-
-//  ť 
-void enqueue(int x) { queueArr[qTail] = x; qTail = (qTail + 1) % Qsize; }
-int  dequeue() { int x = queueArr[qHead]; qHead = (qHead + 1) % Qsize; return x; }
-bool isEmpty() { return qHead == qTail; }
-
-// startκ   ִ Ÿ   
-void bfs(int start, int N, Node** adj) {
-    for (int i = 1; i <= N; ++i) {
-        distArr[i] = -1;
-        prevArr[i] = -1;
-    }
-    qHead = qTail = 0;
-    distArr[start] = 0;
-    prevArr[start] = 0;
-    enqueue(start);
-    while (!isEmpty()) {
-        int u = dequeue();
-        for (Node* p = adj[u]; p; p = p->next) {
-            int v = p->vertex;
-            if (distArr[v] == -1) {
-                distArr[v] = distArr[u] + 1;
-                prevArr[v] = u;
-                enqueue(v);
+        p = lineEnd + 1;
+    }
+}
+
+// 스레드별로 파싱한 간선을 prefix-sum으로 정한 위치에 바로 배치해 번호 폭이 Id인 CSR을 채움
+// offset의 소유권은 g로 넘어감. cursor[u]는 0에서 시작해 정점 u에 이미 배치한 이웃 수를 셈
+template <typename Id>
+void placeEdges(IdGraph<Id>& g, int N, size_t* offset, const vector<vector<int>>& edges, atomic<int>* cursor) {
+    size_t total = offset[N + 1];
+    g.N = N;
+    g.offset = offset;
+    g.target = new Id[total > 0 ? total : 1];
+    vector<thread> workers;
+    for (size_t t = 0; t < edges.size(); ++t) {
+        workers.emplace_back([&, t]() {
+            const vector<int>& e = edges[t];
+            for (size_t k = 0; k < e.size(); k += 2) {
+                int u = e[k], v = e[k + 1];
+                g.target[offset[u] + cursor[u].fetch_add(1, memory_order_relaxed)] = (Id)v;
+                g.target[offset[v] + cursor[v].fetch_add(1, memory_order_relaxed)] = (Id)u;
+            }
+        });
+    }
+    for (thread& w : workers) w.join();
+}
+
+// 그래프를 읽어 정점 수에 맞는 가장 좁은 번호 폭의 CSR로 graphs를 채우고, N에 배우 수 반환
+// 파일을 메모리 매핑하고 줄 경계로 나눈 구간을 스레드마다 파싱한 뒤,
+// 차수의 prefix-sum으로 각 정점의 이웃 위치를 정해 하나의 배열에 바로 배치 (중간 표현 없이 한 번만 만듦)
+bool readGraph(const char* filename, int& N, KernelGraphs& graphs) {
+    MappedFile mf;
+    if (!mapFile(filename, mf)) {
+        cerr << "파일 열기 실패: " << filename << endl;
+        return false;
+    }
+
+    const char* end = mf.data + mf.size;
+    const char* p = skipToDigit(mf.data, end);
+    if (p == end) {
+        unmapFile(mf);
+        cerr << "파일 형식 오류: " << filename << endl;
+        return false;
+    }
+    size_t len = digitRunLength(p, end);
+    long long n = parseDigits(p, len, end);
+    if (n > INT_MAX) {
+        unmapFile(mf);
+        cerr << "파일 형식 오류: " << filename << endl;
+        return false;
+    }
+    N = (int)n;
+    const char* body = (const char*)memchr(p, '\n', (size_t)(end - p));
+    body = body ? body + 1 : end;  // 첫 줄 개행 소비
+
+    // 줄 경계에 맞춘 스레드별 구간 (구간당 최소 1MB)
+    size_t bodySize = (size_t)(end - body);
+    unsigned T = thread::hardware_concurrency();
+    if (T == 0) T = 1;
+    if (T > bodySize / (1 << 20) + 1) T = (unsigned)(bodySize / (1 << 20) + 1);
+    vector<const char*> cut(T + 1);
+    cut[0] = body;
+    cut[T] = end;
+    for (unsigned t = 1; t < T; ++t) {
+        const char* c = body + bodySize * t / T;
+        if (c < cut[t - 1]) c = cut[t - 1];
+        const char* nl = (const char*)memchr(c, '\n', (size_t)(end - c));
+        cut[t] = nl ? nl + 1 : end;
+    }
+
+    vector<vector<int>> edges(T);
+    vector<thread> workers;
+    for (unsigned t = 0; t < T; ++t)
+        workers.emplace_back(parseChunk, cut[t], cut[t + 1], end, N, ref(edges[t]));
+    for (thread& w : workers) w.join();
+    workers.clear();
+    unmapFile(mf);
+
+    // 정점별 차수 (스레드 간 공유하므로 원자적 증가)
+    atomic<int>* degree = new atomic<int>[N + 2];
+    for (int i = 0; i <= N + 1; ++i) degree[i].store(0);
+    for (unsigned t = 0; t < T; ++t) {
+        workers.emplace_back([&, t]() {
+            const vector<int>& e = edges[t];
+            for (size_t k = 0; k < e.size(); k += 2) {
+                degree[e[k]].fetch_add(1, memory_order_relaxed);
+                degree[e[k + 1]].fetch_add(1, memory_order_relaxed);
+            }
+        });
+    }
+    for (thread& w : workers) w.join();
+    workers.clear();
+
+    // 병렬 prefix-sum: 블록 합 → 블록 시작값 → 블록 내부 누적
+    size_t* offset = new size_t[N + 2];
+    offset[0] = 0;
+    size_t* blockSum = new size_t[T + 1];
+    blockSum[0] = 0;
+    for (unsigned t = 0; t < T; ++t) {
+        workers.emplace_back([&, t]() {
+            size_t s = 0;
+            for (int i = 1 + (int)((long long)N * t / T); i < 1 + (int)((long long)N * (t + 1) / T); ++i) s += degree[i].load(memory_order_relaxed);
+            blockSum[t + 1] = s;
+        });
+    }
+    for (thread& w : workers) w.join();
+    workers.clear();
+    for (unsigned t = 0; t < T; ++t) blockSum[t + 1] += blockSum[t];
+    for (unsigned t = 0; t < T; ++t) {
+        workers.emplace_back([&, t]() {
+            size_t s = blockSum[t];
+            for (int i = 1 + (int)((long long)N * t / T); i < 1 + (int)((long long)N * (t + 1) / T); ++i) {
+                offset[i] = s;
+                s += degree[i].load(memory_order_relaxed);
+                degree[i].store(0, memory_order_relaxed);  // 배치 단계의 커서로 재사용
+            }
+        });
+    }
+    for (thread& w : workers) w.join();
+    workers.clear();
+    size_t total = blockSum[T];
+    offset[N + 1] = total;
+    delete[] blockSum;
+
+    // 번호는 1..N이므로 N이 들어가는 가장 좁은 폭을 고르고, 정점 u의 이웃을 offset[u]부터 연속으로 배치
+    graphs.idBits = N <= 0xFFFF ? 16 : ((uint64_t)N <= UINT32_MAX ? 32 : 64);
+    if (graphs.idBits == 16) placeEdges(graphs.narrow, N, offset, edges, degree);
+    else if (graphs.idBits == 32) placeEdges(graphs.regular, N, offset, edges, degree);
+    else placeEdges(graphs.wide, N, offset, edges, degree);
+    delete[] degree;
+    return true;
+}
+
+template <typename Id>
+void freeIdGraph(IdGraph<Id>& g) {
+    delete[] g.offset;
+    delete[] g.target;
+    g.offset = nullptr;
+    g.target = nullptr;
+}
+
+
+void freeKernelGraphs(KernelGraphs& graphs) {
+    freeIdGraph(graphs.narrow);
+    freeIdGraph(graphs.regular);
+    freeIdGraph(graphs.wide);
+}
+
+// 불러올 때 정한 폭의 그래프로 body 실행 (body는 세 폭 모두에 대해 컴파일됨)
+template <typename Body>
+auto withKernel(const KernelGraphs& graphs, Body body) -> decltype(body(graphs.regular)) {
+    if (graphs.idBits == 16) return body(graphs.narrow);
+    if (graphs.idBits == 64) return body(graphs.wide);
+    return body(graphs.regular);
+}
+
+// BFS 작업 공간 할당 (N + 1 크기, 이후 탐색마다 재사용)
+template <typename Id>
+void initWorkspace(BfsWorkspace<Id>& ws, int N) {
+    ws.dist = new Id[N + 1];
+    ws.queue = new Id[N + 1];
+    ws.stamp = new unsigned[N + 1];
+    for (int i = 0; i <= N; ++i) ws.stamp[i] = 0;
+    ws.epoch = 0;
+    ws.N = N;
+    ws.qHead = ws.qTail = 0;
+}
+
+template <typename Id>
+void freeWorkspace(BfsWorkspace<Id>& ws) {
+    delete[] ws.dist;
+    delete[] ws.queue;
+    delete[] ws.stamp;
+    ws.dist = ws.queue = nullptr;
+    ws.stamp = nullptr;
+}
+
+// 새 탐색 시작: 이전 탐색의 기록을 O(1)에 무효화 (epoch가 한 바퀴 돌 때만 전체 초기화)
+template <typename Id>
+void newSearch(BfsWorkspace<Id>& ws) {
+    if (++ws.epoch == 0) {
+        for (int i = 0; i <= ws.N; ++i) ws.stamp[i] = 0;
+        ws.epoch = 1;
+    }
+    ws.qHead = ws.qTail = 0;
+}
+
+template <typename Id>
+bool visited(const BfsWorkspace<Id>& ws, size_t v) { return ws.stamp[v] == ws.epoch; }
+
+// 마지막 탐색에서의 거리 (방문하지 못했으면 -1)
+template <typename Id>
+int distanceTo(const BfsWorkspace<Id>& ws, int v) { return visited(ws, v) ? (int)ws.dist[v] : -1; }
+
+// 큐 연산 (각 정점은 한 번만 들어가므로 N + 1 칸이면 충분)
+template <typename Id>
+void enqueue(BfsWorkspace<Id>& ws, Id x) { ws.queue[ws.qTail++] = x; }
+template <typename Id>
+Id   dequeue(BfsWorkspace<Id>& ws) { return ws.queue[ws.qHead++]; }
+template <typename Id>
+bool isEmpty(const BfsWorkspace<Id>& ws) { return ws.qHead == ws.qTail; }
+
+// start에서 레벨 단위로 BFS 확장 (현재 epoch에 이어서 기록하므로 여러 출발점이 방문 표시를 공유할 수 있음)
+// Id: 정점 번호 폭, TrackDistance: dist 기록 여부, DepthLimited: maxDepth 단계까지만 탐색
+// 단계는 큐의 레벨 경계로 세므로 거리 배열 없이도 깊이 제한이 가능함
+template <typename Id, bool TrackDistance, bool DepthLimited>
+void expand(Id start, const IdGraph<Id>& g, BfsWorkspace<Id>& ws, int maxDepth) {
+    ws.stamp[start] = ws.epoch;
+    if (TrackDistance) ws.dist[start] = 0;
+    enqueue(ws, start);
+    for (int depth = 0; !isEmpty(ws); ++depth) {
+        if (DepthLimited && depth == maxDepth) break;
+        size_t levelEnd = ws.qTail;
+        while (ws.qHead < levelEnd) {
+            Id u = dequeue(ws);
+            for (size_t e = g.offset[u]; e < g.offset[(size_t)u + 1]; ++e) {
+                Id v = g.target[e];
+                if (!visited(ws, v)) {
+                    ws.stamp[v] = ws.epoch;
+                    if (TrackDistance) ws.dist[v] = (Id)(depth + 1);
+                    enqueue(ws, v);
+                }
             }
         }
     }
 }
 
-//   ׷  
-int countComponents(int N, Node** adj) {
-    bool* visited = new bool[N + 1];
-    for (int i = 1; i <= N; ++i) visited[i] = false;
+// start로부터 새 탐색 (방문한 정점은 ws.queue[0 .. ws.qTail)에 방문 순서대로 남음)
+template <typename Id, bool TrackDistance, bool DepthLimited>
+void bfs(Id start, const IdGraph<Id>& g, BfsWorkspace<Id>& ws, int maxDepth = 0) {
+    newSearch(ws);
+    expand<Id, TrackDistance, DepthLimited>(start, g, ws, maxDepth);
+}
+
+// 연결되지 않은 그룹 수 계산 (한 epoch 안에서 도달 여부만 기록하며 확장)
+template <typename Id>
+int countComponents(const IdGraph<Id>& g, BfsWorkspace<Id>& ws) {
+    newSearch(ws);
     int groups = 0;
-    qHead = qTail = 0;
-    for (int i = 1; i <= N; ++i) {
-        if (!visited[i]) {
+    for (int i = 1; i <= g.N; ++i) {
+        if (!visited(ws, i)) {
             ++groups;
-            visited[i] = true;
-            enqueue(i);
-            while (!isEmpty()) {
-                int u = dequeue();
-                for (Node* p = adj[u]; p; p = p->next) {
-                    int v = p->vertex;
-                    if (!visited[v]) { visited[v] = true; enqueue(v); }
-                }
-            }
+            expand<Id, false, false>((Id)i, g, ws, 0);
         }
     }
-    delete[] visited;
     return groups;
 }
 
+// a에서 b까지의 거리 (연결되지 않았으면 -1)
+template <typename Id>
+int distanceBetween(const IdGraph<Id>& g, BfsWorkspace<Id>& ws, int a, int b) {
+    bfs<Id, true, false>((Id)a, g, ws);
+    return distanceTo(ws, b);
+}
+
+// 모든 정점 i에 대해 k단계 이내 도달 여부를 reach[i]에 기록
+// 스레드마다 자기 BfsWorkspace를 한 번만 만들어 여러 출발점에 재사용
+template <typename Id>
+void computeReach(const IdGraph<Id>& g, int k, bool** reach) {
+    int N = g.N;
+    unsigned T = thread::hardware_concurrency();
+    if (T == 0) T = 1;
+    if (T > (unsigned)N) T = (unsigned)N;
+    vector<thread> workers;
+    for (unsigned t = 0; t < T; ++t) {
+        workers.emplace_back([=, &g]() {
+            BfsWorkspace<Id> ws;
+            initWorkspace(ws, N);
+            for (int i = 1 + (int)t; i <= N; i += (int)T) {
+                for (int j = 1; j <= N; ++j) reach[i][j] = false;
+                bfs<Id, false, true>((Id)i, g, ws, k);
+                for (size_t q = 0; q < ws.qTail; ++q) reach[i][ws.queue[q]] = true;
+            }
+            freeWorkspace(ws);
+        });
+    }
+    for (thread& w : workers) w.join();
+}
+
+// 후보 i가 아직 커버되지 않은 정점을 몇 개 새로 커버하는지
+int newCover(int N, bool** reach, const bool* covered, int i) {
+    int cnt = 0;
+    for (int j = 1; j <= N; ++j) {
+        if (reach[i][j] && !covered[j]) cnt++;
+    }
+    return cnt;
+}
+
+// 그리디 셋 커버: targetCount개 이상 커버되면 중단, 선택 수 반환
+// epsilon > 0이면 확률적 그리디로, 매 라운드 남은 후보 중 (N / r) * ln(1 / epsilon)개만 무작위로 평가
+// (r = 지금까지 선택 수 + 남은 정점 수 / 직전 라운드 커버 수, 첫 라운드는 전체 평가)
+// epsilon = 0이면 매 라운드 모든 후보를 번호 순으로 평가하는 정확한 그리디
+int greedyCover(int N, bool** reach, int targetCount, double epsilon, unsigned seed,
+    int* selected, int& coveredCount, long long& evaluations) {
+    bool* covered = new bool[N + 1];
+    int* candidates = new int[N];
+    for (int i = 1; i <= N; ++i) { covered[i] = false; candidates[i - 1] = i; }
+    int remaining = N; // candidates[0..remaining)가 아직 선택되지 않은 후보
+    int selCount = 0;
+    int lastGain = 0;
+    coveredCount = 0;
+    evaluations = 0;
+    mt19937 rng(seed);
+
+    while (coveredCount < targetCount) {
+        int evaluate = remaining;
+        if (epsilon > 0 && lastGain > 0) {
+            double r = selCount + (double)(N - coveredCount) / lastGain;
+            double sample = ceil(N / r * log(1 / epsilon));
+            if (sample < evaluate) evaluate = sample < 1 ? 1 : (int)sample;
+            // 앞쪽 evaluate개를 무작위 표본으로 섞음 (부분 Fisher-Yates)
+            for (int i = 0; i < evaluate; ++i) {
+                uniform_int_distribution<int> pick(i, remaining - 1);
+                swap(candidates[i], candidates[pick(rng)]);
+            }
+        }
+
+        int best = -1, bestCover = 0;
+        for (int i = 0; i < evaluate; ++i) {
+            int cnt = newCover(N, reach, covered, candidates[i]);
+            evaluations++;
+            if (cnt > bestCover) { bestCover = cnt; best = i; }
+        }
+        // 표본에 새로 커버할 정점이 없으면 나머지 후보에서 다시 찾음
+        for (int i = evaluate; i < remaining && bestCover == 0; ++i) {
+            int cnt = newCover(N, reach, covered, candidates[i]);
+            evaluations++;
+            if (cnt > bestCover) { bestCover = cnt; best = i; }
+        }
+        if (bestCover == 0) break;
+
+        int chosen = candidates[best];
+        selected[selCount++] = chosen;
+        lastGain = bestCover;
+        // 정확한 그리디는 번호 순서를 유지해야 같은 점수일 때 작은 번호를 고름
+        if (epsilon > 0) candidates[best] = candidates[remaining - 1];
+        else memmove(candidates + best, candidates + best + 1, sizeof(int) * (remaining - best - 1));
+        remaining--;
+        for (int j = 1; j <= N; ++j) {
+            if (reach[chosen][j] && !covered[j]) { covered[j] = true; coveredCount++; }
+        }
+    }
+
+    delete[] covered;
+    delete[] candidates;
+    return selCount;
+}
+
 bool validNumber(int x, int N) {
     return x >= 1 && x <= N;
 }
 
 int main() {
     int N;
-    Node** adj = readGraph("kb.txt", N);
-    if (!adj) return 1;
+    KernelGraphs graphs;
+    if (!readGraph("kb.txt", N, graphs)) return 1;
 
-    initBFS(N);
+    // 1) 배우 수 출력
+    cout << "현재 저장된 배우의 수: " << N << "명\n";
 
-    // 1)   
-    cout << "   : " << N << "\n";
+    // 2) 연결되지 않은 그룹 수
+    int groups = withKernel(graphs, [&](const auto& g) {
+        typedef typename remove_pointer<decltype(g.target)>::type Id;
+        BfsWorkspace<Id> ws;
+        initWorkspace(ws, N);
+        int count = countComponents(g, ws);
+        freeWorkspace(ws);
+        return count;
+    });
+    cout << "서로 연결되지 않은 그룹의 수: " << groups << "개\n\n";
 
-    // 2)   ׷ 
-    int groups = countComponents(N, adj);
-    cout << "   ׷ : " << groups << "\n\n";
-
-    // 3)   Ÿ 
-    cout << "  ȣ Էϼ (: 3 17): ";
+    // 3) 두 배우 거리 계산
+    cout << "두 배우 번호를 입력하세요 (예: 3 17): ";
     int a, b;
     if (!(cin >> a >> b) || !validNumber(a, N) || !validNumber(b, N)) {
-        cerr << "Է : 1 " << N << "  ڿ Էּ.\n";
+        cerr << "입력 오류: 1부터 " << N << " 사이의 자연수를 입력해주세요.\n";
+        freeKernelGraphs(graphs);
         return 1;
     }
     if (a == b) {
-        cout << "  ȣ Ͽ Ÿ 0ܰԴϴ.\n";
+        cout << "두 배우 번호가 동일하여 거리는 0단계입니다.\n";
     }
     else {
-        bfs(a, N, adj);
-        if (distArr[b] != -1) {
-            cout << a << "  " << b << "  Ÿ "
-                << distArr[b] << "ܰԴϴ.\n";
+        int distance = withKernel(graphs, [&](const auto& g) {
+            typedef typename remove_pointer<decltype(g.target)>::type Id;
+            BfsWorkspace<Id> ws;
+            initWorkspace(ws, N);
+            int d = distanceBetween(g, ws, a, b);
+            freeWorkspace(ws);
+            return d;
+        });
+        if (distance != -1) {
+            cout << a << "번 배우와 " << b << "번 배우의 거리는 "
+                << distance << "단계입니다.\n";
         }
         else {
-            cout << a << "  " << b << "  Ǿ  ʽϴ.\n";
+            cout << a << "번 배우와 " << b << "번 배우는 연결되어 있지 않습니다.\n";
         }
     }
 
-    // 4) ܰ  Է¹޾ kܰ ̳  쿡 ϱ   
-    cout << "\nܰ  Էϼ (: 3): ";
+    // 4) 단계 수 입력받아 k단계 이내 모든 배우에게 연락하기 위한 배우 선택
+    //    같은 줄에 목표 커버율(%)과 확률적 그리디 epsilon을 이어서 줄 수 있음 (예: 3 99 0.1)
+    cout << "\n단계 수를 입력하세요 (예: 3, 선택: 목표 커버율% epsilon): ";
     int k;
     if (!(cin >> k) || k < 0) {
-        cerr << "Է : ܰ 0 ̻ ڿ մϴ.\n";
+        cerr << "입력 오류: 단계는 0 이상인 자연수여야 합니다.\n";
+        freeKernelGraphs(graphs);
         return 1;
     }
+    double targetPercent = 100, epsilon = 0;
+    string rest;
+    getline(cin, rest);
+    istringstream options(rest);
+    if (options >> targetPercent) options >> epsilon;
+    if (targetPercent <= 0 || targetPercent > 100 || epsilon < 0 || epsilon >= 1) {
+        cerr << "입력 오류: 목표 커버율은 0~100, epsilon은 0 이상 1 미만이어야 합니다.\n";
+        freeKernelGraphs(graphs);
+        return 1;
+    }
+    int targetCount = (int)ceil(targetPercent / 100 * N - 1e-9);
 
-    // k-̳ reachability 
+    // k-이내 reachability 계산
     bool** reach = new bool* [N + 1];
-    for (int i = 1; i <= N; ++i) {
-        reach[i] = new bool[N + 1];
-        for (int j = 1; j <= N; ++j) reach[i][j] = false;
-        bfs(i, N, adj);
-        for (int j = 1; j <= N; ++j) {
-            if (distArr[j] != -1 && distArr[j] <= k) reach[i][j] = true;
-        }
-    }
+    for (int i = 1; i <= N; ++i) reach[i] = new bool[N + 1];
+    withKernel(graphs, [&](const auto& g) {
+        computeReach(g, k, reach);
+        return 0;
+    });
 
-    bool* covered = new bool[N + 1];
-    bool* used = new bool[N + 1];
     int* selected = new int[N + 1];
-    for (int i = 1; i <= N; ++i) { covered[i] = false; used[i] = false; }
     int coveredCount = 0;
-    int selCount = 0;
+    long long evaluations = 0;
+    auto begin = chrono::steady_clock::now();
+    int selCount = greedyCover(N, reach, targetCount, epsilon, 12345, selected, coveredCount, evaluations);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
 
-    // ׸  Ŀ
-    while (coveredCount < N) {
-        int best = 0, bestCover = 0;
-        for (int i = 1; i <= N; ++i) {
-            if (used[i]) continue;
-            int cnt = 0;
-            for (int j = 1; j <= N; ++j) {
-                if (reach[i][j] && !covered[j]) cnt++;
-            }
-            if (cnt > bestCover) { bestCover = cnt; best = i; }
-        }
-        if (bestCover == 0) break;
-        used[best] = true;
-        selected[selCount++] = best;
-        for (int j = 1; j <= N; ++j) {
-            if (reach[best][j] && !covered[j]) { covered[j] = true; coveredCount++; }
-        }
+    if (targetCount == N) {
+        cout << "\n단계 " << k << " 이내에 모든 배우에게 연락하려면 다음 배우들에게 연락하세요:\n";
+    }
+    else {
+        cout << "\n단계 " << k << " 이내에 배우의 " << targetPercent << "% 이상에게 연락하려면 다음 배우들에게 연락하세요:\n";
     }
-
-    cout << "\nܰ " << k << " ̳  쿡 Ϸ  鿡 ϼ:\n";
     for (int i = 0; i < selCount; ++i) {
-        cout << "  -  ȣ " << selected[i] << "\n";
+        cout << "  - 배우 번호 " << selected[i] << "\n";
+    }
+
+    // 부분 커버나 확률적 그리디는 같은 목표의 정확한 그리디와 비교
+    if (epsilon > 0 || targetCount < N) {
+        int* exactSelected = new int[N + 1];
+        int exactCovered = 0;
+        long long exactEvaluations = 0;
+        begin = chrono::steady_clock::now();
+        int exactCount = greedyCover(N, reach, targetCount, 0, 0, exactSelected, exactCovered, exactEvaluations);
+        double exactMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        cout << "\n정확한 그리디와 비교:\n";
+        cout << "  이번 결과: " << selCount << "명, " << coveredCount << "명 커버, 후보 평가 "
+            << evaluations << "회, " << ms << " ms\n";
+        cout << "  정확한 그리디: " << exactCount << "명, " << exactCovered << "명 커버, 후보 평가 "
+            << exactEvaluations << "회, " << exactMs << " ms\n";
+        if (exactCount > 0) cout << "  크기 비율: " << (double)selCount / exactCount << "배\n";
+        delete[] exactSelected;
     }
 
+    for (int i = 1; i <= N; ++i) delete[] reach[i];
+    delete[] reach;
+    delete[] selected;
+    freeKernelGraphs(graphs);
     return 0;
 }
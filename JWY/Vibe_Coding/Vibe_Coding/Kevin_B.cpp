@@ -7,266 +7,3091 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <new>
+#include <mutex>
+#include <type_traits>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KB_USE_SSE2 1
+#endif
 
 using namespace std;
 
+// std::set<int> 노드 하나의 대략적 크기 (값 + 부모/자식 포인터 + 색), 계측의 메모리 추정용
+const size_t SET_NODE_BYTES = sizeof(int) + 4 * sizeof(void*);
+
+// 사용할 작업 스레드 수
+unsigned workerCount() {
+    unsigned n = thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// [0, n) 구간을 threads개로 나누어 병렬 실행. body(begin, end, threadIndex)
+template <typename Body>
+void runParallel(size_t n, unsigned threads, Body body) {
+    if (threads <= 1 || n < 2) {
+        body(size_t(0), n, 0u);
+        return;
+    }
+    if (threads > n) threads = (unsigned)n;
+
+    vector<thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back([&, t]() { body(n * t / threads, n * (t + 1) / threads, t); });
+    }
+    body(size_t(0), n / threads, 0u);
+    for (thread& w : workers) w.join();
+}
+
+// 병렬 exclusive prefix-sum: out[i] = counts[0] + ... + counts[i - 1], out[n] = 전체 합
+template <typename Count>
+void parallelPrefixSum(const Count* counts, size_t n, vector<size_t>& out, unsigned threads) {
+    out.assign(n + 1, 0);
+    if (threads > n) threads = n == 0 ? 1 : (unsigned)n;
+
+    // 1단계: 블록별 합계
+    vector<size_t> blockSum(threads + 1, 0);
+    runParallel(n, threads, [&](size_t begin, size_t end, unsigned t) {
+        size_t sum = 0;
+        for (size_t i = begin; i < end; i++) sum += (size_t)counts[i];
+        blockSum[t + 1] = sum;
+    });
+    // 2단계: 블록 합계의 누적 (블록 수가 적으므로 순차 처리)
+    for (unsigned t = 0; t < threads; t++) blockSum[t + 1] += blockSum[t];
+    // 3단계: 블록 내부 누적
+    runParallel(n, threads, [&](size_t begin, size_t end, unsigned t) {
+        size_t running = blockSum[t];
+        for (size_t i = begin; i < end; i++) {
+            out[i] = running;
+            running += (size_t)counts[i];
+        }
+    });
+    out[n] = blockSum[threads];
+}
+
+// 읽기 전용 메모리 매핑 파일 (대용량 그래프 파일을 복사 없이 읽기 위함)
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mapHandle;
+#endif
+
+public:
+    MappedFile() : data(nullptr), length(0) {
+#ifdef _WIN32
+        fileHandle = INVALID_HANDLE_VALUE;
+        mapHandle = nullptr;
+#endif
+    }
+    ~MappedFile() { close(); }
+
+    bool open(const string& filename) {
+        close();
+#ifdef _WIN32
+        fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize)) return false;
+        length = (size_t)fileSize.QuadPart;
+        if (length == 0) return true;
+        mapHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapHandle == nullptr) return false;
+        data = (const char*)MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+        return data != nullptr;
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)st.st_size;
+        if (length == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            length = 0;
+            return false;
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        data = (const char*)mapped;
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapHandle) CloseHandle(mapHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mapHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap((void*)data, length);
+#endif
+        data = nullptr;
+        length = 0;
+    }
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    size_t size() const { return length; }
+};
+
+inline bool isDigitChar(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+inline unsigned countTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// 가장 높은 1 비트의 위치 (value > 0)
+inline unsigned highestBit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    if (value >> 32) {
+        _BitScanReverse(&index, (unsigned long)(value >> 32));
+        return (unsigned)index + 32;
+    }
+    _BitScanReverse(&index, (unsigned long)value);
+    return (unsigned)index;
+#else
+    return 63u - (unsigned)__builtin_clzll(value);
+#endif
+}
+
+#ifdef KB_USE_SSE2
+// 16바이트 중 숫자('0'~'9')인 위치의 비트 마스크
+inline unsigned digitMask16(const char* p) {
+    __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+    __m128i geZero = _mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1));
+    __m128i leNine = _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1));
+    return (unsigned)_mm_movemask_epi8(_mm_and_si128(geZero, leNine));
+}
+#endif
+
+// 다음 숫자의 시작 위치까지 건너뛰기 (없으면 end)
+inline const char* skipToDigit(const char* p, const char* end) {
+#ifdef KB_USE_SSE2
+    while (end - p >= 16) {
+        unsigned mask = digitMask16(p);
+        if (mask) return p + countTrailingZeros(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && !isDigitChar(*p)) ++p;
+    return p;
+}
+
+// p부터 이어지는 숫자의 길이
+inline size_t digitRunLength(const char* p, const char* end) {
+    const char* start = p;
+#ifdef KB_USE_SSE2
+    while (end - p >= 16) {
+        unsigned nonDigit = ~digitMask16(p) & 0xFFFFu;
+        if (nonDigit) return (size_t)(p - start) + countTrailingZeros(nonDigit);
+        p += 16;
+    }
+#endif
+    while (p < end && isDigitChar(*p)) ++p;
+    return (size_t)(p - start);
+}
+
+// 최대 8자리 숫자를 분기 없이 변환 (SWAR). p부터 8바이트를 읽을 수 있어야 함
+inline uint32_t parseDigitsSwar(const char* p, size_t len) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    v -= 0x3030303030303030ULL;
+    v <<= 8 * (8 - len); // 앞쪽 빈자리는 0으로 채워짐
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+        (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return (uint32_t)v;
+}
+
+// 숫자 문자열 변환. bufferEnd는 매핑된 버퍼의 끝 (SWAR 읽기 범위 확인용)
+// INT_MAX를 넘으면 더 누적하지 않으므로 긴 숫자도 오버플로 없이 INT_MAX보다 큰 값으로 돌려줌 (호출하는 쪽에서 무시)
+inline long long parseDigits(const char* p, size_t len, const char* bufferEnd) {
+    if (len >= 1 && len <= 8 && bufferEnd - p >= 8) {
+        return parseDigitsSwar(p, len);
+    }
+    long long value = 0;
+    for (size_t i = 0; i < len && value <= INT_MAX; i++) value = value * 10 + (p[i] - '0');
+    return value;
+}
+
+// 스레드 하나가 파싱한 간선 버퍼
+struct EdgeChunk {
+    vector<pair<int, int>> edges;
+    int minNode = INT_MAX;
+    int maxNode = 0;
+};
+
+// [begin, end) 구간의 줄들을 파싱. 줄의 첫 숫자가 노드, 나머지가 이웃
+void parseEdgeChunk(const char* begin, const char* end, const char* bufferEnd, EdgeChunk& out) {
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!lineEnd) lineEnd = end;
+
+        bool hasNode = false;
+        int node = 0;
+        while (true) {
+            p = skipToDigit(p, lineEnd);
+            if (p >= lineEnd) break;
+            size_t len = digitRunLength(p, lineEnd);
+            long long value = parseDigits(p, len, bufferEnd);
+            p += len;
+            if (value > INT_MAX) continue; // 범위를 벗어난 번호는 무시
+
+            int id = (int)value;
+            out.minNode = min(out.minNode, id);
+            out.maxNode = max(out.maxNode, id);
+            if (!hasNode) {
+                node = id;
+                hasNode = true;
+            }
+            else {
+                out.edges.push_back({ node, id });
+            }
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// 반복 BFS용 탐색 컨텍스트
+// 방문 여부를 세대(epoch) 번호로 기록하므로 새 탐색은 O(1)에 초기화되고,
+// 탐색 비용은 실제로 방문한 노드 수에만 비례함. 스레드마다 하나씩 두고 재사용
+class TraversalContext {
+private:
+    vector<unsigned> stamp; // stamp[v] == epoch 이면 이번 탐색에서 방문한 노드
+    vector<int> dist;
+    vector<int> parentOf;
+    vector<int> order;      // 방문 순서 (BFS 큐로도 사용)
+    unsigned epoch;
+    size_t head, tail;
+
+public:
+    TraversalContext() : epoch(0), head(0), tail(0) {}
+
+    // 새 탐색 시작 (노드 수가 늘었을 때만 배열 확장). 새로 잡은 메모리 바이트 수 반환
+    size_t reset(size_t nodeCount) {
+        size_t grown = 0;
+        if (stamp.size() < nodeCount) {
+            grown = (nodeCount - stamp.size()) * (sizeof(unsigned) + sizeof(int) * 3);
+            stamp.resize(nodeCount, 0);
+            dist.resize(nodeCount);
+            parentOf.resize(nodeCount);
+            order.resize(nodeCount);
+        }
+        if (++epoch == 0) { // 한 바퀴 돌면 한 번만 전체 초기화
+            fill(stamp.begin(), stamp.end(), 0u);
+            epoch = 1;
+        }
+        head = tail = 0;
+        return grown;
+    }
+
+    bool visited(int node) const { return stamp[node] == epoch; }
+
+    // 노드 방문 처리 후 큐에 추가
+    void visit(int node, int distance, int parent) {
+        stamp[node] = epoch;
+        dist[node] = distance;
+        parentOf[node] = parent;
+        order[tail++] = node;
+    }
+
+    bool empty() const { return head == tail; }
+    int pop() { return order[head++]; }
+    size_t pending() const { return tail - head; } // 큐에 남은 노드 수 (현재 단계 크기)
+
+    int distance(int node) const { return visited(node) ? dist[node] : -1; }
+    int parent(int node) const { return visited(node) ? parentOf[node] : -1; }
+
+    // 이번 탐색에서 방문한 노드 목록
+    const int* visitedBegin() const { return order.data(); }
+    const int* visitedEnd() const { return order.data() + tail; }
+    size_t visitedCount() const { return tail; }
+};
+
+// 국소 PageRank push 상태 (질의마다 건드린 노드만 초기화)
+class PushWorkspace {
+private:
+    vector<unsigned> stamp;   // stamp[v] == epoch 이면 이번 질의에서 값이 있는 노드
+    vector<unsigned> queued;  // queued[v] == epoch 이면 작업 큐에 들어 있음
+    vector<double> estimateOf;
+    vector<double> residualOf;
+    vector<int> touchedNodes;
+    unsigned epoch;
+
+public:
+    vector<int> queue;        // 잔여량이 임계값을 넘은 노드 (head 이후가 대기 중)
+    size_t head;
+
+    PushWorkspace() : epoch(0), head(0) {}
+
+    void reset(size_t nodeCount) {
+        if (stamp.size() < nodeCount) {
+            stamp.resize(nodeCount, 0);
+            queued.resize(nodeCount, 0);
+            estimateOf.resize(nodeCount);
+            residualOf.resize(nodeCount);
+        }
+        if (++epoch == 0) {
+            fill(stamp.begin(), stamp.end(), 0u);
+            fill(queued.begin(), queued.end(), 0u);
+            epoch = 1;
+        }
+        touchedNodes.clear();
+        queue.clear();
+        head = 0;
+    }
+
+    void touch(int node) {
+        if (stamp[node] == epoch) return;
+        stamp[node] = epoch;
+        estimateOf[node] = 0;
+        residualOf[node] = 0;
+        touchedNodes.push_back(node);
+    }
+
+    double& estimate(int node) { return estimateOf[node]; }
+    double& residual(int node) { return residualOf[node]; }
+
+    // 아직 큐에 없으면 추가
+    void enqueue(int node) {
+        if (queued[node] == epoch) return;
+        queued[node] = epoch;
+        queue.push_back(node);
+    }
+    int dequeue() {
+        int node = queue[head++];
+        queued[node] = 0;
+        return node;
+    }
+    bool empty() const { return head == queue.size(); }
+
+    const vector<int>& touched() const { return touchedNodes; }
+};
+
+// HDR 방식 지연 시간 히스토그램 (나노초)
+// 32 미만은 값 그대로, 그 이상은 2의 거듭제곱 구간마다 16칸으로 나눠 상대 오차 약 6% 이내로 기록
+class LatencyHistogram {
+private:
+    static const unsigned LINEAR = 32;
+    static const unsigned SUB_BUCKETS = 16;
+    vector<uint64_t> counts;
+    uint64_t total, sum, minValue, maxValue;
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < LINEAR) return (size_t)value;
+        unsigned bit = highestBit(value);
+        uint64_t sub = value >> (bit - 4); // 16 ~ 31
+        return LINEAR + (size_t)(bit - 5) * SUB_BUCKETS + (size_t)(sub - SUB_BUCKETS);
+    }
+
+public:
+    LatencyHistogram() : counts(LINEAR + 59 * SUB_BUCKETS, 0), total(0), sum(0), minValue(UINT64_MAX), maxValue(0) {}
+
+    // 칸의 가장 큰 값
+    static uint64_t upperBound(size_t bucket) {
+        if (bucket < LINEAR) return bucket;
+        unsigned bit = 5 + (unsigned)((bucket - LINEAR) / SUB_BUCKETS);
+        uint64_t sub = SUB_BUCKETS + (bucket - LINEAR) % SUB_BUCKETS;
+        return ((sub + 1) << (bit - 4)) - 1;
+    }
+
+    void record(uint64_t value) {
+        counts[bucketOf(value)]++;
+        total++;
+        sum += value;
+        minValue = min(minValue, value);
+        maxValue = max(maxValue, value);
+    }
+
+    // 누적 비율 q (0~1) 지점의 값 (칸의 상한, 최댓값을 넘지 않음)
+    uint64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)ceil(q * total);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < counts.size(); b++) {
+            seen += counts[b];
+            if (seen >= rank) return min(upperBound(b), maxValue);
+        }
+        return maxValue;
+    }
+
+    // 다른 히스토그램의 기록을 합침 (스레드별로 따로 모은 뒤 한 번에 집계)
+    void merge(const LatencyHistogram& other) {
+        for (size_t b = 0; b < counts.size(); b++) counts[b] += other.counts[b];
+        total += other.total;
+        sum += other.sum;
+        minValue = min(minValue, other.minValue);
+        maxValue = max(maxValue, other.maxValue);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t totalValue() const { return sum; }
+    uint64_t minimum() const { return total == 0 ? 0 : minValue; }
+    uint64_t maximum() const { return maxValue; }
+    size_t bucketCount() const { return counts.size(); }
+    uint64_t bucket(size_t b) const { return counts[b]; }
+};
+
+// 계측 대상 탐색 엔진
+enum TraversalEngine { ENGINE_DISTANCE, ENGINE_REACH, ENGINE_COVER, ENGINE_COMPONENTS, ENGINE_LONE_WOLF, ENGINE_ALT, ENGINE_COUNT };
+
+// 질의 하나의 계측 값. 계측이 꺼져 있으면 시각을 읽지 않고 단계별 집계도 하지 않음
+struct QueryProbe {
+    bool active;
+    chrono::steady_clock::time_point start;
+    uint64_t popped = 0;          // 큐/스택에서 꺼낸 노드 수
+    uint64_t edges = 0;           // 살펴본 간선 수
+    uint64_t allocationBytes = 0; // 질의 중 새로 잡은 메모리 (컨테이너 용량 기준 추정치)
+    vector<uint64_t> frontier;    // 단계별 프런티어 크기
+
+    void level(int depth) {
+        if (!active) return;
+        if (frontier.size() <= (size_t)depth) frontier.resize(depth + 1, 0);
+        frontier[depth]++;
+    }
+
+    // 단계 단위로 도는 탐색이 한 단계의 크기를 한 번에 기록
+    void frontierLevel(int depth, uint64_t size) {
+        if (!active) return;
+        if (frontier.size() <= (size_t)depth) frontier.resize(depth + 1, 0);
+        frontier[depth] += size;
+    }
+};
+
+// 엔진별 누적 계측 값과 JSON / Prometheus 출력
+class TraversalMetrics {
+private:
+    struct EngineStats {
+        uint64_t calls = 0, popped = 0, edges = 0, allocationBytes = 0;
+        vector<uint64_t> frontierTotal, frontierMax;
+        LatencyHistogram latency;
+    };
+    EngineStats stats[ENGINE_COUNT];
+
+    static const char* engineName(int engine) {
+        static const char* names[ENGINE_COUNT] = { "distance", "reach", "cover", "components", "lone_wolf", "alt" };
+        return names[engine];
+    }
+
+public:
+    bool enabled = false;
+
+    QueryProbe begin() const {
+        QueryProbe probe;
+        probe.active = enabled;
+        if (enabled) probe.start = chrono::steady_clock::now();
+        return probe;
+    }
+
+    void finish(TraversalEngine engine, const QueryProbe& probe) {
+        if (!probe.active) return;
+        EngineStats& e = stats[engine];
+        e.calls++;
+        e.popped += probe.popped;
+        e.edges += probe.edges;
+        e.allocationBytes += probe.allocationBytes;
+        if (e.frontierTotal.size() < probe.frontier.size()) {
+            e.frontierTotal.resize(probe.frontier.size(), 0);
+            e.frontierMax.resize(probe.frontier.size(), 0);
+        }
+        for (size_t d = 0; d < probe.frontier.size(); d++) {
+            e.frontierTotal[d] += probe.frontier[d];
+            e.frontierMax[d] = max(e.frontierMax[d], probe.frontier[d]);
+        }
+        e.latency.record((uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - probe.start).count());
+    }
+
+    // 다른 엔진을 여러 번 부르는 질의(커버)는 그동안 늘어난 하위 엔진 값을 자기 몫으로 기록
+    uint64_t popped(TraversalEngine engine) const { return stats[engine].popped; }
+    uint64_t edges(TraversalEngine engine) const { return stats[engine].edges; }
+    uint64_t allocationBytes(TraversalEngine engine) const { return stats[engine].allocationBytes; }
+
+    void clear() {
+        for (int i = 0; i < ENGINE_COUNT; i++) stats[i] = EngineStats();
+    }
+
+    void writeJson(ostream& out) const {
+        out << "{\"enabled\":" << (enabled ? "true" : "false") << ",\"engines\":[";
+        for (int i = 0; i < ENGINE_COUNT; i++) {
+            const EngineStats& e = stats[i];
+            const LatencyHistogram& h = e.latency;
+            if (i > 0) out << ",";
+            out << "{\"name\":\"" << engineName(i) << "\",\"calls\":" << e.calls
+                << ",\"vertices_popped\":" << e.popped << ",\"edges_scanned\":" << e.edges
+                << ",\"allocation_bytes\":" << e.allocationBytes
+                << ",\"latency_ns\":{\"count\":" << h.count() << ",\"min\":" << h.minimum()
+                << ",\"mean\":" << (h.count() ? h.totalValue() / h.count() : 0)
+                << ",\"p50\":" << h.percentile(0.5) << ",\"p90\":" << h.percentile(0.9)
+                << ",\"p99\":" << h.percentile(0.99) << ",\"p999\":" << h.percentile(0.999)
+                << ",\"max\":" << h.maximum() << "},\"frontier_by_level\":[";
+            for (size_t d = 0; d < e.frontierTotal.size(); d++) {
+                if (d > 0) out << ",";
+                out << "{\"level\":" << d << ",\"total\":" << e.frontierTotal[d] << ",\"max\":" << e.frontierMax[d] << "}";
+            }
+            out << "]}";
+        }
+        out << "]}" << endl;
+    }
+
+    void writePrometheus(ostream& out) const {
+        out << "# HELP kevin_bacon_query_latency_seconds Query latency by traversal engine." << endl;
+        out << "# TYPE kevin_bacon_query_latency_seconds histogram" << endl;
+        streamsize precision = out.precision(12);
+        for (int i = 0; i < ENGINE_COUNT; i++) {
+            const LatencyHistogram& h = stats[i].latency;
+            uint64_t cumulative = 0;
+            size_t next = 0; // 아직 누적하지 않은 첫 칸
+            // le는 수집할 때마다 같은 시계열이 나오도록 고정: 2^11-1 ns(약 2us)부터 2^37-1 ns(약 137초)까지
+            // 2의 거듭제곱 구간 끝마다 하나씩이며, 모두 히스토그램 칸의 상한과 일치해 누적 값이 정확함
+            for (unsigned bit = 10; bit <= 36; bit++) {
+                uint64_t bound = (2ULL << bit) - 1;
+                while (next < h.bucketCount() && LatencyHistogram::upperBound(next) <= bound) cumulative += h.bucket(next++);
+                out << "kevin_bacon_query_latency_seconds_bucket{engine=\"" << engineName(i) << "\",le=\""
+                    << bound * 1e-9 << "\"} " << cumulative << endl;
+            }
+            out << "kevin_bacon_query_latency_seconds_bucket{engine=\"" << engineName(i) << "\",le=\"+Inf\"} " << h.count() << endl;
+            out << "kevin_bacon_query_latency_seconds_sum{engine=\"" << engineName(i) << "\"} " << h.totalValue() * 1e-9 << endl;
+            out << "kevin_bacon_query_latency_seconds_count{engine=\"" << engineName(i) << "\"} " << h.count() << endl;
+        }
+        out.precision(precision);
+
+        const char* counters[3][2] = {
+            { "kevin_bacon_vertices_popped_total", "Vertices taken from the traversal queue or stack." },
+            { "kevin_bacon_edges_scanned_total", "Adjacency entries examined." },
+            { "kevin_bacon_allocation_bytes_total", "Estimated bytes allocated by traversal containers." },
+        };
+        for (int c = 0; c < 3; c++) {
+            out << "# HELP " << counters[c][0] << " " << counters[c][1] << endl;
+            out << "# TYPE " << counters[c][0] << " counter" << endl;
+            for (int i = 0; i < ENGINE_COUNT; i++) {
+                const EngineStats& e = stats[i];
+                uint64_t value = c == 0 ? e.popped : c == 1 ? e.edges : e.allocationBytes;
+                out << counters[c][0] << "{engine=\"" << engineName(i) << "\"} " << value << endl;
+            }
+        }
+
+        out << "# HELP kevin_bacon_frontier_vertices_total Vertices expanded at each BFS level." << endl;
+        out << "# TYPE kevin_bacon_frontier_vertices_total counter" << endl;
+        for (int i = 0; i < ENGINE_COUNT; i++) {
+            for (size_t d = 0; d < stats[i].frontierTotal.size(); d++) {
+                out << "kevin_bacon_frontier_vertices_total{engine=\"" << engineName(i) << "\",level=\"" << d << "\"} "
+                    << stats[i].frontierTotal[d] << endl;
+            }
+        }
+    }
+};
+
+// 자릿수 제한 없는 부호 없는 정수 (최단 경로 개수용, 2^32진법)
+class BigCount {
+private:
+    vector<uint32_t> limbs; // 낮은 자리부터
+
+public:
+    BigCount(uint32_t value = 0) {
+        if (value) limbs.push_back(value);
+    }
+
+    BigCount& operator+=(const BigCount& other) {
+        if (limbs.size() < other.limbs.size()) limbs.resize(other.limbs.size(), 0);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < limbs.size(); i++) {
+            uint64_t sum = (uint64_t)limbs[i] + (i < other.limbs.size() ? other.limbs[i] : 0) + carry;
+            limbs[i] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        if (carry) limbs.push_back((uint32_t)carry);
+        return *this;
+    }
+
+    string toString() const {
+        if (limbs.empty()) return "0";
+        vector<uint32_t> rest = limbs;
+        vector<uint32_t> chunks; // 10^9 단위, 낮은 자리부터
+        while (!rest.empty()) {
+            uint64_t remainder = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                uint64_t current = (remainder << 32) | rest[i];
+                rest[i] = (uint32_t)(current / 1000000000u);
+                remainder = current % 1000000000u;
+            }
+            chunks.push_back((uint32_t)remainder);
+            while (!rest.empty() && rest.back() == 0) rest.pop_back();
+        }
+        string text = to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            string part = to_string(chunks[i]);
+            text += string(9 - part.size(), '0') + part;
+        }
+        return text;
+    }
+};
+
+// 두 노드 사이의 최단 경로 DAG
+// 단계 i의 노드들은 출발점에서 거리 i이면서 도착점까지 최단으로 이어지는 노드들이고,
+// 간선은 단계 i에서 i + 1로만 향함. 모든 노드가 도착점에 닿으므로 경로 나열에 막다른 길이 없음
+class ShortestPathDag {
+public:
+    int distance = -1;      // 연결되지 않으면 -1
+    vector<int> nodes;      // DAG 노드 (단계순). nodes[0]은 출발점, 마지막은 도착점
+    vector<size_t> layerOffset;
+    vector<size_t> nextOffset; // 후속 노드 CSR (nodes의 인덱스)
+    vector<int> next;
+
+    bool connected() const { return distance >= 0; }
+
+    // 최단 경로 개수 (나열하지 않고 단계별 DP로 계산)
+    BigCount countPaths() const {
+        if (!connected()) return BigCount(0);
+        vector<BigCount> ways(nodes.size());
+        ways[0] = BigCount(1);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            for (size_t e = nextOffset[i]; e < nextOffset[i + 1]; e++) ways[next[e]] += ways[i];
+        }
+        return ways.back();
+    }
+
+    // 최단 경로를 하나씩 꺼내는 반복자 (경로 전체를 미리 만들지 않음)
+    class PathIterator {
+    private:
+        const ShortestPathDag* dag;
+        vector<int> stack;      // 현재 경로 (DAG 인덱스)
+        vector<size_t> cursor;  // 각 단계에서 다음에 볼 후속 간선
+        bool started = false;
+
+    public:
+        explicit PathIterator(const ShortestPathDag* owner) : dag(owner) {}
+
+        // 다음 경로를 path에 채움. 더 없으면 false
+        bool next(vector<int>& path) {
+            if (!dag->connected()) return false;
+            if (!started) {
+                started = true;
+                stack.push_back(0);
+                cursor.push_back(dag->nextOffset[0]);
+            }
+            else if (!stack.empty()) {
+                stack.pop_back(); // 직전에 내보낸 경로의 도착점에서 되돌아감
+                cursor.pop_back();
+            }
+            int target = (int)dag->nodes.size() - 1;
+            while (!stack.empty()) {
+                int current = stack.back();
+                if (current == target) {
+                    path.clear();
+                    for (int index : stack) path.push_back(dag->nodes[index]);
+                    return true;
+                }
+                size_t& edge = cursor.back();
+                if (edge < dag->nextOffset[current + 1]) {
+                    int following = dag->next[edge++];
+                    stack.push_back(following);
+                    cursor.push_back(dag->nextOffset[following]);
+                }
+                else {
+                    stack.pop_back();
+                    cursor.pop_back();
+                }
+            }
+            return false;
+        }
+    };
+
+    PathIterator paths() const { return PathIterator(this); }
+};
+
+// 개봉 연도가 붙은 공동 출연 그래프
+// 입력 파일은 한 줄에 영화 하나: "개봉연도 배우번호 배우번호 ..."
+// 각 노드의 이웃 목록을 처음 함께 출연한 연도 순으로 정렬해 CSR에 저장하므로
+// "Y년까지의 영화만 사용" 질의는 이웃 목록의 앞부분만 읽으면 되고 그래프를 다시 만들 필요가 없음
+class TemporalGraph {
+private:
+    struct TimedEdge {
+        int year;
+        int u, v;
+    };
+
+    vector<size_t> offset;         // CSR 오프셋
+    vector<int> neighbor;          // 노드별로 연도순 정렬된 이웃
+    vector<int> since;             // since[i]: neighbor[i]와 처음 함께 출연한 연도
+    vector<int> debutYear;         // 노드별 첫 출연 연도 (출연 기록이 없으면 INT_MAX)
+    vector<TimedEdge> edgesByYear; // 연도순 간선 목록 (그룹 성장 분석용)
+    int minYear, maxYear;
+    TraversalContext traversal;
+
+public:
+    // 연도별 최대 그룹 통계
+    struct YearStat {
+        int year;
+        int activeNodes; // 그 해까지 한 번이라도 출연한 노드 수
+        int components;  // 출연한 노드들의 그룹 수
+        int giantSize;   // 가장 큰 그룹의 크기
+    };
+
+    TemporalGraph() : minYear(INT_MAX), maxYear(INT_MIN) {}
+
+    bool empty() const { return minYear > maxYear; }
+    int firstYear() const { return minYear; }
+    int lastYear() const { return maxYear; }
+
+    bool load(const string& filename) {
+        MappedFile file;
+        if (!file.open(filename)) return false;
+
+        vector<TimedEdge> edges;
+        vector<int> cast;
+        int maxId = 0;
+        const char* p = file.begin();
+        const char* end = file.end();
+        while (p < end) {
+            const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+            if (!lineEnd) lineEnd = end;
+
+            cast.clear();
+            int year = -1;
+            while ((p = skipToDigit(p, lineEnd)) < lineEnd) {
+                size_t len = digitRunLength(p, lineEnd);
+                long long value = parseDigits(p, len, end);
+                p += len;
+                if (value > INT_MAX) continue;
+                if (year < 0) year = (int)value;
+                else cast.push_back((int)value);
+            }
+            p = lineEnd + 1;
+            if (cast.empty()) continue;
+
+            minYear = min(minYear, year);
+            maxYear = max(maxYear, year);
+            for (int actor : cast) {
+                maxId = max(maxId, actor);
+                if ((size_t)actor >= debutYear.size()) debutYear.resize((size_t)actor + 1, INT_MAX);
+                debutYear[actor] = min(debutYear[actor], year);
+            }
+            // 한 영화의 출연진은 서로 모두 연결
+            for (size_t i = 0; i < cast.size(); i++) {
+                for (size_t j = i + 1; j < cast.size(); j++) {
+                    if (cast[i] == cast[j]) continue;
+                    edges.push_back({ year, min(cast[i], cast[j]), max(cast[i], cast[j]) });
+                }
+            }
+        }
+
+        // 같은 두 배우의 간선은 가장 이른 연도 하나만 남김
+        sort(edges.begin(), edges.end(), [](const TimedEdge& a, const TimedEdge& b) {
+            if (a.u != b.u) return a.u < b.u;
+            if (a.v != b.v) return a.v < b.v;
+            return a.year < b.year;
+        });
+        edges.erase(unique(edges.begin(), edges.end(), [](const TimedEdge& a, const TimedEdge& b) {
+            return a.u == b.u && a.v == b.v;
+        }), edges.end());
+        stable_sort(edges.begin(), edges.end(), [](const TimedEdge& a, const TimedEdge& b) {
+            return a.year < b.year;
+        });
+
+        // 연도순 간선을 양방향으로 CSR에 배치하면 노드별 이웃도 연도순이 됨
+        size_t vertexCount = (size_t)maxId + 1;
+        debutYear.resize(vertexCount, INT_MAX);
+        vector<size_t> degree(vertexCount, 0);
+        for (const TimedEdge& e : edges) {
+            degree[e.u]++;
+            degree[e.v]++;
+        }
+        parallelPrefixSum(degree.data(), vertexCount, offset, 1);
+        neighbor.assign(offset[vertexCount], 0);
+        since.assign(offset[vertexCount], 0);
+        vector<size_t> cursor(offset.begin(), offset.end() - 1);
+        for (const TimedEdge& e : edges) {
+            neighbor[cursor[e.u]] = e.v;
+            since[cursor[e.u]++] = e.year;
+            neighbor[cursor[e.v]] = e.u;
+            since[cursor[e.v]++] = e.year;
+        }
+        edgesByYear.swap(edges);
+        return true;
+    }
+
+    bool hasNode(int node) const {
+        return node >= 0 && (size_t)node < debutYear.size() && debutYear[node] != INT_MAX;
+    }
+
+    // untilYear년까지 개봉한 영화만 사용한 최단 거리와 경로
+    pair<int, vector<int>> findDistanceWithPath(int start, int end, int untilYear) {
+        if (!hasNode(start) || !hasNode(end)) return { -1, {} };
+        if (debutYear[start] > untilYear || debutYear[end] > untilYear) return { -1, {} };
+        if (start == end) return { 0, {start} };
+
+        traversal.reset(debutYear.size());
+        traversal.visit(start, 0, -1);
+        while (!traversal.empty()) {
+            int current = traversal.pop();
+            int nextDistance = traversal.distance(current) + 1;
+            for (size_t i = offset[current]; i < offset[current + 1] && since[i] <= untilYear; i++) {
+                int next = neighbor[i];
+                if (traversal.visited(next)) continue;
+                traversal.visit(next, nextDistance, current);
+                if (next == end) {
+                    vector<int> path;
+                    for (int node = end; node != -1; node = traversal.parent(node)) path.push_back(node);
+                    reverse(path.begin(), path.end());
+                    return { nextDistance, path };
+                }
+            }
+        }
+        return { -1, {} };
+    }
+
+    // 연도별 최대 그룹 크기 변화 (연도순 간선을 Union-Find로 한 번 훑어 계산)
+    vector<YearStat> giantComponentGrowth() const {
+        vector<YearStat> stats;
+        size_t vertexCount = debutYear.size();
+        vector<int> parent(vertexCount), size(vertexCount, 1);
+        for (size_t i = 0; i < vertexCount; i++) parent[i] = (int)i;
+        auto find = [&](int x) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        };
+
+        // 데뷔 연도순 노드 목록
+        vector<pair<int, int>> debuts;
+        for (size_t i = 0; i < vertexCount; i++) {
+            if (debutYear[i] != INT_MAX) debuts.push_back({ debutYear[i], (int)i });
+        }
+        sort(debuts.begin(), debuts.end());
+
+        int active = 0, components = 0, giant = 0;
+        size_t nextDebut = 0, nextEdge = 0;
+        while (nextDebut < debuts.size() || nextEdge < edgesByYear.size()) {
+            int year = INT_MAX;
+            if (nextDebut < debuts.size()) year = debuts[nextDebut].first;
+            if (nextEdge < edgesByYear.size()) year = min(year, edgesByYear[nextEdge].year);
+
+            for (; nextDebut < debuts.size() && debuts[nextDebut].first == year; nextDebut++) {
+                active++;
+                components++;
+                giant = max(giant, 1);
+            }
+            for (; nextEdge < edgesByYear.size() && edgesByYear[nextEdge].year == year; nextEdge++) {
+                int a = find(edgesByYear[nextEdge].u);
+                int b = find(edgesByYear[nextEdge].v);
+                if (a == b) continue;
+                if (size[a] < size[b]) swap(a, b);
+                parent[b] = a;
+                size[a] += size[b];
+                components--;
+                giant = max(giant, size[a]);
+            }
+            stats.push_back({ year, active, components, giant });
+        }
+        return stats;
+    }
+};
+
+// 노드를 P개 파티션으로 나눠 작업자마다 하나씩 맡기는 분산 BFS
+// 노드 v는 v % P번 작업자가 소유하고, 작업자는 자기 노드의 이웃 목록만 가짐.
+// 단계마다 작업자들이 프런티어 메시지를 공유 메모리의 작업자 쌍별 링 버퍼로 주고받음.
+// POSIX에서는 작업자가 별도 프로세스(fork)이고 shm_open 영역으로 통신하며, Windows에서는 스레드로 대신함.
+// 같은 단계의 후보 중 (부모의 큐 순서, 이웃 목록 위치)가 가장 앞선 것을 고르므로
+// 단일 프로세스 findDistanceWithPath와 거리뿐 아니라 경로도 똑같이 나옴
+class ShardedGraph {
+private:
+    struct ShardMessage {
+        int vertex;
+        int parent;
+        uint64_t key; // 부모의 단계 내 순서 * 최대 차수 + 이웃 목록 위치 (작을수록 단일 BFS 큐에서 먼저)
+    };
+
+    struct alignas(64) RingHeader {
+        atomic<uint64_t> head; // 소비자가 읽은 개수
+        char padding[56];
+        atomic<uint64_t> tail; // 생산자가 쓴 개수
+    };
+
+    // 공유 메모리 맨 앞의 제어 블록 (뒤따르는 링 헤더와 캐시 라인을 나눠 쓰지 않도록 64바이트 정렬)
+    struct alignas(64) Control {
+        atomic<int> queryId;   // 코디네이터가 새 질의마다 증가
+        atomic<int> doneId;    // 작업자 0이 질의를 끝내면 queryId를 기록
+        atomic<int> shutdown;
+        atomic<int> barrierWaiting;
+        atomic<int> barrierGeneration;
+        atomic<long long> sendDone;     // 단계별 전송 완료 누적 수
+        atomic<long long> levelTotal[2]; // 단계별 새 프런티어 크기 (홀짝 번갈아 사용)
+        atomic<int> found[2];
+        int source, target;
+        int traceVertex;
+        int resultDistance;
+        int pathLength;
+    };
+
+    // 작업자 하나가 가진 파티션 (지역 번호 i = v / P)
+    struct Partition {
+        vector<size_t> offset;
+        vector<int> adjacency;
+    };
+
+    // 링 버퍼는 작업자 쌍(P*P)마다 하나이므로 전체 크기가 RING_BUDGET을 넘지 않게 쌍당 용량을 줄임
+    static const size_t RING_BUDGET = 64 << 20;
+    static const size_t MAX_RING_CAPACITY = 1 << 13;
+    static const size_t MIN_RING_CAPACITY = 1 << 8;
+
+    int partitions = 0;
+    size_t vertexCount = 0;
+    uint64_t keyStride = 1;
+    size_t ringCapacity = MAX_RING_CAPACITY;
+    const vector<size_t>* sourceOffset = nullptr; // 작업자가 자기 파티션을 잘라 갈 원본 CSR
+    const vector<int>* sourceAdjacency = nullptr;
+    vector<size_t> slotOffset; // 작업자별 공개 키 영역 위치 (바이트)
+    size_t pathOffset = 0;
+    size_t regionSize = 0;
+    char* region = nullptr;
+    Control* control = nullptr;
+    int lastQuery = 0;
+#ifdef _WIN32
+    vector<thread> workerThreads;
+    char* allocation = nullptr; // region은 이 안에서 64바이트 경계로 맞춘 위치
+#else
+    vector<pid_t> workerPids;
+#endif
+
+    RingHeader* ring(int from, int to) const {
+        return (RingHeader*)(region + sizeof(Control) + sizeof(RingHeader) * ((size_t)from * partitions + to));
+    }
+    ShardMessage* ringSlots(int from, int to) const {
+        size_t base = sizeof(Control) + sizeof(RingHeader) * (size_t)partitions * partitions;
+        return (ShardMessage*)(region + base) + ringCapacity * ((size_t)from * partitions + to);
+    }
+    uint64_t* slotCount(int worker) const { return (uint64_t*)(region + slotOffset[worker]); }
+    uint64_t* slotKeys(int worker) const { return slotCount(worker) + 1; }
+    int* pathBuffer() const { return (int*)(region + pathOffset); }
+
+    size_t ownedCount(int worker) const {
+        return vertexCount > (size_t)worker ? (vertexCount - worker + partitions - 1) / partitions : 0;
+    }
+
+    // 작업자가 시작한 뒤 자기 노드의 이웃 목록만 원본에서 복사 (코디네이터는 파티션 사본을 갖지 않음)
+    Partition buildPartition(int worker) const {
+        const vector<size_t>& offset = *sourceOffset;
+        const vector<int>& adjacency = *sourceAdjacency;
+        Partition part;
+        part.offset.reserve(ownedCount(worker) + 1);
+        part.offset.push_back(0);
+        for (size_t v = worker; v < vertexCount; v += partitions) {
+            part.adjacency.insert(part.adjacency.end(), adjacency.begin() + offset[v], adjacency.begin() + offset[v + 1]);
+            part.offset.push_back(part.adjacency.size());
+        }
+        return part;
+    }
+
+    // 공유 제어 블록의 word가 seen에서 바뀔 때까지 기다림 (새 질의, 장벽 세대, 질의 완료에 공통으로 씀)
+    // 곧 바뀌는 경우를 위해 잠깐 양보하며 확인한 뒤, Linux에서는 futex로 잠들고 그 밖에서는 쉬는 간격을 점점 늘림
+    // (작업자와 코디네이터가 코어보다 많을 때 기다리는 쪽이 CPU를 빼앗지 않도록)
+    static void waitForChange(atomic<int>& word, int seen) {
+        for (int spins = 0; spins < 64; spins++) {
+            if (word.load(memory_order_acquire) != seen) return;
+            this_thread::yield();
+        }
+#ifdef __linux__
+        static_assert(sizeof(atomic<int>) == sizeof(int), "futex는 int 크기의 atomic이 필요함");
+        while (word.load(memory_order_acquire) == seen) {
+            syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT, seen, nullptr, nullptr, 0);
+        }
+#else
+        chrono::microseconds pause(50);
+        while (word.load(memory_order_acquire) == seen) {
+            this_thread::sleep_for(pause);
+            if (pause < chrono::microseconds(2000)) pause *= 2;
+        }
+#endif
+    }
+
+    // word를 바꾼 뒤 그 값에서 잠든 프로세스(스레드)를 모두 깨움
+    static void wakeAll(atomic<int>& word) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+
+    // 작업자 전체가 참여하는 장벽 (마지막 작업자가 세대를 올리고 나머지를 깨움)
+    void barrier() {
+        int generation = control->barrierGeneration.load(memory_order_acquire);
+        if (control->barrierWaiting.fetch_add(1, memory_order_acq_rel) + 1 == partitions) {
+            control->barrierWaiting.store(0, memory_order_relaxed);
+            control->barrierGeneration.fetch_add(1, memory_order_acq_rel);
+            wakeAll(control->barrierGeneration);
+        }
+        else {
+            waitForChange(control->barrierGeneration, generation);
+        }
+    }
+
+    // 작업자 한 명의 질의 처리 상태
+    struct WorkerState {
+        int id;
+        Partition part;
+        vector<unsigned> stamp; // 방문 표시 (epoch)
+        vector<unsigned> candidateStamp;
+        unsigned epoch = 0;
+        vector<int> parent;
+        vector<uint64_t> bestKey;
+        vector<int> bestParent;
+        vector<pair<int, uint64_t>> frontier; // (노드, 단계 내 순서)
+        vector<int> fresh;                    // 이번 단계에 새로 찾은 노드
+        vector<ShardMessage> inbox;
+    };
+
+    // 들어온 메시지를 모두 꺼내 inbox에 보관
+    void drain(WorkerState& state) {
+        for (int from = 0; from < partitions; from++) {
+            RingHeader* header = ring(from, state.id);
+            ShardMessage* slots = ringSlots(from, state.id);
+            uint64_t head = header->head.load(memory_order_relaxed);
+            uint64_t tail = header->tail.load(memory_order_acquire);
+            for (; head < tail; head++) state.inbox.push_back(slots[head % ringCapacity]);
+            header->head.store(head, memory_order_release);
+        }
+    }
+
+    void send(WorkerState& state, int to, const ShardMessage& message) {
+        RingHeader* header = ring(state.id, to);
+        uint64_t tail = header->tail.load(memory_order_relaxed);
+        // 가득 차면 내 받은편지함을 비우며 대기 (서로 가득 찬 상태로 멈추는 것을 막음)
+        while (tail - header->head.load(memory_order_acquire) >= ringCapacity) {
+            drain(state);
+            this_thread::yield();
+        }
+        ringSlots(state.id, to)[tail % ringCapacity] = message;
+        header->tail.store(tail + 1, memory_order_release);
+    }
+
+    void runQuery(WorkerState& state, long long& sendPhases) {
+        const Partition& part = state.part;
+        int source = control->source, target = control->target;
+        if (++state.epoch == 0) {
+            fill(state.stamp.begin(), state.stamp.end(), 0u);
+            fill(state.candidateStamp.begin(), state.candidateStamp.end(), 0u);
+            state.epoch = 1;
+        }
+        state.frontier.clear();
+        if (source % partitions == state.id) {
+            state.stamp[source / partitions] = state.epoch;
+            state.parent[source / partitions] = -1;
+            state.frontier.push_back({ source, 0 });
+        }
+
+        int distance = -1;
+        for (int level = 0;; level++) {
+            // 1) 내 프런티어의 이웃을 소유 작업자에게 전송
+            for (const pair<int, uint64_t>& entry : state.frontier) {
+                size_t local = (size_t)entry.first / partitions;
+                for (size_t e = part.offset[local]; e < part.offset[local + 1]; e++) {
+                    int neighbor = part.adjacency[e];
+                    send(state, neighbor % partitions,
+                        { neighbor, entry.first, entry.second * keyStride + (e - part.offset[local]) });
+                }
+            }
+            control->sendDone.fetch_add(1, memory_order_acq_rel);
+            sendPhases++;
+            while (control->sendDone.load(memory_order_acquire) < sendPhases * partitions) {
+                drain(state);
+                this_thread::yield();
+            }
+            drain(state);
+
+            // 2) 아직 방문하지 않은 노드마다 가장 앞선 후보를 부모로 선택
+            state.fresh.clear();
+            for (const ShardMessage& message : state.inbox) {
+                size_t local = (size_t)message.vertex / partitions;
+                if (state.stamp[local] == state.epoch) continue;
+                if (state.candidateStamp[local] != state.epoch) {
+                    state.candidateStamp[local] = state.epoch;
+                    state.bestKey[local] = message.key;
+                    state.bestParent[local] = message.parent;
+                    state.fresh.push_back(message.vertex);
+                }
+                else if (message.key < state.bestKey[local]) {
+                    state.bestKey[local] = message.key;
+                    state.bestParent[local] = message.parent;
+                }
+            }
+            state.inbox.clear();
+            sort(state.fresh.begin(), state.fresh.end(), [&](int a, int b) {
+                return state.bestKey[a / partitions] < state.bestKey[b / partitions];
+            });
+            uint64_t* keys = slotKeys(state.id);
+            for (size_t i = 0; i < state.fresh.size(); i++) keys[i] = state.bestKey[state.fresh[i] / partitions];
+            *slotCount(state.id) = state.fresh.size();
+            int next = (level + 1) % 2;
+            if (state.id == 0) {
+                control->levelTotal[next].store(0, memory_order_relaxed);
+                control->found[next].store(0, memory_order_relaxed);
+            }
+            barrier();
+
+            // 3) 모든 작업자의 정렬된 키로 새 노드의 단계 내 순서 계산
+            state.frontier.clear();
+            for (int vertex : state.fresh) {
+                size_t local = (size_t)vertex / partitions;
+                uint64_t key = state.bestKey[local];
+                uint64_t rank = 0;
+                for (int w = 0; w < partitions; w++) {
+                    const uint64_t* other = slotKeys(w);
+                    rank += (uint64_t)(lower_bound(other, other + *slotCount(w), key) - other);
+                }
+                state.stamp[local] = state.epoch;
+                state.parent[local] = state.bestParent[local];
+                state.frontier.push_back({ vertex, rank });
+                if (vertex == target) control->found[level % 2].store(1, memory_order_relaxed);
+            }
+            control->levelTotal[level % 2].fetch_add((long long)state.fresh.size(), memory_order_relaxed);
+            barrier();
+
+            if (control->found[level % 2].load(memory_order_relaxed)) {
+                distance = level + 1;
+                break;
+            }
+            if (control->levelTotal[level % 2].load(memory_order_relaxed) == 0) break;
+        }
+
+        // 4) 도착점에서 부모를 따라 경로 복원 (노드 소유자가 차례로 부모를 알려줌)
+        int length = 0;
+        if (distance >= 0) {
+            int vertex = target;
+            while (true) {
+                if (state.id == 0) pathBuffer()[length] = vertex;
+                length++;
+                if (vertex == source) break;
+                if (vertex % partitions == state.id) control->traceVertex = state.parent[vertex / partitions];
+                barrier();
+                vertex = control->traceVertex;
+                barrier();
+            }
+        }
+        if (state.id == 0) {
+            control->resultDistance = distance;
+            control->pathLength = length;
+            control->doneId.store(control->queryId.load(memory_order_acquire), memory_order_release);
+            wakeAll(control->doneId);
+        }
+    }
+
+    void workerLoop(int id) {
+        WorkerState state;
+        state.id = id;
+        state.part = buildPartition(id);
+        size_t owned = ownedCount(id);
+        state.stamp.assign(owned, 0);
+        state.candidateStamp.assign(owned, 0);
+        state.parent.assign(owned, -1);
+        state.bestKey.assign(owned, 0);
+        state.bestParent.assign(owned, -1);
+
+        int seen = 0;
+        long long sendPhases = 0;
+        while (true) {
+            waitForChange(control->queryId, seen);
+            int query = control->queryId.load(memory_order_acquire);
+            if (control->shutdown.load(memory_order_acquire)) return;
+            seen = query;
+            runQuery(state, sendPhases);
+        }
+    }
+
+public:
+    ~ShardedGraph() { stop(); }
+
+    int partitionCount() const { return partitions; }
+
+    // CSR 그래프를 P개로 나눠 맡을 작업자 시작 (offset, adjacency는 작업자가 살아 있는 동안 유지되어야 함)
+    bool start(int partitionCount, const vector<size_t>& offset, const vector<int>& adjacency) {
+        stop();
+        partitions = partitionCount;
+        sourceOffset = &offset;
+        sourceAdjacency = &adjacency;
+        vertexCount = offset.empty() ? 0 : offset.size() - 1;
+        size_t maxDegree = 1;
+        for (size_t v = 0; v < vertexCount; v++) maxDegree = max(maxDegree, offset[v + 1] - offset[v]);
+        keyStride = maxDegree;
+
+        size_t pairs = (size_t)partitions * partitions;
+        ringCapacity = MAX_RING_CAPACITY;
+        while (ringCapacity > MIN_RING_CAPACITY && ringCapacity * sizeof(ShardMessage) * pairs > RING_BUDGET) ringCapacity /= 2;
+
+        // 공유 영역 배치: 제어 블록 | 링 헤더 P*P | 링 슬롯 P*P | 작업자별 공개 키 | 경로
+        regionSize = sizeof(Control) + (sizeof(RingHeader) + sizeof(ShardMessage) * ringCapacity) * pairs;
+        slotOffset.assign(partitions, 0);
+        for (int p = 0; p < partitions; p++) {
+            slotOffset[p] = regionSize;
+            regionSize += sizeof(uint64_t) * (ownedCount(p) + 1);
+        }
+        pathOffset = regionSize;
+        regionSize += sizeof(int) * (vertexCount + 1);
+
+#ifdef _WIN32
+        allocation = new char[regionSize + 64];
+        region = allocation + (64 - (uintptr_t)allocation % 64) % 64;
+#else
+        string shmName = "/kevin_bacon_" + to_string(getpid());
+        int fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR | O_EXCL, 0600);
+        if (fd < 0) return false;
+        // 작업자는 fork로 매핑을 물려받으므로 이름은 바로 지움 (비정상 종료해도 /dev/shm에 남지 않음)
+        shm_unlink(shmName.c_str());
+        if (ftruncate(fd, (off_t)regionSize) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+        region = (char*)mapped;
+#endif
+        control = new (region) Control();
+        control->queryId.store(0);
+        control->doneId.store(0);
+        control->shutdown.store(0);
+        control->barrierWaiting.store(0);
+        control->barrierGeneration.store(0);
+        control->sendDone.store(0);
+        for (int i = 0; i < 2; i++) {
+            control->levelTotal[i].store(0);
+            control->found[i].store(0);
+        }
+        for (int from = 0; from < partitions; from++) {
+            for (int to = 0; to < partitions; to++) {
+                RingHeader* header = new (ring(from, to)) RingHeader();
+                header->head.store(0);
+                header->tail.store(0);
+            }
+        }
+        lastQuery = 0;
+
+#ifdef _WIN32
+        for (int p = 0; p < partitions; p++) workerThreads.emplace_back([this, p]() { workerLoop(p); });
+#else
+        cout.flush();
+        for (int p = 0; p < partitions; p++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                // 자식: 자기 파티션의 질의 처리만 담당
+                workerLoop(p);
+                _exit(0);
+            }
+            if (pid < 0) {
+                stop();
+                return false;
+            }
+            workerPids.push_back(pid);
+        }
+#endif
+        return true;
+    }
+
+    // 작업자 종료 및 공유 메모리 해제
+    void stop() {
+        if (!control) return;
+        control->shutdown.store(1, memory_order_release);
+        control->queryId.fetch_add(1, memory_order_acq_rel);
+        wakeAll(control->queryId);
+#ifdef _WIN32
+        for (thread& worker : workerThreads) worker.join();
+        workerThreads.clear();
+        delete[] allocation;
+        allocation = nullptr;
+#else
+        for (pid_t pid : workerPids) waitpid(pid, nullptr, 0);
+        workerPids.clear();
+        munmap(region, regionSize);
+#endif
+        region = nullptr;
+        control = nullptr;
+        partitions = 0;
+    }
+
+    // 분산 BFS로 최단 거리와 경로 계산 (연결되지 않으면 -1)
+    pair<int, vector<int>> findDistanceWithPath(int start, int end) {
+        if (start == end) return { 0, {start} };
+        control->source = start;
+        control->target = end;
+        control->levelTotal[0].store(0, memory_order_relaxed); // 첫 단계 집계 (이후 단계는 작업자 0이 초기화)
+        control->found[0].store(0, memory_order_relaxed);
+        lastQuery++;
+        control->queryId.store(lastQuery, memory_order_release);
+        wakeAll(control->queryId);
+        int done;
+        while ((done = control->doneId.load(memory_order_acquire)) != lastQuery) waitForChange(control->doneId, done);
+
+        if (control->resultDistance < 0) return { -1, {} };
+        vector<int> path(pathBuffer(), pathBuffer() + control->pathLength);
+        reverse(path.begin(), path.end());
+        return { control->resultDistance, path };
+    }
+};
+
+// BFS 커널: 노드 번호 폭 Id(16/32/64비트)와 기록할 항목을 템플릿 인자로 받음.
+// 그래프를 불러올 때 노드 수에 맞는 가장 좁은 폭을 골라 그 폭의 인스턴스로 실행함 (KevinBaconGame::withKernel)
+
+// 노드 번호 폭이 Id인 CSR 보기 (16비트는 좁힌 복사본, 32비트는 원본 int 배열을 그대로 사용)
+template <typename Id>
+struct KernelGraph {
+    typedef Id IdType;
+    const size_t* offset = nullptr;
+    const Id* target = nullptr;
+    size_t nodes = 0;
+    vector<Id> storage; // 원본과 폭이 다를 때만 사용
+
+    void attach(const vector<size_t>& csrOffset, const vector<int>& csrAdjacency) {
+        offset = csrOffset.data();
+        nodes = csrOffset.empty() ? 0 : csrOffset.size() - 1;
+        if (sizeof(Id) == sizeof(int)) {
+            vector<Id>().swap(storage);
+            target = (const Id*)csrAdjacency.data(); // int와 같은 폭의 부호 없는 형으로 읽음
+        }
+        else {
+            storage.assign(csrAdjacency.begin(), csrAdjacency.end());
+            target = storage.data();
+        }
+    }
+};
+
+// BFS 커널 상태. 커널이 기록하지 않는 배열은 할당하지 않음
+template <typename Id>
+struct KernelState {
+    vector<unsigned> stamp; // stamp[v] == epoch 이면 방문
+    vector<Id> queue;
+    vector<Id> parent;
+    vector<Id> dist;
+    unsigned epoch = 0;
+    size_t head = 0, tail = 0;
+
+    // 새 탐색 시작. 같은 epoch 안에서 여러 번 run하면 방문 표시를 공유 (연결 요소 세기)
+    size_t newSearch(size_t nodes, bool withParent, bool withDistance) {
+        size_t grown = 0;
+        if (stamp.size() < nodes) {
+            grown += (nodes - stamp.size()) * (sizeof(unsigned) + sizeof(Id));
+            stamp.resize(nodes, 0);
+            queue.resize(nodes);
+        }
+        if (withParent && parent.size() < nodes) {
+            grown += (nodes - parent.size()) * sizeof(Id);
+            parent.resize(nodes);
+        }
+        if (withDistance && dist.size() < nodes) {
+            grown += (nodes - dist.size()) * sizeof(Id);
+            dist.resize(nodes);
+        }
+        if (++epoch == 0) {
+            fill(stamp.begin(), stamp.end(), 0u);
+            epoch = 1;
+        }
+        head = tail = 0;
+        return grown;
+    }
+
+    bool visited(size_t v) const { return stamp[v] == epoch; }
+    size_t visitedCount() const { return tail; }
+};
+
+// 번호 폭별 커널 상태 묶음. 동시에 질의하는 스레드는 각자 하나씩 가짐
+struct KernelWorkspace {
+    KernelState<uint16_t> narrow;
+    KernelState<uint32_t> regular;
+    KernelState<uint64_t> wide;
+};
+
+// 컴파일 시점에 기록 항목을 정한 BFS
+// TrackParent: 부모 기록 (경로 복원용), TrackDistance: 노드별 거리 기록, DepthLimited: maxDepth 단계까지만 확장
+// 단계 수는 큐의 단계 경계로 세므로 거리만 필요한 질의는 노드별 거리 배열 없이 동작하고,
+// 꺼진 항목의 분기는 상수 조건이라 인스턴스마다 컴파일러가 제거함
+template <typename Id, bool TrackParent, bool TrackDistance, bool DepthLimited>
+struct BfsKernel {
+    // source에서 탐색해 target(없으면 전체)을 처음 발견한 단계 반환 (발견하지 못하면 -1)
+    // 방문한 노드는 state.queue[0, tail)에 BFS 순서로 남음. 같은 epoch로 이어서 부르면 큐 뒤에 덧붙임
+    static int run(const KernelGraph<Id>& graph, KernelState<Id>& state, Id source, Id target, bool hasTarget,
+        int maxDepth, QueryProbe& probe) {
+        const size_t* offset = graph.offset;
+        const Id* adjacency = graph.target;
+        unsigned epoch = state.epoch;
+        unsigned* stamp = state.stamp.data();
+        Id* queue = state.queue.data();
+
+        size_t head = state.tail, tail = state.tail;
+        stamp[source] = epoch;
+        queue[tail++] = source;
+        if (TrackParent) state.parent[source] = source;
+        if (TrackDistance) state.dist[source] = 0;
+
+        int found = -1;
+        uint64_t popped = 0, edges = 0;
+        for (int depth = 0; head < tail && found < 0; depth++) {
+            size_t levelEnd = tail;
+            if (probe.active) probe.frontierLevel(depth, levelEnd - head);
+            if (DepthLimited && depth >= maxDepth) {
+                popped += levelEnd - head;
+                head = levelEnd;
+                break;
+            }
+            for (; head < levelEnd; head++) {
+                Id v = queue[head];
+                popped++;
+                size_t first = offset[v], last = offset[(size_t)v + 1];
+                edges += last - first;
+                for (size_t e = first; e < last; e++) {
+                    Id w = adjacency[e];
+                    if (stamp[w] == epoch) continue;
+                    stamp[w] = epoch;
+                    queue[tail++] = w;
+                    if (TrackParent) state.parent[w] = v;
+                    if (TrackDistance) state.dist[w] = (Id)(depth + 1);
+                    if (hasTarget && w == target) {
+                        found = depth + 1;
+                        break;
+                    }
+                }
+                if (found >= 0) {
+                    head++;
+                    break;
+                }
+            }
+        }
+        state.head = head;
+        state.tail = tail;
+        probe.popped += popped;
+        probe.edges += edges;
+        return found;
+    }
+};
+
+// 랜드마크 기반 A* (ALT) 거리 색인
+// 몇십 개의 랜드마크 L에서 모든 노드까지의 BFS 거리 표를 미리 구해 두면
+// 삼각 부등식 |d(L, t) - d(L, v)| <= d(v, t)로 도착점까지 거리의 하한을 얻음.
+// 이 하한을 휴리스틱으로 쓰는 A*는 도착점 방향으로만 탐색을 넓히므로 BFS보다 훨씬 적은 노드를 확정함.
+// 표는 그래프 지문과 함께 파일로 저장해 다음 실행에서 다시 계산하지 않음
+class LandmarkIndex {
+public:
+    enum Strategy { FARTHEST, DEGREE };
+
+private:
+    enum : uint16_t {
+        UNREACHED = 0xFFFF, // 랜드마크와 다른 그룹
+        FAR = 0xFFFE        // 도달 가능하지만 표에 담을 수 없을 만큼 먼 거리 (하한 없음)
+    };
+
+    const vector<size_t>* offset = nullptr;
+    const vector<int>* adjacency = nullptr;
+    size_t n = 0;
+    vector<int> landmarks;
+    vector<uint16_t> table; // table[v * 랜드마크 수 + l] = 랜드마크 l에서 v까지 거리 (한 노드의 값이 한 캐시 줄에 모임)
+
+    // 질의 상태 (epoch 방식으로 건드린 노드만 초기화)
+    struct NodeState {
+        unsigned seen;   // seen == epoch 이면 이번 질의에서 발견한 노드
+        unsigned closed; // closed == epoch 이면 거리 확정
+        int cost;        // 출발점에서의 거리 (g)
+        int parent;
+        int bound;       // 도착점까지 거리 하한 (h)
+    };
+    vector<NodeState> state; // 노드별 상태를 한곳에 모아 질의 중 캐시 미스를 줄임
+    vector<uint16_t> targetRow; // 질의 중 도착점의 랜드마크 거리
+    vector<vector<int>> buckets; // f = g + h 값별 노드 (같은 f 안에서는 나중에 넣은 깊은 노드 우선)
+    unsigned epoch = 0;
+
+    // 한 랜드마크에서 모든 노드까지의 BFS 거리
+    void fillRow(int landmark, vector<uint16_t>& row, vector<int>& queue) const {
+        row.assign(n, (uint16_t)UNREACHED);
+        queue.clear();
+        queue.push_back(landmark);
+        row[landmark] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int v = queue[head];
+            uint16_t next = row[v] >= FAR - 1 ? (uint16_t)FAR : (uint16_t)(row[v] + 1);
+            for (size_t e = (*offset)[v]; e < (*offset)[v + 1]; e++) {
+                int w = (*adjacency)[e];
+                if (row[w] == UNREACHED) {
+                    row[w] = next;
+                    queue.push_back(w);
+                }
+            }
+        }
+    }
+
+    // 도착점까지 거리 하한 (v에서 도착점에 닿을 수 없으면 INT_MAX). 도착점 거리는 targetRow에 있음
+    int lowerBound(int v) const {
+        int bound = 0;
+        size_t count = landmarks.size();
+        const uint16_t* row = &table[v * count];
+        for (size_t l = 0; l < count; l++) {
+            uint16_t dv = row[l], dt = targetRow[l];
+            if (dv == UNREACHED || dt == UNREACHED) {
+                if (dv != dt) return INT_MAX; // 한쪽만 랜드마크와 같은 그룹이면 서로 다른 그룹
+                continue;
+            }
+            if (dv == FAR || dt == FAR) continue;
+            bound = max(bound, dv > dt ? dv - dt : dt - dv);
+        }
+        return bound;
+    }
+
+public:
+    bool ready() const { return !landmarks.empty(); }
+    const vector<int>& landmarkNodes() const { return landmarks; }
+
+    // 그래프 구조의 지문 (FNV-1a). 저장된 표가 같은 그래프의 것인지 확인할 때 사용
+    static uint64_t fingerprint(const vector<size_t>& offset, const vector<int>& adjacency) {
+        uint64_t hash = 1469598103934665603ULL;
+        auto mix = [&hash](uint64_t value) {
+            for (int b = 0; b < 8; b++) {
+                hash ^= (value >> (b * 8)) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+        };
+        mix(offset.size());
+        for (size_t v = 1; v < offset.size(); v++) mix(offset[v]);
+        for (int w : adjacency) mix((uint32_t)w);
+        return hash;
+    }
+
+    // 랜드마크 선택과 거리 표 계산
+    // FARTHEST: 차수가 가장 큰 노드에서 시작해, 이미 고른 랜드마크들과의 최소 거리가 가장 먼 노드를 차례로 추가
+    //           (고를 때마다 BFS가 필요해 순차 처리. 그 BFS 결과가 곧 표의 한 줄)
+    // DEGREE:   차수 상위 노드 중 서로 이웃이 아닌 노드를 골라 모든 표를 스레드별로 나눠 병렬 계산
+    // 후보는 첫 랜드마크와 같은 그룹의 노드로 한정 (작은 그룹에 랜드마크를 낭비하지 않음)
+    void build(const vector<size_t>& graphOffset, const vector<int>& graphAdjacency, const vector<int>& byDegree,
+        size_t count, Strategy strategy, unsigned threads = workerCount()) {
+        offset = &graphOffset;
+        adjacency = &graphAdjacency;
+        n = graphOffset.empty() ? 0 : graphOffset.size() - 1;
+        landmarks.clear();
+        table.clear();
+        if (byDegree.empty() || n == 0 || (*offset)[byDegree[0] + 1] == (*offset)[byDegree[0]]) return;
+
+        vector<int> queue;
+        vector<vector<uint16_t>> rows(1); // 랜드마크별 거리 (마지막에 노드 순서로 옮겨 담음)
+        landmarks.push_back(byDegree[0]);
+        fillRow(landmarks[0], rows[0], queue);
+        vector<int> component(queue); // 첫 랜드마크의 그룹
+
+        if (strategy == FARTHEST) {
+            vector<uint16_t> nearest(rows[0]);
+            while (landmarks.size() < count && landmarks.size() < component.size()) {
+                int best = -1;
+                for (int v : component) {
+                    if (best < 0 || nearest[v] > nearest[best] || (nearest[v] == nearest[best] && v < best)) best = v;
+                }
+                if (nearest[best] == 0) break;
+                landmarks.push_back(best);
+                rows.emplace_back();
+                fillRow(best, rows.back(), queue);
+                for (int v : component) nearest[v] = min(nearest[v], rows.back()[v]);
+            }
+        }
+        else {
+            vector<char> blocked(n, 0); // 이미 고른 랜드마크와 그 이웃
+            for (size_t e = (*offset)[landmarks[0]]; e < (*offset)[landmarks[0] + 1]; e++) blocked[(*adjacency)[e]] = 1;
+            blocked[landmarks[0]] = 1;
+            for (size_t i = 1; i < byDegree.size() && landmarks.size() < count; i++) {
+                int v = byDegree[i];
+                if (blocked[v] || rows[0][v] == UNREACHED) continue;
+                landmarks.push_back(v);
+                blocked[v] = 1;
+                for (size_t e = (*offset)[v]; e < (*offset)[v + 1]; e++) blocked[(*adjacency)[e]] = 1;
+            }
+            rows.resize(landmarks.size());
+            if (threads == 0) threads = 1;
+            runParallel(landmarks.size() - 1, threads, [&](size_t begin, size_t end, unsigned) {
+                vector<int> localQueue;
+                for (size_t l = begin + 1; l < end + 1; l++) fillRow(landmarks[l], rows[l], localQueue);
+            });
+        }
+
+        size_t stride = landmarks.size();
+        table.resize(n * stride);
+        runParallel(n, threads == 0 ? 1 : threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t v = begin; v < end; v++) {
+                for (size_t l = 0; l < stride; l++) table[v * stride + l] = rows[l][v];
+            }
+        });
+    }
+
+    // 이진 파일로 저장: 표식, 그래프 지문, 노드 수, 랜드마크 목록, 거리 표
+    bool save(const string& path, uint64_t graphFingerprint) const {
+        ofstream out(path, ios::binary);
+        if (!out) return false;
+        uint64_t header[3] = { 0x314B52414D444E4CULL, graphFingerprint, (uint64_t)n }; // "LNDMARK1"
+        uint64_t count = landmarks.size();
+        out.write((const char*)header, sizeof(header));
+        out.write((const char*)&count, sizeof(count));
+        out.write((const char*)landmarks.data(), sizeof(int) * landmarks.size());
+        out.write((const char*)table.data(), sizeof(uint16_t) * table.size());
+        return (bool)out;
+    }
+
+    // 같은 그래프(지문 일치)의 저장본이 있으면 불러옴
+    bool load(const string& path, const vector<size_t>& graphOffset, const vector<int>& graphAdjacency, uint64_t graphFingerprint) {
+        ifstream in(path, ios::binary);
+        if (!in) return false;
+        uint64_t header[3], count = 0;
+        size_t nodes = graphOffset.empty() ? 0 : graphOffset.size() - 1;
+        if (!in.read((char*)header, sizeof(header)) || !in.read((char*)&count, sizeof(count))) return false;
+        if (header[0] != 0x314B52414D444E4CULL || header[1] != graphFingerprint || header[2] != nodes || count == 0 || count > 1024) {
+            return false;
+        }
+        vector<int> storedLandmarks(count);
+        vector<uint16_t> storedTable(count * nodes);
+        if (!in.read((char*)storedLandmarks.data(), sizeof(int) * count)) return false;
+        if (!in.read((char*)storedTable.data(), sizeof(uint16_t) * storedTable.size())) return false;
+
+        offset = &graphOffset;
+        adjacency = &graphAdjacency;
+        n = nodes;
+        landmarks.swap(storedLandmarks);
+        table.swap(storedTable);
+        return true;
+    }
+
+    // A*로 최단 거리와 경로 계산 (연결되지 않으면 -1). probe에 확정한 노드 수와 살펴본 간선 수 기록
+    pair<int, vector<int>> findPath(int start, int end, QueryProbe& probe) {
+        if (start == end) return { 0, {start} };
+        targetRow.assign(table.begin() + (size_t)end * landmarks.size(), table.begin() + (size_t)(end + 1) * landmarks.size());
+        int startBound = lowerBound(start);
+        if (startBound == INT_MAX) return { -1, {} };
+
+        if (state.size() < n) {
+            probe.allocationBytes += (n - state.size()) * sizeof(NodeState);
+            state.resize(n, NodeState{ 0, 0, 0, -1, 0 });
+        }
+        if (++epoch == 0) {
+            for (NodeState& node : state) node.seen = node.closed = 0;
+            epoch = 1;
+        }
+
+        size_t current = startBound;
+        if (buckets.size() <= current) buckets.resize(current + 1);
+        state[start] = NodeState{ epoch, 0, 0, -1, startBound };
+        buckets[current].push_back(start);
+
+        int found = -1;
+        while (current < buckets.size()) {
+            if (buckets[current].empty()) {
+                current++;
+                continue;
+            }
+            int v = buckets[current].back();
+            buckets[current].pop_back();
+            if (state[v].closed == epoch) continue; // 더 짧은 거리로 이미 확정된 항목
+            state[v].closed = epoch;
+            probe.popped++;
+            probe.level(state[v].cost);
+            if (v == end) {
+                found = state[v].cost;
+                break;
+            }
+
+            int nextCost = state[v].cost + 1;
+            probe.edges += (*offset)[v + 1] - (*offset)[v];
+            for (size_t e = (*offset)[v]; e < (*offset)[v + 1]; e++) {
+                int w = (*adjacency)[e];
+                NodeState& next = state[w];
+                if (next.closed == epoch) continue;
+                if (next.seen == epoch) {
+                    if (next.cost <= nextCost) continue;
+                }
+                else {
+                    next.seen = epoch;
+                    next.bound = lowerBound(w); // 노드마다 한 번만 계산
+                    next.cost = INT_MAX;
+                }
+                int bound = next.bound;
+                if (bound == INT_MAX) continue;
+                next.cost = nextCost;
+                next.parent = v;
+                size_t f = (size_t)nextCost + bound;
+                if (buckets.size() <= f) buckets.resize(f + 1);
+                buckets[f].push_back(w);
+            }
+        }
+        for (size_t f = current; f < buckets.size(); f++) buckets[f].clear(); // 남은 후보 정리
+        if (found < 0) return { -1, {} };
+
+        vector<int> path;
+        for (int v = end; v != -1; v = state[v].parent) path.push_back(v);
+        reverse(path.begin(), path.end());
+        return { found, path };
+    }
+};
+
+// 질의 기록 파일: 한 줄에 "기록 시작 후 경과 마이크로초 종류 인자..." ('#'으로 시작하는 줄은 주석)
+// 종류: distance A B, reach A K, components, lonewolf, cover K [목표%] [epsilon], year A B Y, ppr X N, alt A B,
+//       connectors3 (kebin의 "3단계 이내에 자기 그룹 전체에 연락 가능한 사람")
+struct TraceEntry {
+    int64_t atMicros;
+    string type;
+    vector<double> args;
+};
+
+class QueryTrace {
+private:
+    ofstream out;
+    chrono::steady_clock::time_point start;
+
+public:
+    bool open(const string& path) {
+        out.open(path);
+        if (!out) return false;
+        out << "# kevin-bacon query trace v1: micros type args..." << endl;
+        out.precision(numeric_limits<double>::max_digits10);
+        start = chrono::steady_clock::now();
+        return true;
+    }
+
+    bool recording() const { return out.is_open(); }
+
+    // 질의 하나를 기록 (재생 중 중단되어도 남도록 줄마다 flush)
+    // 노드 번호 같은 정수는 정수 그대로, 나머지는 double을 되읽어 같은 값이 나오는 자릿수로 씀
+    // (기본 6자리로 쓰면 1234567이 1.23457e+06이 되어 재생할 때 다른 노드가 됨)
+    void record(const char* type, initializer_list<double> args) {
+        if (!out.is_open()) return;
+        out << chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count() << " " << type;
+        for (double arg : args) {
+            if (arg == floor(arg) && fabs(arg) < 9007199254740992.0) out << " " << (long long)arg;
+            else out << " " << arg;
+        }
+        out << endl;
+    }
+
+    static bool load(const string& path, vector<TraceEntry>& entries) {
+        ifstream in(path);
+        if (!in) return false;
+        string line;
+        while (getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            istringstream iss(line);
+            TraceEntry entry;
+            if (!(iss >> entry.atMicros >> entry.type)) continue;
+            double arg;
+            while (iss >> arg) entry.args.push_back(arg);
+            entries.push_back(entry);
+        }
+        return true;
+    }
+};
+
 class KevinBaconGame {
 private:
-    vector<vector<int>> graph;
+    // CSR 인접 배열: 노드 u의 이웃은 adjacency[adjOffset[u]] ~ adjacency[adjOffset[u + 1] - 1]
+    vector<size_t> adjOffset;
+    vector<int> adjacency;
     int totalNodes;
     int minNode, maxNode;
+    TraversalContext traversal; // 질의마다 재사용하는 BFS 상태
+    TraversalContext backward;  // 양방향 탐색의 도착점 쪽 상태
+    TemporalGraph timeline;     // 개봉 연도별 공동 출연 기록 (films.txt)
+    PushWorkspace push;         // Personalized PageRank 질의마다 재사용하는 상태
+    TraversalMetrics metrics;   // 탐색 엔진 계측 (기본은 꺼짐)
+    LandmarkIndex landmarkIndex; // ALT 거리 질의용 랜드마크 표 (처음 사용할 때 불러오거나 계산)
+    string graphFile;            // 랜드마크 표를 같은 위치에 저장하기 위한 그래프 파일 경로
+    QueryTrace trace;            // run()에서 받은 질의 기록 (--record로 켬)
+
+    // 노드 수에 맞는 가장 좁은 번호 폭의 BFS 커널 (불러올 때 결정, 선택되지 않은 폭은 비어 있음)
+    int kernelIdBits = 32;
+    KernelGraph<uint16_t> kernelGraph16;
+    KernelGraph<uint32_t> kernelGraph32;
+    KernelGraph<uint64_t> kernelGraph64;
+    KernelWorkspace kernelWorkspace; // 대화형 질의가 재사용하는 커널 상태
+
+    void prepareKernels() {
+        size_t n = nodeCount();
+        kernelIdBits = n <= 0x10000 ? 16 : ((uint64_t)n - 1 <= UINT32_MAX ? 32 : 64);
+        kernelGraph16 = KernelGraph<uint16_t>();
+        kernelGraph32 = KernelGraph<uint32_t>();
+        kernelGraph64 = KernelGraph<uint64_t>();
+        if (kernelIdBits == 16) kernelGraph16.attach(adjOffset, adjacency);
+        else if (kernelIdBits == 32) kernelGraph32.attach(adjOffset, adjacency);
+        else kernelGraph64.attach(adjOffset, adjacency);
+    }
+
+    // 선택된 폭의 커널 그래프와 workspace의 상태로 body(graph, state) 실행
+    template <typename Body>
+    auto withKernel(Body body, KernelWorkspace& workspace) -> decltype(body(kernelGraph32, workspace.regular)) {
+        if (kernelIdBits == 16) return body(kernelGraph16, workspace.narrow);
+        if (kernelIdBits == 64) return body(kernelGraph64, workspace.wide);
+        return body(kernelGraph32, workspace.regular);
+    }
+
+    template <typename Body>
+    auto withKernel(Body body) -> decltype(body(kernelGraph32, kernelWorkspace.regular)) {
+        return withKernel(body, kernelWorkspace);
+    }
+    ShardedGraph sharded;       // 파티션별 작업자 프로세스 (처음 사용할 때 시작)
+
+    // CSR의 한 노드 이웃 구간 (range-for 용)
+    struct NeighborRange {
+        const int* first;
+        const int* last;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        size_t size() const { return (size_t)(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    NeighborRange neighbors(int node) const {
+        const int* base = adjacency.data();
+        return { base + adjOffset[node], base + adjOffset[node + 1] };
+    }
+
+    // 그래프를 만들 때 함께 계산하는 차수 색인 (차수 자체는 CSR 오프셋 차이로 O(1))
+    vector<int> isolatedNodes;      // 이웃이 없는 유효한 노드 (번호 오름차순)
+    vector<int> degreeHistogram;    // degreeHistogram[d] = 차수가 d인 유효한 노드 수
+    vector<int> nodesByDegree;      // 유효한 노드를 차수 내림차순(같으면 번호 오름차순)으로 정렬
+
+    // 차수별 계수 정렬로 색인 생성
+    void buildDegreeIndex() {
+        isolatedNodes.clear();
+        degreeHistogram.assign(1, 0);
+        for (int i = minNode; i <= maxNode; i++) {
+            if (!isValidNode(i)) continue;
+            size_t degree = neighbors(i).size();
+            if (degree >= degreeHistogram.size()) degreeHistogram.resize(degree + 1, 0);
+            degreeHistogram[degree]++;
+            if (degree == 0) isolatedNodes.push_back(i);
+        }
+
+        // 차수가 큰 구간부터 채우도록 시작 위치 계산
+        vector<size_t> position(degreeHistogram.size() + 1, 0);
+        for (size_t d = degreeHistogram.size(); d-- > 0;) position[d] = position[d + 1] + degreeHistogram[d];
+        nodesByDegree.assign(position[0], 0);
+        for (size_t d = 0; d < degreeHistogram.size(); d++) position[d] = position[d + 1];
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i)) nodesByDegree[position[neighbors(i).size()]++] = i;
+        }
+    }
+
+    // 노드 번호 공간 크기 (0번 포함)
+    size_t nodeCount() const {
+        return adjOffset.empty() ? 0 : adjOffset.size() - 1;
+    }
+
+    // 스레드별 간선 버퍼를 CSR로 병합 (차수 계산 → prefix-sum → 배치 → 정렬/중복 제거)
+    void buildAdjacency(vector<EdgeChunk>& chunks, size_t vertexCount, unsigned threads) {
+        unique_ptr<atomic<int>[]> degree(new atomic<int>[vertexCount]);
+        runParallel(vertexCount, threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++) degree[i].store(0, memory_order_relaxed);
+        });
+
+        // 양방향 간선의 차수 계산
+        runParallel(chunks.size(), (unsigned)chunks.size(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t c = begin; c < end; c++) {
+                for (const pair<int, int>& e : chunks[c].edges) {
+                    degree[e.first].fetch_add(1, memory_order_relaxed);
+                    degree[e.second].fetch_add(1, memory_order_relaxed);
+                }
+            }
+        });
+
+        vector<int> counts(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) counts[i] = degree[i].load(memory_order_relaxed);
+        vector<size_t> offset;
+        parallelPrefixSum(counts.data(), vertexCount, offset, threads);
+
+        // 각 노드의 쓰기 위치를 원자적으로 할당받아 배치
+        vector<int> scattered(offset[vertexCount]);
+        runParallel(vertexCount, threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++) degree[i].store(0, memory_order_relaxed);
+        });
+        runParallel(chunks.size(), (unsigned)chunks.size(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t c = begin; c < end; c++) {
+                for (const pair<int, int>& e : chunks[c].edges) {
+                    scattered[offset[e.first] + degree[e.first].fetch_add(1, memory_order_relaxed)] = e.second;
+                    scattered[offset[e.second] + degree[e.second].fetch_add(1, memory_order_relaxed)] = e.first;
+                }
+                vector<pair<int, int>>().swap(chunks[c].edges); // 버퍼 메모리 즉시 반환
+            }
+        });
+
+        // 노드별 정렬 및 중복 제거 (파일은 보통 간선을 양쪽 줄에 모두 기록함)
+        runParallel(vertexCount, threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++) {
+                int* first = scattered.data() + offset[i];
+                int* last = scattered.data() + offset[i + 1];
+                sort(first, last);
+                counts[i] = (int)(unique(first, last) - first);
+            }
+        });
+
+        parallelPrefixSum(counts.data(), vertexCount, adjOffset, threads);
+        adjacency.assign(adjOffset[vertexCount], 0);
+        runParallel(vertexCount, threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++) {
+                copy(scattered.begin() + offset[i], scattered.begin() + offset[i] + counts[i],
+                    adjacency.begin() + adjOffset[i]);
+            }
+        });
+    }
 
 public:
     KevinBaconGame() : totalNodes(0), minNode(INT_MAX), maxNode(0) {}
 
-    // Ͽ ׷ ε
+    // 파일에서 그래프 로드
+    // 파일을 메모리 매핑한 뒤 줄 경계로 나눈 구간을 스레드별로 파싱하고 CSR로 병합
     bool loadGraph(const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cout << "   ϴ: " << filename << endl;
+        graphFile = filename;
+        MappedFile file;
+        if (!file.open(filename)) {
+            cout << "파일을 열 수 없습니다: " << filename << endl;
             return false;
         }
 
-        string line;
-        getline(file, line);
-        totalNodes = stoi(line);
+        // 첫 줄: 전체 노드 수
+        const char* data = file.begin();
+        const char* end = file.end();
+        const char* headerEnd = data ? (const char*)memchr(data, '\n', file.size()) : nullptr;
+        if (!headerEnd) headerEnd = end;
+        const char* p = skipToDigit(data, headerEnd);
+        long long headerCount = p < headerEnd ? parseDigits(p, digitRunLength(p, headerEnd), end) : -1;
+        if (headerCount < 0 || headerCount > INT_MAX) {
+            cout << "노드 수를 읽을 수 없습니다: " << filename << endl;
+            return false;
+        }
+        totalNodes = (int)headerCount;
+        const char* body = headerEnd < end ? headerEnd + 1 : end;
+
+        // 본문을 줄 경계에 맞춰 구간 분할 (구간이 너무 작아지지 않도록 제한)
+        const size_t minChunkBytes = 1 << 20;
+        size_t bodySize = (size_t)(end - body);
+        unsigned threads = (unsigned)min<size_t>(workerCount(), bodySize / minChunkBytes + 1);
+        vector<const char*> bounds(threads + 1);
+        bounds[0] = body;
+        bounds[threads] = end;
+        for (unsigned t = 1; t < threads; t++) {
+            const char* cut = max(bounds[t - 1], body + bodySize * t / threads);
+            const char* newline = (const char*)memchr(cut, '\n', (size_t)(end - cut));
+            bounds[t] = newline ? newline + 1 : end;
+        }
 
-        graph.resize(totalNodes + 1); // 1 
+        vector<EdgeChunk> chunks(threads);
+        runParallel(threads, threads, [&](size_t begin, size_t last, unsigned) {
+            for (size_t t = begin; t < last; t++) {
+                parseEdgeChunk(bounds[t], bounds[t + 1], end, chunks[t]);
+            }
+        });
+
+        for (const EdgeChunk& chunk : chunks) {
+            minNode = min(minNode, chunk.minNode);
+            maxNode = max(maxNode, chunk.maxNode);
+        }
+        size_t vertexCount = (size_t)max(totalNodes, maxNode) + 1; // 1번부터 사용
+        buildAdjacency(chunks, vertexCount, workerCount());
+        buildDegreeIndex();
+        prepareKernels();
+        return true;
+    }
 
-        while (getline(file, line)) {
-            if (line.empty()) continue;
+    // 영화별 개봉 연도와 출연진 목록 로드 (선택 사항)
+    bool loadFilmography(const string& filename) {
+        return timeline.load(filename);
+    }
 
-            istringstream iss(line);
-            int node;
-            iss >> node;
+    // 노드 유효성 검사
+    bool isValidNode(int node) {
+        return node >= minNode && node <= maxNode && node < (int)nodeCount();
+    }
+
+    // BFS로 두 노드 간 최단 거리 계산 (경로도 함께 반환)
+    pair<int, vector<int>> findDistanceWithPath(int start, int end) {
+        if (start == end) return { 0, {start} };
 
-            minNode = min(minNode, node);
-            maxNode = max(maxNode, node);
+        QueryProbe probe = metrics.begin();
+        pair<int, vector<int>> result = distanceWithPath(start, end, kernelWorkspace, probe);
+        metrics.finish(ENGINE_DISTANCE, probe);
+        return result;
+    }
 
-            int neighbor;
-            while (iss >> neighbor) {
-                //  ׷ 
-                graph[node].push_back(neighbor);
-                graph[neighbor].push_back(node);
-                minNode = min(minNode, neighbor);
-                maxNode = max(maxNode, neighbor);
+    // 주어진 커널 상태로 최단 거리와 경로 계산 (계측 기록은 호출한 쪽에서)
+    pair<int, vector<int>> distanceWithPath(int start, int end, KernelWorkspace& workspace, QueryProbe& probe) {
+        if (start == end) return { 0, {start} };
+        return withKernel([&](auto& graph, auto& state) {
+            typedef typename decay<decltype(graph)>::type::IdType Id;
+            probe.allocationBytes += state.newSearch(graph.nodes, true, false);
+            int distance = BfsKernel<Id, true, false, false>::run(graph, state, (Id)start, (Id)end, true, 0, probe);
+            vector<int> path;
+            if (distance >= 0) {
+                // 경로 복원
+                for (Id node = (Id)end; node != (Id)start; node = state.parent[node]) path.push_back((int)node);
+                path.push_back(start);
+                reverse(path.begin(), path.end());
+                probe.allocationBytes += path.capacity() * sizeof(int);
             }
+            return make_pair(distance, path); // 연결되지 않으면 (-1, 빈 경로)
+        }, workspace);
+    }
+
+    // 마지막 커널 BFS가 방문한 노드 수
+    size_t lastSearchVisited() {
+        return withKernel([](auto&, auto& state) { return state.visitedCount(); });
+    }
+
+    // 그래프를 P개 파티션으로 나눈 작업자들로 최단 거리 계산 (파티션 수가 바뀌면 작업자 재시작)
+    pair<int, vector<int>> findShardedDistanceWithPath(int start, int end, int partitionCount) {
+        if (sharded.partitionCount() != partitionCount && !sharded.start(partitionCount, adjOffset, adjacency)) {
+            return { -2, {} }; // 작업자 시작 실패
         }
+        return sharded.findDistanceWithPath(start, end);
+    }
 
-        file.close();
-        return true;
+    // 랜드마크 표 준비: 그래프 파일 옆의 저장본(그래프 지문이 같을 때)을 쓰고, 없으면 계산해서 저장
+    void prepareLandmarks(size_t count = 16, LandmarkIndex::Strategy strategy = LandmarkIndex::FARTHEST, bool rebuild = false) {
+        if (landmarkIndex.ready() && !rebuild) return;
+        string path = graphFile + ".landmarks";
+        uint64_t fingerprint = LandmarkIndex::fingerprint(adjOffset, adjacency);
+        if (!rebuild && landmarkIndex.load(path, adjOffset, adjacency, fingerprint)) return;
+
+        landmarkIndex.build(adjOffset, adjacency, nodesByDegree, count, strategy);
+        if (landmarkIndex.ready() && !landmarkIndex.save(path, fingerprint)) {
+            cout << "랜드마크 표를 저장할 수 없습니다: " << path << endl;
+        }
+    }
+
+    // ALT(랜드마크 하한을 쓰는 A*)로 최단 거리와 경로 계산. settled에 확정한 노드 수 기록
+    pair<int, vector<int>> findDistanceWithPathALT(int start, int end, uint64_t* settled = nullptr) {
+        prepareLandmarks();
+        QueryProbe probe = metrics.begin();
+        pair<int, vector<int>> result = landmarkIndex.ready() ? landmarkIndex.findPath(start, end, probe)
+            : findDistanceWithPath(start, end); // 간선이 없는 그래프
+        metrics.finish(ENGINE_ALT, probe);
+        if (settled) *settled = probe.popped;
+        return result;
+    }
+
+    // 임의의 두 노드 거리를 BFS와 ALT로 구해 시간과 확정 노드 수 비교
+    void benchmarkALT(size_t queries, unsigned seed = 12345) {
+        if (queries == 0) {
+            cout << "질의 수는 1 이상이어야 합니다." << endl;
+            return;
+        }
+        auto t0 = chrono::steady_clock::now();
+        prepareLandmarks();
+        double prepareMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        vector<int> members;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i) && !neighbors(i).empty()) members.push_back(i);
+        }
+        if (members.empty()) return;
+
+        mt19937 rng(seed);
+        double bfsMs = 0, altMs = 0;
+        uint64_t bfsVisited = 0, altSettled = 0;
+        size_t mismatches = 0;
+        for (size_t q = 0; q < queries; q++) {
+            int a = members[rng() % members.size()], b = members[rng() % members.size()];
+            auto t1 = chrono::steady_clock::now();
+            int bfsDistance = findDistanceWithPath(a, b).first;
+            auto t2 = chrono::steady_clock::now();
+            bfsVisited += a == b ? 1 : lastSearchVisited();
+            uint64_t settled = 0;
+            int altDistance = findDistanceWithPathALT(a, b, &settled).first;
+            auto t3 = chrono::steady_clock::now();
+            altSettled += settled;
+            bfsMs += chrono::duration<double, milli>(t2 - t1).count();
+            altMs += chrono::duration<double, milli>(t3 - t2).count();
+            if (bfsDistance != altDistance) mismatches++;
+        }
+        cout << "ALT 벤치마크 (질의 " << queries << "개, 랜드마크 " << landmarkIndex.landmarkNodes().size()
+            << "개, 준비 " << prepareMs << " ms)" << endl;
+        cout << "  BFS: 평균 " << bfsMs / queries << " ms, 방문 노드 평균 " << bfsVisited / queries << "개" << endl;
+        cout << "  ALT: 평균 " << altMs / queries << " ms, 확정 노드 평균 " << altSettled / queries << "개" << endl;
+        cout << "  거리 불일치: " << mismatches << "건" << endl;
+    }
+
+    // 두 노드 사이의 모든 최단 경로를 담은 DAG 생성
+    // 양쪽에서 작은 프런티어를 한 단계씩 넓히는 양방향 BFS로 만나는 지점을 찾고,
+    // 만난 노드들에서 각 탐색의 거리 정보를 따라 출발점/도착점 쪽으로 DAG를 복원
+    ShortestPathDag buildShortestPathDag(int start, int end) {
+        ShortestPathDag dag;
+        if (start == end) {
+            dag.distance = 0;
+            dag.nodes = { start };
+            dag.layerOffset = { 0, 1 };
+            dag.nextOffset = { 0, 0 };
+            return dag;
+        }
+
+        traversal.reset(nodeCount());
+        backward.reset(nodeCount());
+        traversal.visit(start, 0, -1);
+        backward.visit(end, 0, -1);
+        int forwardRadius = 0, backwardRadius = 0;
+        vector<int> meeting;
+
+        while (meeting.empty() && !traversal.empty() && !backward.empty()) {
+            bool expandForward = traversal.pending() <= backward.pending();
+            TraversalContext& side = expandForward ? traversal : backward;
+            TraversalContext& other = expandForward ? backward : traversal;
+            int& radius = expandForward ? forwardRadius : backwardRadius;
+
+            size_t levelSize = side.pending();
+            for (size_t i = 0; i < levelSize; i++) {
+                int current = side.pop();
+                for (int neighbor : neighbors(current)) {
+                    if (side.visited(neighbor)) continue;
+                    side.visit(neighbor, radius + 1, current);
+                    if (other.visited(neighbor)) meeting.push_back(neighbor);
+                }
+            }
+            radius++;
+        }
+        if (meeting.empty()) return dag;
+        dag.distance = forwardRadius + backwardRadius;
+
+        // 단계별 노드 수집: 만난 단계에서 출발점 쪽, 도착점 쪽으로 넓혀 감
+        vector<vector<int>> layers(dag.distance + 1);
+        layers[forwardRadius] = meeting;
+        unordered_map<int, int> layerOf;
+        for (int node : meeting) layerOf[node] = forwardRadius;
+        for (int layer = forwardRadius; layer > 0; layer--) {
+            for (int node : layers[layer]) {
+                for (int neighbor : neighbors(node)) {
+                    if (traversal.distance(neighbor) == layer - 1 && !layerOf.count(neighbor)) {
+                        layerOf[neighbor] = layer - 1;
+                        layers[layer - 1].push_back(neighbor);
+                    }
+                }
+            }
+        }
+        for (int layer = forwardRadius; layer < dag.distance; layer++) {
+            for (int node : layers[layer]) {
+                for (int neighbor : neighbors(node)) {
+                    if (backward.distance(neighbor) == dag.distance - layer - 1 && !layerOf.count(neighbor)) {
+                        layerOf[neighbor] = layer + 1;
+                        layers[layer + 1].push_back(neighbor);
+                    }
+                }
+            }
+        }
+
+        // 노드 번호 부여 후 인접 단계 간선을 CSR로 저장
+        unordered_map<int, int> indexOf;
+        dag.layerOffset.push_back(0);
+        for (const vector<int>& layer : layers) {
+            for (int node : layer) {
+                indexOf[node] = (int)dag.nodes.size();
+                dag.nodes.push_back(node);
+            }
+            dag.layerOffset.push_back(dag.nodes.size());
+        }
+        dag.nextOffset.push_back(0);
+        for (size_t i = 0; i < dag.nodes.size(); i++) {
+            int layer = layerOf[dag.nodes[i]];
+            if (layer < dag.distance) {
+                for (int neighbor : neighbors(dag.nodes[i])) {
+                    auto found = layerOf.find(neighbor);
+                    if (found != layerOf.end() && found->second == layer + 1) dag.next.push_back(indexOf[neighbor]);
+                }
+            }
+            dag.nextOffset.push_back(dag.next.size());
+        }
+        return dag;
+    }
+
+    // 기존 함수와의 호환성을 위한 래퍼
+    int findDistance(int start, int end) {
+        if (start == end) return 0;
+        QueryProbe probe = metrics.begin();
+        int distance = withKernel([&](auto& graph, auto& state) {
+            typedef typename decay<decltype(graph)>::type::IdType Id;
+            probe.allocationBytes += state.newSearch(graph.nodes, false, false);
+            return BfsKernel<Id, false, false, false>::run(graph, state, (Id)start, (Id)end, true, 0, probe);
+        });
+        metrics.finish(ENGINE_DISTANCE, probe);
+        return distance;
+    }
+
+    // BFS로 K단계 내 도달 가능한 모든 노드 찾기
+    set<int> getReachableNodes(int start, int k) {
+        QueryProbe probe = metrics.begin();
+        set<int> reachable = withKernel([&](auto& graph, auto& state) {
+            typedef typename decay<decltype(graph)>::type::IdType Id;
+            probe.allocationBytes += state.newSearch(graph.nodes, false, false);
+            BfsKernel<Id, false, false, true>::run(graph, state, (Id)start, 0, false, k, probe);
+            return set<int>(state.queue.begin(), state.queue.begin() + state.visitedCount());
+        });
+        probe.allocationBytes += reachable.size() * SET_NODE_BYTES;
+        metrics.finish(ENGINE_REACH, probe);
+        return reachable;
+    }
+
+    // 새로 커버할 수 있는 노드 수 계산
+    int countNewReachable(int node, int k, const set<int>& covered) {
+        set<int> reachable = getReachableNodes(node, k);
+        int count = 0;
+
+        for (int n : reachable) {
+            if (covered.find(n) == covered.end()) {
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    // 그리디 커버 결과 (출력 없이 계산만)
+    struct CoverResult {
+        vector<int> selected;
+        vector<pair<int, int>> process; // (선택된 노드, 새로 커버한 노드 수)
+        size_t coveredCount = 0;
+        size_t totalCount = 0;
+        size_t evaluations = 0;         // 새 커버 수를 계산한 후보 수
+    };
+
+    // 그리디 커버 계산
+    // coverageTarget: 전체 노드 중 이 비율 이상 커버되면 중단 (1.0이면 전체)
+    // epsilon > 0이면 확률적 그리디: 매 라운드 남은 후보 중 (n / r) * ln(1 / epsilon)개만 무작위로 평가
+    //   r은 선택할 노드 수 추정치로, 지금까지 선택 수 + 남은 노드 수 / 직전 라운드 커버 수
+    //   (첫 라운드는 r = 1이라 전체를 평가, 커버 수가 줄어들수록 r이 커져 표본이 작아짐)
+    // epsilon = 0이면 매 라운드 모든 후보를 평가하는 정확한 그리디
+    CoverResult coverGreedy(int k, double coverageTarget, double epsilon, unsigned seed) {
+        QueryProbe probe = metrics.begin();
+        uint64_t poppedBefore = metrics.popped(ENGINE_REACH), edgesBefore = metrics.edges(ENGINE_REACH);
+        uint64_t bytesBefore = metrics.allocationBytes(ENGINE_REACH);
+        CoverResult cover;
+        set<int> covered;
+
+        // 모든 유효한 노드 찾기
+        vector<int> candidates;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i) && !neighbors(i).empty()) {
+                candidates.push_back(i);
+            }
+        }
+        size_t n = candidates.size();
+        cover.totalCount = n;
+        size_t targetCount = (size_t)ceil(min(coverageTarget, 1.0) * n - 1e-9);
+
+        mt19937 rng(seed);
+        size_t lastGain = 0;
+        while (covered.size() < targetCount) {
+            size_t evaluate = candidates.size();
+            if (epsilon > 0 && lastGain > 0) {
+                double r = cover.selected.size() + (double)(n - covered.size()) / lastGain;
+                double sample = ceil(n / r * log(1 / epsilon));
+                if (sample < evaluate) evaluate = max((size_t)1, (size_t)sample);
+            }
+
+            // 앞쪽 evaluate개를 무작위 표본으로 섞음 (부분 Fisher-Yates)
+            if (evaluate < candidates.size()) {
+                for (size_t i = 0; i < evaluate; i++) {
+                    uniform_int_distribution<size_t> pick(i, candidates.size() - 1);
+                    swap(candidates[i], candidates[pick(rng)]);
+                }
+            }
+
+            int bestNode = -1;
+            int maxNewCover = 0;
+            size_t bestIndex = 0;
+            for (size_t i = 0; i < evaluate; i++) {
+                int newCoverCount = countNewReachable(candidates[i], k, covered);
+                cover.evaluations++;
+                if (newCoverCount > maxNewCover) {
+                    maxNewCover = newCoverCount;
+                    bestNode = candidates[i];
+                    bestIndex = i;
+                }
+            }
+
+            // 표본에서 새로 커버할 노드가 없으면 전체 후보에서 다시 찾음
+            if (maxNewCover == 0 && evaluate < candidates.size()) {
+                for (size_t i = evaluate; i < candidates.size(); i++) {
+                    int newCoverCount = countNewReachable(candidates[i], k, covered);
+                    cover.evaluations++;
+                    if (newCoverCount > maxNewCover) {
+                        maxNewCover = newCoverCount;
+                        bestNode = candidates[i];
+                        bestIndex = i;
+                    }
+                }
+            }
+
+            if (bestNode == -1 || maxNewCover == 0) break;
+
+            cover.selected.push_back(bestNode);
+            cover.process.push_back({ bestNode, maxNewCover });
+            lastGain = maxNewCover;
+
+            // 선택된 노드는 후보에서 제외 (정확한 그리디는 노드 번호 순서를 유지)
+            if (epsilon > 0) {
+                candidates[bestIndex] = candidates.back();
+                candidates.pop_back();
+            }
+            else {
+                candidates.erase(candidates.begin() + bestIndex);
+            }
+
+            // bestNode에서 k단계 내 도달 가능한 모든 노드를 covered에 추가
+            set<int> reachable = getReachableNodes(bestNode, k);
+            for (int node : reachable) {
+                covered.insert(node);
+            }
+        }
+
+        cover.coveredCount = covered.size();
+        probe.popped = metrics.popped(ENGINE_REACH) - poppedBefore;
+        probe.edges = metrics.edges(ENGINE_REACH) - edgesBefore;
+        probe.allocationBytes = metrics.allocationBytes(ENGINE_REACH) - bytesBefore + covered.size() * SET_NODE_BYTES;
+        metrics.finish(ENGINE_COVER, probe);
+        return cover;
+    }
+
+    // 그리디 방식으로 K단계 내 노드에 연락할 최소 노드 집합 찾기
+    // 기본값은 모든 노드를 커버하는 정확한 그리디이며,
+    // 목표 커버율이나 epsilon을 주면 정확한 그리디(같은 목표)와 크기/시간을 비교해 출력
+    vector<int> greedyDomination(int k, double coverageTarget = 1.0, double epsilon = 0.0, unsigned seed = 12345) {
+        auto begin = chrono::steady_clock::now();
+        CoverResult cover = coverGreedy(k, coverageTarget, epsilon, seed);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        // 선택 과정 출력
+        cout << "선택 과정:" << endl;
+        for (auto& process : cover.process) {
+            cout << "  - 노드 " << process.first << ": " << process.second << "개 노드 커버" << endl;
+        }
+        cout << "총 커버율: " << cover.totalCount << "개 중 " << cover.coveredCount << "개 노드 도달 가능" << endl;
+
+        if (epsilon > 0 || coverageTarget < 1.0) {
+            begin = chrono::steady_clock::now();
+            CoverResult exact = coverGreedy(k, coverageTarget, 0.0, seed);
+            double exactMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+            cout << "정확한 그리디와 비교 (목표 커버율 " << coverageTarget * 100 << "%):" << endl;
+            cout << "  이번 결과: " << cover.selected.size() << "개 노드, " << cover.coveredCount << "개 커버, 후보 평가 "
+                << cover.evaluations << "회, " << ms << " ms" << endl;
+            cout << "  정확한 그리디: " << exact.selected.size() << "개 노드, " << exact.coveredCount << "개 커버, 후보 평가 "
+                << exact.evaluations << "회, " << exactMs << " ms" << endl;
+            if (!exact.selected.empty()) {
+                cout << "  크기 비율: " << (double)cover.selected.size() / exact.selected.size() << "배" << endl;
+            }
+        }
+
+        return cover.selected;
+    }
+
+    // 후보 노드별 K단계 이내 도달 노드를 거리 순으로 모아 둔 캐시 (여러 k의 커버 계산이 공유)
+    struct LayeredReach {
+        int maxK = 0;
+        vector<int> candidates;  // 이웃이 있는 유효한 노드 (번호 오름차순)
+        vector<size_t> offset;   // candidates[i]의 도달 노드는 nodes[offset[i]] ~ nodes[offset[i + 1] - 1]
+        vector<int> nodes;       // 노드별 BFS 방문 순서 (거리 순)
+        vector<int> layerCount;  // layerCount[i * (maxK + 1) + d] = 거리 d 이하 도달 노드 수
+
+        const int* reach(size_t i) const { return nodes.data() + offset[i]; }
+        int within(size_t i, int k) const { return layerCount[i * (maxK + 1) + k]; }
+    };
+
+    // 후보마다 maxK단계까지 BFS를 한 번만 수행해 캐시 생성 (후보 구간을 스레드별로 나눠 처리)
+    LayeredReach buildLayeredReach(int maxK, unsigned threads = workerCount()) {
+        LayeredReach cache;
+        cache.maxK = maxK;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i) && !neighbors(i).empty()) cache.candidates.push_back(i);
+        }
+        size_t count = cache.candidates.size();
+        if (threads == 0) threads = 1;
+        if (threads > count) threads = count == 0 ? 1 : (unsigned)count;
+
+        vector<vector<int>> partNodes(threads);
+        vector<vector<size_t>> partSizes(threads);
+        cache.layerCount.assign(count * (maxK + 1), 0);
+        runParallel(count, threads, [&](size_t begin, size_t end, unsigned t) {
+            TraversalContext bfs;
+            for (size_t i = begin; i < end; i++) {
+                bfs.reset(nodeCount());
+                bfs.visit(cache.candidates[i], 0, -1);
+                int* layers = &cache.layerCount[i * (maxK + 1)];
+                while (!bfs.empty()) {
+                    int current = bfs.pop();
+                    int currentDistance = bfs.distance(current);
+                    layers[currentDistance]++;
+                    if (currentDistance >= maxK) continue;
+                    for (int neighbor : neighbors(current)) {
+                        if (!bfs.visited(neighbor)) bfs.visit(neighbor, currentDistance + 1, current);
+                    }
+                }
+                for (int d = 1; d <= maxK; d++) layers[d] += layers[d - 1];
+                partNodes[t].insert(partNodes[t].end(), bfs.visitedBegin(), bfs.visitedEnd());
+                partSizes[t].push_back(bfs.visitedCount());
+            }
+        });
+
+        // 스레드별 결과를 후보 순서대로 이어 붙임
+        cache.offset.push_back(0);
+        for (unsigned t = 0; t < threads; t++) {
+            for (size_t size : partSizes[t]) cache.offset.push_back(cache.offset.back() + size);
+            cache.nodes.insert(cache.nodes.end(), partNodes[t].begin(), partNodes[t].end());
+            vector<int>().swap(partNodes[t]);
+        }
+        return cache;
+    }
+
+    // 캐시로 k = 1..maxK 각각의 그리디 커버 계산
+    // 첫 라운드의 새 커버 수는 캐시의 단계별 개수 그대로이고, 이후 라운드에서는 새 커버 수가
+    // 줄어들기만 하므로 힙에서 꺼낸 후보만 다시 계산하는 지연 평가로도 정확한 그리디와 같은 노드를 고름
+    // (같은 커버 수면 번호가 작은 노드 우선)
+    vector<vector<int>> multiKCover(const LayeredReach& cache) {
+        vector<vector<int>> covers(cache.maxK + 1);
+        size_t count = cache.candidates.size();
+        vector<int> coveredAt(nodeCount(), 0); // 커버된 k 값 (k마다 새로 초기화할 필요 없음)
+
+        for (int k = 1; k <= cache.maxK; k++) {
+            priority_queue<pair<int, int>> heap; // (새 커버 수, -후보 번호)
+            for (size_t i = 0; i < count; i++) heap.push({ cache.within(i, k), -(int)i });
+
+            size_t coveredCount = 0;
+            while (coveredCount < count && !heap.empty()) {
+                int index = -heap.top().second;
+                heap.pop();
+                const int* reach = cache.reach(index);
+                int gain = 0;
+                for (int j = 0; j < cache.within(index, k); j++) {
+                    if (coveredAt[reach[j]] != k) gain++;
+                }
+                if (gain == 0) continue;
+                if (!heap.empty() && make_pair(gain, -index) < heap.top()) {
+                    heap.push({ gain, -index }); // 다른 후보가 더 나을 수 있으니 다시 비교
+                    continue;
+                }
+
+                covers[k].push_back(cache.candidates[index]);
+                for (int j = 0; j < cache.within(index, k); j++) {
+                    if (coveredAt[reach[j]] != k) {
+                        coveredAt[reach[j]] = k;
+                        coveredCount++;
+                    }
+                }
+            }
+        }
+        return covers;
+    }
+
+    // Lone Wolf 찾기
+    vector<int> findLoneWolves() {
+        QueryProbe probe = metrics.begin();
+        vector<int> loneWolves = isolatedNodes; // 그래프를 만들 때 모아 둔 목록
+        probe.popped = loneWolves.size();
+        probe.allocationBytes = loneWolves.capacity() * sizeof(int);
+        metrics.finish(ENGINE_LONE_WOLF, probe);
+        return loneWolves;
+    }
+
+    // 차수 분포: (차수, 노드 수) 목록 (노드가 있는 차수만, 차수 오름차순)
+    vector<pair<int, int>> degreeDistribution() const {
+        vector<pair<int, int>> distribution;
+        for (size_t d = 0; d < degreeHistogram.size(); d++) {
+            if (degreeHistogram[d] > 0) distribution.push_back({ (int)d, degreeHistogram[d] });
+        }
+        return distribution;
+    }
+
+    // 차수 상위 count개 노드 (노드, 차수)
+    vector<pair<int, int>> topDegreeNodes(size_t count) const {
+        vector<pair<int, int>> top;
+        for (size_t i = 0; i < nodesByDegree.size() && i < count; i++) {
+            top.push_back({ nodesByDegree[i], (int)neighbors(nodesByDegree[i]).size() });
+        }
+        return top;
+    }
+
+    // 매개 중심성 (Brandes 알고리즘): 최단 경로가 각 노드를 지나는 정도
+    // samples가 0이면 모든 노드를 출발점으로 쓰는 정확한 값, 아니면 무작위 출발점 표본으로 추정
+    // 출발점을 스레드에 동적으로 나누고, 스레드별 누적 배열을 노드 구간별로 나눠 합산 (잠금 없음)
+    vector<double> betweennessCentrality(size_t samples = 0, unsigned threads = workerCount(), unsigned seed = 12345) {
+        size_t n = nodeCount();
+        vector<int> sources;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i) && !neighbors(i).empty()) sources.push_back(i);
+        }
+        double scale = 0.5; // 무향 그래프라 각 경로가 양방향으로 두 번 세어짐
+        if (samples > 0 && samples < sources.size()) {
+            mt19937 rng(seed);
+            shuffle(sources.begin(), sources.end(), rng);
+            scale *= (double)sources.size() / samples;
+            sources.resize(samples);
+        }
+        if (threads == 0) threads = 1;
+        if (threads > sources.size()) threads = sources.empty() ? 1 : (unsigned)sources.size();
+
+        vector<vector<double>> partial(threads);
+        atomic<size_t> nextSource(0);
+        runParallel(threads, threads, [&](size_t, size_t, unsigned t) {
+            vector<double>& centrality = partial[t];
+            centrality.assign(n, 0.0);
+            vector<int> dist(n, -1);
+            vector<double> sigma(n, 0.0), delta(n, 0.0);
+            vector<int> order;
+            order.reserve(n);
+
+            for (size_t k = nextSource.fetch_add(1); k < sources.size(); k = nextSource.fetch_add(1)) {
+                int source = sources[k];
+                // 1단계: BFS로 최단 경로 개수 계산
+                order.clear();
+                order.push_back(source);
+                dist[source] = 0;
+                sigma[source] = 1.0;
+                for (size_t head = 0; head < order.size(); head++) {
+                    int v = order[head];
+                    for (int w : neighbors(v)) {
+                        if (dist[w] < 0) {
+                            dist[w] = dist[v] + 1;
+                            order.push_back(w);
+                        }
+                        if (dist[w] == dist[v] + 1) sigma[w] += sigma[v];
+                    }
+                }
+                // 2단계: 먼 노드부터 의존도 역전파 (선행 노드는 거리가 하나 작은 이웃)
+                for (size_t i = order.size(); i-- > 1;) {
+                    int w = order[i];
+                    double coefficient = (1.0 + delta[w]) / sigma[w];
+                    for (int v : neighbors(w)) {
+                        if (dist[v] == dist[w] - 1) delta[v] += sigma[v] * coefficient;
+                    }
+                    centrality[w] += delta[w];
+                }
+                // 방문한 노드만 되돌려 다음 출발점 준비
+                for (int v : order) {
+                    dist[v] = -1;
+                    sigma[v] = 0.0;
+                    delta[v] = 0.0;
+                }
+            }
+        });
+
+        vector<double> result(n, 0.0);
+        runParallel(n, threads, [&](size_t begin, size_t end, unsigned) {
+            for (const vector<double>& centrality : partial) {
+                for (size_t i = begin; i < end; i++) result[i] += centrality[i];
+            }
+            for (size_t i = begin; i < end; i++) result[i] *= scale;
+        });
+        return result;
+    }
+
+    // 매개 중심성 상위 count개 노드 (노드, 점수)
+    vector<pair<int, double>> topBridges(size_t count, size_t samples = 0) {
+        vector<double> centrality = betweennessCentrality(samples);
+        vector<pair<int, double>> ranked;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i) && centrality[i] > 0) ranked.push_back({ i, centrality[i] });
+        }
+        count = min(count, ranked.size());
+        partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+            [](const pair<int, double>& a, const pair<int, double>& b) {
+                return a.second != b.second ? a.second > b.second : a.first < b.first;
+            });
+        ranked.resize(count);
+        return ranked;
     }
 
-    //  ȿ ˻
-    bool isValidNode(int node) {
-        return node >= minNode && node <= maxNode && node < graph.size();
+    // 스레드 수를 1, 2, 4, ... 32로 늘려가며 매개 중심성 계산 시간 측정
+    void benchmarkBetweenness(size_t samples) {
+        cout << "매개 중심성 벤치마크 (출발점 " << (samples == 0 ? string("전체") : to_string(samples))
+            << ", 하드웨어 스레드 " << workerCount() << "개)" << endl;
+        double baseMs = 0;
+        for (unsigned threads = 1; threads <= 32; threads *= 2) {
+            auto t0 = chrono::steady_clock::now();
+            vector<double> centrality = betweennessCentrality(samples, threads);
+            auto t1 = chrono::steady_clock::now();
+            double ms = chrono::duration<double, milli>(t1 - t0).count();
+            if (threads == 1) baseMs = ms;
+            cout << "  스레드 " << threads << "개: " << ms << " ms (속도 향상 " << baseMs / ms << "배)" << endl;
+        }
     }
 
-    // BFS    ִ Ÿ  (ε Բ ȯ)
-    pair<int, vector<int>> findDistanceWithPath(int start, int end) {
-        if (start == end) return { 0, {start} };
+    // Personalized PageRank (forward push): source에서 출발해 매 단계 alpha 확률로 멈추는 랜덤 워크가
+    // 각 노드에서 끝날 확률을 추정. 잔여량이 epsilon * 차수 이상인 노드만 작업 큐에서 꺼내 밀어내므로
+    // 그래프 크기와 무관하게 source 주변의 노드만 건드림 (노드별 오차는 epsilon * 차수 이하)
+    // 반환값은 source를 제외한 점수 상위 topN개 (노드, 점수)
+    vector<pair<int, double>> personalizedPageRank(int source, size_t topN, double alpha = 0.15, double epsilon = 1e-5) {
+        return personalizedPageRank(push, source, topN, alpha, epsilon);
+    }
 
-        vector<int> distance(graph.size(), -1);
-        vector<int> parent(graph.size(), -1);
-        queue<int> q;
-
-        q.push(start);
-        distance[start] = 0;
-
-        while (!q.empty()) {
-            int current = q.front();
-            q.pop();
-
-            for (int neighbor : graph[current]) {
-                if (distance[neighbor] == -1) {
-                    distance[neighbor] = distance[current] + 1;
-                    parent[neighbor] = current;
-                    q.push(neighbor);
-
-                    if (neighbor == end) {
-                        //  
-                        vector<int> path;
-                        int node = end;
-                        while (node != -1) {
-                            path.push_back(node);
-                            node = parent[node];
-                        }
-                        reverse(path.begin(), path.end());
-                        return { distance[neighbor], path };
-                    }
-                }
+    // 주어진 작업 공간으로 계산 (동시에 질의하는 스레드는 각자 작업 공간을 가짐)
+    vector<pair<int, double>> personalizedPageRank(PushWorkspace& workspace, int source, size_t topN, double alpha, double epsilon) {
+        vector<pair<int, double>> ranked;
+        if (!isValidNode(source) || neighbors(source).empty()) return ranked;
+
+        workspace.reset(nodeCount());
+        workspace.touch(source);
+        workspace.residual(source) = 1.0;
+        workspace.enqueue(source);
+        while (!workspace.empty()) {
+            int current = workspace.dequeue();
+            NeighborRange range = neighbors(current);
+            double mass = workspace.residual(current);
+            workspace.estimate(current) += alpha * mass;
+            workspace.residual(current) = 0;
+            double share = (1 - alpha) * mass / range.size();
+            for (int neighbor : range) {
+                workspace.touch(neighbor);
+                double& residual = workspace.residual(neighbor);
+                residual += share;
+                if (residual >= epsilon * neighbors(neighbor).size()) workspace.enqueue(neighbor);
             }
         }
 
-        return { -1, {} }; //  
+        for (int node : workspace.touched()) {
+            if (node != source && workspace.estimate(node) > 0) ranked.push_back({ node, workspace.estimate(node) });
+        }
+        size_t keep = min(topN, ranked.size());
+        auto byScore = [](const pair<int, double>& a, const pair<int, double>& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        };
+        partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(), byScore);
+        ranked.resize(keep);
+        return ranked;
     }
 
-    //  Լ ȣȯ  
-    int findDistance(int start, int end) {
-        return findDistanceWithPath(start, end).first;
+    // 전체 PageRank (거듭제곱법): 노드마다 이웃의 rank / 차수를 모아 오는 CSR 곱셈을 스레드별 구간으로 나눠 수행
+    // 이웃이 없는 노드의 값은 모든 노드에 고르게 나눔. 반환값은 노드 번호로 찾는 점수 (유효하지 않은 노드는 0)
+    vector<double> pageRank(double damping = 0.85, int maxIterations = 100, double tolerance = 1e-10,
+        unsigned threads = workerCount()) {
+        size_t n = nodeCount();
+        vector<int> members;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i)) members.push_back(i);
+        }
+        vector<double> rank(n, 0.0), contribution(n, 0.0), nextRank(n, 0.0);
+        if (members.empty()) return rank;
+        double base = 1.0 / members.size();
+        for (int node : members) rank[node] = base;
+        if (threads == 0) threads = 1;
+        if (threads > members.size()) threads = (unsigned)members.size();
+
+        vector<double> partialDangling(threads), partialChange(threads);
+        for (int iteration = 0; iteration < maxIterations; iteration++) {
+            // 1단계: 노드별로 이웃에게 줄 몫 계산
+            runParallel(members.size(), threads, [&](size_t begin, size_t end, unsigned t) {
+                double dangling = 0;
+                for (size_t i = begin; i < end; i++) {
+                    int node = members[i];
+                    size_t degree = neighbors(node).size();
+                    if (degree == 0) dangling += rank[node];
+                    else contribution[node] = rank[node] / degree;
+                }
+                partialDangling[t] = dangling;
+            });
+            double dangling = 0;
+            for (unsigned t = 0; t < threads; t++) dangling += partialDangling[t];
+            double teleport = (1 - damping) * base + damping * dangling * base;
+
+            // 2단계: 이웃의 몫을 모아 새 값 계산
+            runParallel(members.size(), threads, [&](size_t begin, size_t end, unsigned t) {
+                double change = 0;
+                for (size_t i = begin; i < end; i++) {
+                    int node = members[i];
+                    double sum = 0;
+                    for (int neighbor : neighbors(node)) sum += contribution[neighbor];
+                    nextRank[node] = teleport + damping * sum;
+                    change += fabs(nextRank[node] - rank[node]);
+                }
+                partialChange[t] = change;
+            });
+            rank.swap(nextRank);
+            double change = 0;
+            for (unsigned t = 0; t < threads; t++) change += partialChange[t];
+            if (change < tolerance) break;
+        }
+        return rank;
     }
 
-    // BFS Kܰ      ã
-    set<int> getReachableNodes(int start, int k) {
-        set<int> reachable;
-        vector<int> distance(graph.size(), -1);
-        queue<int> q;
-
-        q.push(start);
-        distance[start] = 0;
-        reachable.insert(start);
-
-        while (!q.empty()) {
-            int current = q.front();
-            q.pop();
+    // 임의 출발점 Personalized PageRank 질의의 지연 시간 측정
+    void benchmarkPersonalizedPageRank(size_t queries, unsigned seed = 12345) {
+        if (queries == 0) {
+            cout << "질의 수는 1 이상이어야 합니다." << endl;
+            return;
+        }
+        vector<int> sources;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i) && !neighbors(i).empty()) sources.push_back(i);
+        }
+        if (sources.empty()) return;
+        mt19937 rng(seed);
+        vector<double> latency;
+        for (size_t q = 0; q < queries; q++) {
+            int source = sources[rng() % sources.size()];
+            auto t0 = chrono::steady_clock::now();
+            personalizedPageRank(source, 10);
+            latency.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+        }
+        sort(latency.begin(), latency.end());
+        cout << "Personalized PageRank 벤치마크 (질의 " << queries << "개, 노드 " << sources.size() << "개)" << endl;
+        cout << "  중앙값 " << latency[latency.size() / 2] << " ms, 99% " << latency[latency.size() * 99 / 100]
+            << " ms, 최대 " << latency.back() << " ms" << endl;
+    }
 
-            if (distance[current] >= k) continue;
+    // 라벨 전파(LPA) 커뮤니티 탐지. 반환값은 노드별 커뮤니티 번호 (유효하지 않은 노드는 -1)
+    // 각 노드가 이웃들에게 가장 많은 라벨을 따라가는 과정을 비동기로 반복하며,
+    // 노드를 스레드별로 나누고 라벨 빈도는 스레드마다 가진 해시 맵으로 셈
+    // refine이 true면 결과를 Louvain 방식의 지역 이동으로 모듈러리티가 오르는 동안 보정
+    vector<int> detectCommunities(bool refine, unsigned threads = workerCount(), int maxRounds = 50, unsigned seed = 12345) {
+        size_t n = nodeCount();
+        vector<int> members;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (isValidNode(i)) members.push_back(i);
+        }
 
-            for (int neighbor : graph[current]) {
-                if (distance[neighbor] == -1) {
-                    distance[neighbor] = distance[current] + 1;
-                    q.push(neighbor);
-                    reachable.insert(neighbor);
+        unique_ptr<atomic<int>[]> label(new atomic<int>[n]);
+        for (size_t i = 0; i < n; i++) label[i].store((int)i, memory_order_relaxed);
+
+        mt19937 rng(seed);
+        for (int round = 0; round < maxRounds; round++) {
+            shuffle(members.begin(), members.end(), rng);
+            atomic<size_t> changed(0);
+            runParallel(members.size(), threads, [&](size_t begin, size_t end, unsigned) {
+                unordered_map<int, int> frequency;
+                size_t localChanged = 0;
+                for (size_t k = begin; k < end; k++) {
+                    int node = members[k];
+                    NeighborRange range = neighbors(node);
+                    if (range.empty()) continue;
+
+                    frequency.clear();
+                    for (int neighbor : range) frequency[label[neighbor].load(memory_order_relaxed)]++;
+                    int current = label[node].load(memory_order_relaxed);
+                    int best = current, bestCount = 0;
+                    auto found = frequency.find(current);
+                    if (found != frequency.end()) bestCount = found->second;
+                    for (const pair<const int, int>& entry : frequency) {
+                        if (entry.second > bestCount || (entry.second == bestCount && entry.first < best && best != current)) {
+                            best = entry.first;
+                            bestCount = entry.second;
+                        }
+                    }
+                    if (best != current) {
+                        label[node].store(best, memory_order_relaxed);
+                        localChanged++;
+                    }
                 }
-            }
+                changed.fetch_add(localChanged);
+            });
+            if (changed.load() == 0) break;
         }
 
-        return reachable;
+        vector<int> community(n, -1);
+        for (int node : members) community[node] = label[node].load(memory_order_relaxed);
+        if (refine) refineCommunities(community, members);
+        return community;
     }
 
-    //  Ŀ  ִ   
-    int countNewReachable(int node, int k, const set<int>& covered) {
-        set<int> reachable = getReachableNodes(node, k);
-        int count = 0;
-
-        for (int n : reachable) {
-            if (covered.find(n) == covered.end()) {
-                count++;
+    // Louvain 지역 이동 단계: 모듈러리티가 오르는 이웃 커뮤니티로 노드를 옮기기를 반복
+    void refineCommunities(vector<int>& community, const vector<int>& members) {
+        double twoM = (double)adjacency.size();
+        if (twoM == 0) return;
+        vector<double> totalDegree(nodeCount(), 0.0); // 커뮤니티별 차수 합
+        for (int node : members) totalDegree[community[node]] += (double)neighbors(node).size();
+
+        unordered_map<int, int> linksTo;
+        bool improved = true;
+        for (int pass = 0; improved && pass < 20; pass++) {
+            improved = false;
+            for (int node : members) {
+                double degree = (double)neighbors(node).size();
+                if (degree == 0) continue;
+
+                linksTo.clear();
+                for (int neighbor : neighbors(node)) linksTo[community[neighbor]]++;
+                int current = community[node];
+                totalDegree[current] -= degree; // 잠시 빼고 모든 후보를 같은 기준으로 비교
+
+                int best = current;
+                double bestGain = linksTo[current] - totalDegree[current] * degree / twoM;
+                for (const pair<const int, int>& entry : linksTo) {
+                    double gain = entry.second - totalDegree[entry.first] * degree / twoM;
+                    if (gain > bestGain + 1e-12) {
+                        best = entry.first;
+                        bestGain = gain;
+                    }
+                }
+                totalDegree[best] += degree;
+                if (best != current) {
+                    community[node] = best;
+                    improved = true;
+                }
             }
         }
-
-        return count;
     }
 
-    // ׸  Kܰ   忡  ּ   ã
-    vector<int> greedyDomination(int k) {
-        vector<int> result;
-        set<int> covered;
-        vector<pair<int, int>> selectionProcess; // (õ ,  Ŀ  )
-
-        //  ȿ  ã
-        set<int> allNodes;
+    // 분할의 모듈러리티
+    double modularity(const vector<int>& community) {
+        double twoM = (double)adjacency.size();
+        if (twoM == 0) return 0;
+        unordered_map<int, double> inside, total;
         for (int i = minNode; i <= maxNode; i++) {
-            if (isValidNode(i) && !graph[i].empty()) {
-                allNodes.insert(i);
+            if (!isValidNode(i) || community[i] < 0) continue;
+            total[community[i]] += (double)neighbors(i).size();
+            for (int neighbor : neighbors(i)) {
+                if (community[neighbor] == community[i]) inside[community[i]] += 1;
             }
         }
+        double q = 0;
+        for (const pair<const int, double>& entry : total) {
+            q += inside[entry.first] / twoM - (entry.second / twoM) * (entry.second / twoM);
+        }
+        return q;
+    }
 
-        while (covered.size() < allNodes.size()) {
-            int bestNode = -1;
-            int maxNewCover = 0;
+    // BFS로 연결 컴포넌트 개수 계산
+    int countConnectedComponents() {
+        QueryProbe probe = metrics.begin();
+        int components = countComponents(kernelWorkspace, probe);
+        metrics.finish(ENGINE_COMPONENTS, probe);
+        return components;
+    }
 
-            for (int node : allNodes) {
-                int newCoverCount = countNewReachable(node, k, covered);
-                if (newCoverCount > maxNewCover) {
-                    maxNewCover = newCoverCount;
-                    bestNode = node;
+    int countComponents(KernelWorkspace& workspace, QueryProbe& probe) {
+        return withKernel([&](auto& graph, auto& state) {
+            typedef typename decay<decltype(graph)>::type::IdType Id;
+            probe.allocationBytes += state.newSearch(graph.nodes, false, false); // 모든 BFS가 방문 표시를 공유
+            int count = 0;
+            for (int i = minNode; i <= maxNode; i++) {
+                if (isValidNode(i) && !state.visited(i)) {
+                    BfsKernel<Id, false, false, false>::run(graph, state, (Id)i, 0, false, 0, probe);
+                    count++;
                 }
             }
+            return count;
+        }, workspace);
+    }
 
-            if (bestNode == -1 || maxNewCover == 0) break;
-
-            result.push_back(bestNode);
-            selectionProcess.push_back({ bestNode, maxNewCover });
-
-            // bestNode kܰ     带 covered ߰
-            set<int> reachable = getReachableNodes(bestNode, k);
-            for (int node : reachable) {
-                covered.insert(node);
-            }
-        }
+    // 주어진 커널 상태로 K단계 이내 도달 가능한 노드 수 계산 (출발점 포함)
+    size_t countReachable(int start, int k, KernelWorkspace& workspace, QueryProbe& probe) {
+        return withKernel([&](auto& graph, auto& state) {
+            typedef typename decay<decltype(graph)>::type::IdType Id;
+            probe.allocationBytes += state.newSearch(graph.nodes, false, false);
+            BfsKernel<Id, false, false, true>::run(graph, state, (Id)start, 0, false, k, probe);
+            return state.visitedCount();
+        }, workspace);
+    }
 
-        //   
-        cout << " :" << endl;
-        for (auto& process : selectionProcess) {
-            cout << "  -  " << process.first << ": " << process.second << "  Ŀ" << endl;
+    // 3단계 이내에 자기 그룹(연결 요소) 전체에 닿는 노드 수 (kebin의 connectors3 질의를 재생할 때 사용)
+    // 노드마다 전체 BFS로 그룹 크기를, 3단계 제한 BFS로 닿는 수를 구해 비교
+    size_t countThreeStepConnectors(KernelWorkspace& workspace, QueryProbe& probe) {
+        size_t connectors = 0;
+        for (int i = minNode; i <= maxNode; i++) {
+            if (!isValidNode(i) || neighbors(i).empty()) continue;
+            size_t group = countReachable(i, INT_MAX, workspace, probe);
+            if (group > 1 && countReachable(i, 3, workspace, probe) == group) connectors++;
         }
-        cout << " Ŀ: " << allNodes.size() << "  " << covered.size() << "   " << endl;
+        return connectors;
+    }
 
-        return result;
+    // 질의 기록 시작 (이후 run()에서 받은 질의를 파일에 남김)
+    bool startRecording(const string& path) {
+        return trace.open(path);
     }
 
-    // Lone Wolf ã
-    vector<int> findLoneWolves() {
-        vector<int> loneWolves;
-        set<int> connectedNodes;
+    // 기록된 인자가 [low, high] 범위의 정수인지 (범위 밖의 double을 int로 바꾸면 정의되지 않은 동작, nan은 비교에서 걸러짐)
+    static bool isIntArg(double value, double low, double high) {
+        return value >= low && value <= high && value == floor(value);
+    }
 
-        //    ã
-        for (int i = minNode; i <= maxNode; i++) {
-            if (isValidNode(i)) {
-                if (!graph[i].empty()) {
-                    connectedNodes.insert(i); //   ִ 
-                    for (int neighbor : graph[i]) {
-                        connectedNodes.insert(neighbor); //   ִ 
-                    }
-                }
-            }
+    // 이 그래프에서 재생할 수 있는 질의인지 (종류, 인자 수, 인자 범위, 노드 번호 확인)
+    // 기록 파일은 손으로 고치거나 깨질 수 있으므로 정수로 바꾸기 전에 모든 인자의 범위를 먼저 확인
+    bool replayable(const TraceEntry& entry) {
+        const vector<double>& a = entry.args;
+        auto isNodeArg = [this](double value) { return isIntArg(value, INT_MIN, INT_MAX) && isValidNode((int)value); };
+        if (entry.type == "distance" || entry.type == "alt") return a.size() == 2 && isNodeArg(a[0]) && isNodeArg(a[1]);
+        if (entry.type == "reach") return a.size() == 2 && isNodeArg(a[0]) && isIntArg(a[1], 0, INT_MAX);
+        if (entry.type == "components" || entry.type == "lonewolf" || entry.type == "connectors3") return a.empty();
+        if (entry.type == "cover") {
+            return !a.empty() && a.size() <= 3 && isIntArg(a[0], 1, INT_MAX) && (a.size() < 2 || (a[1] > 0 && a[1] <= 100))
+                && (a.size() < 3 || (a[2] >= 0 && a[2] < 1));
         }
-
-        // ü      ã
-        for (int i = minNode; i <= maxNode; i++) {
-            if (isValidNode(i) && connectedNodes.find(i) == connectedNodes.end()) {
-                loneWolves.push_back(i);
-            }
+        if (entry.type == "year") {
+            return a.size() == 3 && isIntArg(a[0], INT_MIN, INT_MAX) && isIntArg(a[1], INT_MIN, INT_MAX) && isIntArg(a[2], INT_MIN, INT_MAX)
+                && timeline.hasNode((int)a[0]) && timeline.hasNode((int)a[1]);
         }
-
-        return loneWolves;
+        if (entry.type == "ppr") return a.size() == 2 && isNodeArg(a[0]) && isIntArg(a[1], 1, INT_MAX);
+        return false; // 다른 프로그램의 질의 (예: kebin의 weighted)
     }
 
-    // DFS  Ʈ  
-    int countConnectedComponents() {
-        vector<bool> visited(graph.size(), false);
-        int components = 0;
+    // 기록된 질의 하나 실행. 스레드별 상태로 도는 엔진은 동시에, 공유 상태를 쓰는 엔진은 exclusive를 잡고 실행
+    void executeTraceQuery(const TraceEntry& entry, KernelWorkspace& kernels, PushWorkspace& workspace, mutex& exclusive) {
+        const vector<double>& a = entry.args;
+        QueryProbe probe;
+        probe.active = false; // 공유 계측 값은 건드리지 않음
+        if (entry.type == "distance") distanceWithPath((int)a[0], (int)a[1], kernels, probe);
+        else if (entry.type == "reach") countReachable((int)a[0], (int)a[1], kernels, probe);
+        else if (entry.type == "components") countComponents(kernels, probe);
+        else if (entry.type == "connectors3") countThreeStepConnectors(kernels, probe);
+        else if (entry.type == "ppr") personalizedPageRank(workspace, (int)a[0], (size_t)a[1], 0.15, 1e-5);
+        else {
+            lock_guard<mutex> lock(exclusive);
+            if (entry.type == "lonewolf") findLoneWolves();
+            else if (entry.type == "cover") coverGreedy((int)a[0], a.size() > 1 ? a[1] / 100 : 1.0, a.size() > 2 ? a[2] : 0.0, 12345);
+            else if (entry.type == "year") timeline.findDistanceWithPath((int)a[0], (int)a[1], (int)a[2]);
+            else if (entry.type == "alt") findDistanceWithPathALT((int)a[0], (int)a[1]);
+        }
+    }
 
-        for (int i = minNode; i <= maxNode; i++) {
-            if (isValidNode(i) && !visited[i]) {
-                dfs(i, visited);
-                components++;
-            }
+    // 기록된 질의를 개방 루프(open-loop)로 재생해 처리량과 지연 시간 측정
+    // qps > 0이면 i번째 질의를 i / qps초에, 0이면 기록된 시각 간격 그대로 보냄
+    // concurrency개의 스레드가 순서대로 질의를 가져가며, 앞 질의가 밀려도 다음 질의의 예정 시각은 바뀌지 않음
+    // 처리 시간은 실제 시작부터, 응답 시간은 예정 시각부터 재므로 응답 시간은 밀려서 기다린 시간까지 포함
+    // (닫힌 루프 측정이 느린 구간의 질의를 덜 보내 꼬리 지연을 과소평가하는 coordinated omission 보정)
+    void replayTrace(const string& path, double qps, unsigned concurrency) {
+        vector<TraceEntry> loaded, entries;
+        if (!QueryTrace::load(path, loaded)) {
+            cout << "기록 파일을 열 수 없습니다: " << path << endl;
+            return;
+        }
+        map<string, size_t> typeCount;
+        for (const TraceEntry& entry : loaded) {
+            if (!replayable(entry)) continue;
+            entries.push_back(entry);
+            typeCount[entry.type]++;
         }
+        if (entries.empty()) {
+            cout << "재생할 질의가 없습니다." << endl;
+            return;
+        }
+        if (typeCount.count("alt")) prepareLandmarks(); // 표를 읽거나 만드는 시간은 재생에서 제외
+        if (concurrency == 0) concurrency = 1;
 
-        return components;
-    }
+        vector<int64_t> due(entries.size()); // 재생 시작 기준 예정 시각 (나노초)
+        for (size_t i = 0; i < entries.size(); i++) {
+            due[i] = qps > 0 ? (int64_t)(i * 1e9 / qps) : max<int64_t>(0, (entries[i].atMicros - entries[0].atMicros) * 1000);
+        }
 
-    void dfs(int node, vector<bool>& visited) {
-        visited[node] = true;
+        struct ReplayWorker {
+            KernelWorkspace kernels;
+            PushWorkspace push;
+            LatencyHistogram service, response;
+        };
+        vector<ReplayWorker> workers(concurrency);
+        mutex exclusive;
+        atomic<size_t> next(0);
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (unsigned t = 0; t < concurrency; t++) {
+            threads.emplace_back([&, t]() {
+                ReplayWorker& worker = workers[t];
+                for (size_t i = next++; i < entries.size(); i = next++) {
+                    chrono::steady_clock::time_point scheduled = begin + chrono::nanoseconds(due[i]);
+                    this_thread::sleep_until(scheduled);
+                    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+                    executeTraceQuery(entries[i], worker.kernels, worker.push, exclusive);
+                    chrono::steady_clock::time_point finished = chrono::steady_clock::now();
+                    worker.service.record((uint64_t)chrono::duration_cast<chrono::nanoseconds>(finished - started).count());
+                    worker.response.record((uint64_t)chrono::duration_cast<chrono::nanoseconds>(finished - scheduled).count());
+                }
+            });
+        }
+        for (thread& worker : threads) worker.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
 
-        for (int neighbor : graph[node]) {
-            if (!visited[neighbor]) {
-                dfs(neighbor, visited);
-            }
+        LatencyHistogram service, response;
+        for (const ReplayWorker& worker : workers) {
+            service.merge(worker.service);
+            response.merge(worker.response);
         }
+        double offered = entries.size() > 1 && due.back() > 0 ? (entries.size() - 1) * 1e9 / due.back() : 0;
+        cout << "질의 재생: " << entries.size() << "개 (건너뜀 " << loaded.size() - entries.size() << "개), 동시 실행 "
+            << concurrency << "개" << endl;
+        cout << "  보낸 속도 " << offered << " QPS, 처리량 " << entries.size() / seconds << " QPS (" << seconds << " s)" << endl;
+        cout << "  종류별:";
+        for (const pair<const string, size_t>& entry : typeCount) cout << " " << entry.first << " " << entry.second;
+        cout << endl;
+        cout << "  지연 시간 (ms)\t\t50%\t90%\t99%\t99.9%\t최대" << endl;
+        auto printRow = [](const char* name, const LatencyHistogram& h) {
+            cout << "  " << name;
+            for (double q : { 0.5, 0.9, 0.99, 0.999 }) cout << "\t" << h.percentile(q) / 1e6;
+            cout << "\t" << h.maximum() / 1e6 << endl;
+        };
+        printRow("처리 시간 (보정 전)", service);
+        printRow("응답 시간 (보정 후)", response);
     }
 
-    //  ̽
+    // 메인 인터페이스
     void run() {
-        cout << "=== ɺ   ===" << endl;
-        cout << " : " << minNode << "~" << maxNode << endl << endl;
+        cout << "=== 케빈 베이컨 게임 ===" << endl;
+        cout << "노드 범위: " << minNode << "~" << maxNode << endl << endl;
 
         while (true) {
-            cout << " Էϼ:" << endl;
-            cout << "1.    Ÿ: A B Է" << endl;
-            cout << "2. Kܰ ̳ Ϸ  ؾ ұ?: K Է" << endl;
-            cout << "3. Lone Wolf ã:  Է " << endl;
-            cout << "4. ׷  Ȯ:  Է " << endl;
-            cout << "5. : exit" << endl << endl;
-
-            cout << ": ";
+            cout << "질문을 입력하세요:" << endl;
+            cout << "1. 두 노드 간 거리: A B 입력" << endl;
+            cout << "2. K단계 이내 연락하려면 누구에게 연락해야 할까?: K 입력" << endl;
+            cout << "3. Lone Wolf 찾기: 별도 입력 없음" << endl;
+            cout << "4. 그룹 개수 확인: 별도 입력 없음" << endl;
+            cout << "5. Y년까지 개봉한 영화만으로 두 노드 간 거리: A B Y 입력" << endl;
+            cout << "6. 연도별 최대 그룹 성장: 별도 입력 없음" << endl;
+            cout << "7. 다리 역할 노드 찾기 (매개 중심성): 상위 개수, 표본 수 입력" << endl;
+            cout << "8. 두 노드 간 모든 최단 경로: A B N(출력할 경로 수) 입력" << endl;
+            cout << "9. 커뮤니티(세부 그룹) 찾기: Louvain 보정 여부(y/n) 입력" << endl;
+            cout << "10. 분산(파티션) BFS로 두 노드 간 거리: P(파티션 수) A B 입력" << endl;
+            cout << "11. K = 1..최대 K 그리디 커버 크기 표: 최대 K 입력" << endl;
+            cout << "12. 관련 노드 추천 (Personalized PageRank): X N(추천 수) 입력" << endl;
+            cout << "13. 전체 PageRank 상위 노드: N 입력" << endl;
+            cout << "14. 탐색 계측: on | off | clear | json [파일] | prometheus [파일] 입력" << endl;
+            cout << "15. 차수 분포와 차수 상위 노드: N 입력" << endl;
+            cout << "16. 랜드마크 A*(ALT)로 두 노드 간 거리: A B 입력" << endl;
+            cout << "17. 랜드마크 다시 만들기: 개수, 방식(farthest/degree) 입력" << endl;
+            cout << "18. 종료: exit" << endl << endl;
+
+            cout << "질문: ";
             string input;
             getline(cin, input);
 
-            if (input == "exit" || input == "5") {
-                cout << "α׷ մϴ." << endl;
+            if (input == "exit" || input == "18") {
+                cout << "프로그램을 종료합니다." << endl;
                 break;
             }
 
@@ -275,37 +3100,38 @@ public:
                 choice = stoi(input);
             }
             catch (...) {
-                cout << "߸ ԷԴϴ." << endl << endl;
+                cout << "잘못된 입력입니다." << endl << endl;
                 continue;
             }
 
             switch (choice) {
             case 1: {
                 int nodeA, nodeB;
-                cout << " A: ";
+                cout << "노드 A: ";
                 cin >> nodeA;
-                cout << " B: ";
+                cout << "노드 B: ";
                 cin >> nodeB;
-                cin.ignore(); //  Ŭ
+                cin.ignore(); // 버퍼 클리어
 
                 if (!isValidNode(nodeA) || !isValidNode(nodeB)) {
-                    cout << " ʴ Դϴ." << endl << endl;
+                    cout << "존재하지 않는 노드입니다." << endl << endl;
                     break;
                 }
 
+                trace.record("distance", { (double)nodeA, (double)nodeB });
                 auto result = findDistanceWithPath(nodeA, nodeB);
                 int distance = result.first;
                 vector<int> path = result.second;
 
                 if (distance == -1) {
-                    cout << ":    ʾҽϴ." << endl << endl;
+                    cout << "결과: 두 노드는 연결되지 않았습니다." << endl << endl;
                 }
                 else {
-                    cout << ": Ÿ " << distance << "Դϴ." << endl;
-                    cout << ": ";
+                    cout << "결과: 거리는 " << distance << "입니다." << endl;
+                    cout << "경로: ";
                     for (size_t i = 0; i < path.size(); i++) {
                         cout << path[i];
-                        if (i < path.size() - 1) cout << "  ";
+                        if (i < path.size() - 1) cout << " → ";
                     }
                     cout << endl << endl;
                 }
@@ -313,41 +3139,53 @@ public:
             }
 
             case 2: {
-                int k;
-                cout << "K ܰ: ";
-                cin >> k;
-                cin.ignore(); //  Ŭ
+                // "K [목표 커버율(%)] [epsilon]" 형식, 뒤의 두 값은 생략 가능
+                int k = 0;
+                double targetPercent = 100, epsilon = 0;
+                cout << "K 단계 (선택: 목표 커버율%, 확률적 그리디 epsilon): ";
+                string line;
+                getline(cin, line);
+                istringstream iss(line);
+                iss >> k;
+                if (iss >> targetPercent) iss >> epsilon;
 
                 if (k <= 0) {
-                    cout << "K  մϴ." << endl << endl;
+                    cout << "K는 양수여야 합니다." << endl << endl;
+                    break;
+                }
+                if (targetPercent <= 0 || targetPercent > 100 || epsilon < 0 || epsilon >= 1) {
+                    cout << "목표 커버율은 0~100, epsilon은 0 이상 1 미만이어야 합니다." << endl << endl;
                     break;
                 }
 
-                cout << " ..." << endl;
-                vector<int> result = greedyDomination(k);
+                trace.record("cover", { (double)k, targetPercent, epsilon });
+                cout << "계산 중..." << endl;
+                vector<int> result = greedyDomination(k, targetPercent / 100, epsilon);
 
-                cout << ": ";
+                cout << "결과: ";
                 if (result.empty()) {
-                    cout << " 带 ã  ϴ." << endl;
+                    cout << "연락할 노드를 찾을 수 없습니다." << endl;
                 }
                 else {
-                    cout << " ";
+                    cout << "노드 ";
                     for (size_t i = 0; i < result.size(); i++) {
                         cout << result[i];
                         if (i < result.size() - 1) cout << ", ";
                     }
-                    cout << " ϼ." << endl;
-                    cout << ": ׸  (ܰ躰 ִ Ŀ  )" << endl;
+                    cout << "에게 연락하세요." << endl;
+                    if (epsilon > 0) cout << "방법: 확률적 그리디 방식 (단계별 무작위 표본 중 최대 커버 노드 선택)" << endl;
+                    else cout << "방법: 그리디 방식 (단계별 최대 커버 노드 선택)" << endl;
                 }
                 cout << endl;
                 break;
             }
 
             case 3: {
+                trace.record("lonewolf", {});
                 vector<int> loneWolves = findLoneWolves();
-                cout << ": ";
+                cout << "결과: ";
                 if (loneWolves.empty()) {
-                    cout << "Lone Wolf ϴ." << endl;
+                    cout << "Lone Wolf가 없습니다." << endl;
                 }
                 else {
                     cout << "Lone Wolf: ";
@@ -362,26 +3200,503 @@ public:
             }
 
             case 4: {
+                trace.record("components", {});
                 int components = countConnectedComponents();
-                cout << ": " << components << " ׷ ֽϴ." << endl << endl;
+                cout << "결과: " << components << "개의 그룹이 있습니다." << endl << endl;
+                break;
+            }
+
+            case 5: {
+                if (timeline.empty()) {
+                    cout << "연도별 출연 기록(films.txt)이 없습니다." << endl << endl;
+                    break;
+                }
+                int nodeA, nodeB, year;
+                cout << "노드 A: ";
+                cin >> nodeA;
+                cout << "노드 B: ";
+                cin >> nodeB;
+                cout << "연도 Y (" << timeline.firstYear() << "~" << timeline.lastYear() << "): ";
+                cin >> year;
+                cin.ignore(); // 버퍼 클리어
+
+                if (!timeline.hasNode(nodeA) || !timeline.hasNode(nodeB)) {
+                    cout << "출연 기록이 없는 노드입니다." << endl << endl;
+                    break;
+                }
+
+                trace.record("year", { (double)nodeA, (double)nodeB, (double)year });
+                auto result = timeline.findDistanceWithPath(nodeA, nodeB, year);
+                if (result.first == -1) {
+                    cout << "결과: " << year << "년까지는 두 노드가 연결되지 않았습니다." << endl << endl;
+                }
+                else {
+                    cout << "결과: " << year << "년까지의 거리는 " << result.first << "입니다." << endl;
+                    cout << "경로: ";
+                    for (size_t i = 0; i < result.second.size(); i++) {
+                        cout << result.second[i];
+                        if (i < result.second.size() - 1) cout << " → ";
+                    }
+                    cout << endl << endl;
+                }
+                break;
+            }
+
+            case 6: {
+                if (timeline.empty()) {
+                    cout << "연도별 출연 기록(films.txt)이 없습니다." << endl << endl;
+                    break;
+                }
+                cout << "연도\t출연 노드\t그룹 수\t최대 그룹" << endl;
+                for (const TemporalGraph::YearStat& stat : timeline.giantComponentGrowth()) {
+                    cout << stat.year << "\t" << stat.activeNodes << "\t\t" << stat.components
+                        << "\t" << stat.giantSize << endl;
+                }
+                cout << endl;
+                break;
+            }
+
+            case 7: {
+                int count, samples;
+                cout << "상위 몇 개: ";
+                cin >> count;
+                cout << "표본 출발점 수 (0이면 정확 계산): ";
+                cin >> samples;
+                cin.ignore(); // 버퍼 클리어
+
+                if (count <= 0 || samples < 0) {
+                    cout << "잘못된 입력입니다." << endl << endl;
+                    break;
+                }
+
+                cout << "계산 중..." << endl;
+                vector<pair<int, double>> bridges = topBridges((size_t)count, (size_t)samples);
+                if (bridges.empty()) {
+                    cout << "결과: 최단 경로의 중간에 놓인 노드가 없습니다." << endl << endl;
+                    break;
+                }
+                cout << "결과:" << endl;
+                for (size_t i = 0; i < bridges.size(); i++) {
+                    cout << "  " << i + 1 << ". 노드 " << bridges[i].first << " (매개 중심성 "
+                        << bridges[i].second << ")" << endl;
+                }
+                cout << endl;
+                break;
+            }
+
+            case 8: {
+                int nodeA, nodeB, limit;
+                cout << "노드 A: ";
+                cin >> nodeA;
+                cout << "노드 B: ";
+                cin >> nodeB;
+                cout << "출력할 경로 수 N: ";
+                cin >> limit;
+                cin.ignore(); // 버퍼 클리어
+
+                if (!isValidNode(nodeA) || !isValidNode(nodeB)) {
+                    cout << "존재하지 않는 노드입니다." << endl << endl;
+                    break;
+                }
+
+                ShortestPathDag dag = buildShortestPathDag(nodeA, nodeB);
+                if (!dag.connected()) {
+                    cout << "결과: 두 노드는 연결되지 않았습니다." << endl << endl;
+                    break;
+                }
+                cout << "결과: 거리 " << dag.distance << ", 최단 경로 " << dag.countPaths().toString() << "개" << endl;
+                ShortestPathDag::PathIterator it = dag.paths();
+                vector<int> path;
+                for (int shown = 0; shown < limit && it.next(path); shown++) {
+                    cout << "  ";
+                    for (size_t i = 0; i < path.size(); i++) {
+                        cout << path[i];
+                        if (i < path.size() - 1) cout << " → ";
+                    }
+                    cout << endl;
+                }
+                cout << endl;
+                break;
+            }
+
+            case 9: {
+                string answer;
+                cout << "Louvain 보정 (y/n): ";
+                getline(cin, answer);
+                bool refine = !answer.empty() && (answer[0] == 'y' || answer[0] == 'Y');
+
+                cout << "계산 중..." << endl;
+                vector<int> community = detectCommunities(refine);
+                map<int, int> sizeOf; // 커뮤니티 번호 -> 크기
+                for (int label : community) {
+                    if (label >= 0) sizeOf[label]++;
+                }
+                map<int, int> histogram; // 크기 구간(2의 거듭제곱) -> 커뮤니티 수
+                int largest = 0;
+                for (const pair<const int, int>& entry : sizeOf) {
+                    int bucket = 1;
+                    while (bucket * 2 <= entry.second) bucket *= 2;
+                    histogram[bucket]++;
+                    largest = max(largest, entry.second);
+                }
+
+                cout << "결과: " << sizeOf.size() << "개의 커뮤니티 (최대 크기 " << largest
+                    << ", 모듈러리티 " << modularity(community) << ")" << endl;
+                cout << "크기 분포:" << endl;
+                for (const pair<const int, int>& entry : histogram) {
+                    cout << "  " << entry.first << "~" << entry.first * 2 - 1 << "명: "
+                        << string(min(entry.second, 50), '#') << " " << entry.second << endl;
+                }
+                cout << endl;
+                break;
+            }
+
+            case 10: {
+                int partitionCount, a, b;
+                cout << "파티션 수 P: ";
+                cin >> partitionCount;
+                cout << "노드 A: ";
+                cin >> a;
+                cout << "노드 B: ";
+                cin >> b;
+                cin.ignore();
+
+                if (partitionCount < 1 || partitionCount > 64) {
+                    cout << "P는 1~64 사이여야 합니다." << endl << endl;
+                    break;
+                }
+                if (!isValidNode(a) || !isValidNode(b)) {
+                    cout << "존재하지 않는 노드입니다." << endl << endl;
+                    break;
+                }
+
+                auto begin = chrono::steady_clock::now();
+                pair<int, vector<int>> result = findShardedDistanceWithPath(a, b, partitionCount);
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+                if (result.first == -2) {
+                    cout << "작업자를 시작할 수 없습니다." << endl << endl;
+                    break;
+                }
+                if (result.first == -1) {
+                    cout << "결과: 두 노드는 연결되지 않았습니다." << endl;
+                }
+                else {
+                    cout << "결과: 거리는 " << result.first << "입니다." << endl;
+                    cout << "경로: ";
+                    for (size_t i = 0; i < result.second.size(); i++) {
+                        cout << result.second[i];
+                        if (i < result.second.size() - 1) cout << " → ";
+                    }
+                    cout << endl;
+                }
+                // 단일 프로세스 BFS와 결과 비교
+                bool same = findDistanceWithPath(a, b) == result;
+                cout << "작업자 " << partitionCount << "개, " << ms << " ms, 단일 BFS와 "
+                    << (same ? "일치" : "불일치") << endl << endl;
+                break;
+            }
+
+            case 11: {
+                int maxK;
+                cout << "최대 K: ";
+                cin >> maxK;
+                cin.ignore();
+
+                if (maxK <= 0) {
+                    cout << "K는 양수여야 합니다." << endl << endl;
+                    break;
+                }
+
+                cout << "계산 중..." << endl;
+                auto begin = chrono::steady_clock::now();
+                LayeredReach cache = buildLayeredReach(maxK);
+                double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+                begin = chrono::steady_clock::now();
+                vector<vector<int>> covers = multiKCover(cache);
+                double coverMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+                cout << "결과:" << endl;
+                cout << "K\t연락할 노드 수\t연락할 노드" << endl;
+                for (int k = 1; k <= maxK; k++) {
+                    cout << k << "\t" << covers[k].size() << "\t";
+                    for (size_t i = 0; i < covers[k].size() && i < 10; i++) {
+                        if (i > 0) cout << ", ";
+                        cout << covers[k][i];
+                    }
+                    if (covers[k].size() > 10) cout << ", ...";
+                    cout << endl;
+                }
+                cout << "도달 정보 " << cache.nodes.size() << "개 (BFS " << cache.candidates.size() << "회, "
+                    << buildMs << " ms), 커버 계산 " << coverMs << " ms" << endl << endl;
+                break;
+            }
+
+            case 12: {
+                int x, count;
+                cout << "노드 X: ";
+                cin >> x;
+                cout << "추천 수 N: ";
+                cin >> count;
+                cin.ignore();
+
+                if (!isValidNode(x) || count <= 0) {
+                    cout << "잘못된 입력입니다." << endl << endl;
+                    break;
+                }
+
+                trace.record("ppr", { (double)x, (double)count });
+                auto begin = chrono::steady_clock::now();
+                vector<pair<int, double>> related = personalizedPageRank(x, count);
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+                if (related.empty()) {
+                    cout << "결과: 연결된 노드가 없습니다." << endl << endl;
+                    break;
+                }
+                cout << "결과 (" << ms << " ms):" << endl;
+                for (size_t i = 0; i < related.size(); i++) {
+                    cout << "  " << i + 1 << ". 노드 " << related[i].first << " (점수 " << related[i].second << ")" << endl;
+                }
+                cout << endl;
+                break;
+            }
+
+            case 13: {
+                int count;
+                cout << "상위 몇 개: ";
+                cin >> count;
+                cin.ignore();
+
+                if (count <= 0) {
+                    cout << "잘못된 입력입니다." << endl << endl;
+                    break;
+                }
+
+                cout << "계산 중..." << endl;
+                vector<double> rank = pageRank();
+                vector<pair<double, int>> ordered;
+                for (int i = minNode; i <= maxNode; i++) {
+                    if (isValidNode(i)) ordered.push_back({ -rank[i], i });
+                }
+                sort(ordered.begin(), ordered.end());
+                cout << "결과:" << endl;
+                for (size_t i = 0; i < ordered.size() && i < (size_t)count; i++) {
+                    cout << "  " << i + 1 << ". 노드 " << ordered[i].second << " (PageRank " << -ordered[i].first << ")" << endl;
+                }
+                cout << endl;
+                break;
+            }
+
+            case 14: {
+                string line, command, path;
+                cout << "명령: ";
+                getline(cin, line);
+                istringstream iss(line);
+                iss >> command >> path;
+
+                if (command == "on" || command == "off") {
+                    metrics.enabled = command == "on";
+                    cout << "결과: 계측을 " << (metrics.enabled ? "켰습니다." : "껐습니다.") << endl << endl;
+                }
+                else if (command == "clear") {
+                    metrics.clear();
+                    cout << "결과: 계측 값을 지웠습니다." << endl << endl;
+                }
+                else if (command == "json" || command == "prometheus") {
+                    ofstream file;
+                    if (!path.empty()) {
+                        file.open(path);
+                        if (!file) {
+                            cout << "파일을 열 수 없습니다: " << path << endl << endl;
+                            break;
+                        }
+                    }
+                    ostream& out = path.empty() ? cout : file;
+                    if (command == "json") metrics.writeJson(out);
+                    else metrics.writePrometheus(out);
+                    if (!path.empty()) cout << "결과: " << path << "에 저장했습니다." << endl;
+                    cout << endl;
+                }
+                else {
+                    cout << "잘못된 입력입니다." << endl << endl;
+                }
+                break;
+            }
+
+            case 15: {
+                int count;
+                cout << "상위 몇 개: ";
+                cin >> count;
+                cin.ignore();
+
+                if (count <= 0) {
+                    cout << "잘못된 입력입니다." << endl << endl;
+                    break;
+                }
+
+                cout << "결과:" << endl;
+                cout << "차수\t노드 수" << endl;
+                for (const pair<int, int>& entry : degreeDistribution()) {
+                    cout << entry.first << "\t" << entry.second << endl;
+                }
+                cout << "차수 상위 노드:" << endl;
+                vector<pair<int, int>> top = topDegreeNodes(count);
+                for (size_t i = 0; i < top.size(); i++) {
+                    cout << "  " << i + 1 << ". 노드 " << top[i].first << " (차수 " << top[i].second << ")" << endl;
+                }
+                cout << endl;
+                break;
+            }
+
+            case 16: {
+                int a, b;
+                cout << "노드 A: ";
+                cin >> a;
+                cout << "노드 B: ";
+                cin >> b;
+                cin.ignore();
+
+                if (!isValidNode(a) || !isValidNode(b)) {
+                    cout << "존재하지 않는 노드입니다." << endl << endl;
+                    break;
+                }
+
+                trace.record("alt", { (double)a, (double)b });
+                uint64_t settled = 0;
+                pair<int, vector<int>> result = findDistanceWithPathALT(a, b, &settled);
+                if (result.first == -1) {
+                    cout << "결과: 두 노드는 연결되지 않았습니다." << endl;
+                }
+                else {
+                    cout << "결과: 거리는 " << result.first << "입니다." << endl;
+                    cout << "경로: ";
+                    for (size_t i = 0; i < result.second.size(); i++) {
+                        cout << result.second[i];
+                        if (i < result.second.size() - 1) cout << " → ";
+                    }
+                    cout << endl;
+                }
+                int bfsDistance = findDistanceWithPath(a, b).first;
+                cout << "확정한 노드 " << settled << "개 (BFS 방문 " << (a == b ? 1 : lastSearchVisited())
+                    << "개), BFS 거리와 " << (bfsDistance == result.first ? "일치" : "불일치") << endl << endl;
+                break;
+            }
+
+            case 17: {
+                int count;
+                string strategy;
+                cout << "랜드마크 개수: ";
+                cin >> count;
+                cout << "방식 (farthest/degree): ";
+                cin >> strategy;
+                cin.ignore();
+
+                if (count <= 0 || (strategy != "farthest" && strategy != "degree")) {
+                    cout << "잘못된 입력입니다." << endl << endl;
+                    break;
+                }
+
+                auto begin = chrono::steady_clock::now();
+                prepareLandmarks(count, strategy == "farthest" ? LandmarkIndex::FARTHEST : LandmarkIndex::DEGREE, true);
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+                cout << "결과: 랜드마크 " << landmarkIndex.landmarkNodes().size() << "개 (" << ms << " ms): ";
+                for (size_t i = 0; i < landmarkIndex.landmarkNodes().size(); i++) {
+                    if (i > 0) cout << ", ";
+                    cout << landmarkIndex.landmarkNodes()[i];
+                }
+                cout << endl << endl;
                 break;
             }
 
             default:
-                cout << "߸ Դϴ." << endl << endl;
+                cout << "잘못된 선택입니다." << endl << endl;
                 break;
             }
         }
     }
 };
 
-int main() {
+// 명령줄 인자를 0 이상의 정수로 읽음 (숫자가 아니거나 범위를 넘으면 false, 예외를 던지지 않음)
+bool parseCount(const char* text, size_t& value) {
+    if (text[0] < '0' || text[0] > '9') return false;
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > SIZE_MAX) return false;
+    value = (size_t)parsed;
+    return true;
+}
+
+// 명령줄 인자를 0 이상의 유한한 실수로 읽음
+bool parseRate(const char* text, double& value) {
+    char* end = nullptr;
+    errno = 0;
+    double parsed = strtod(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !(parsed >= 0) || isinf(parsed)) return false;
+    value = parsed;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
     KevinBaconGame game;
 
-    // kb.txt  ε
+    // kb.txt 파일 로드
     string filename = "kb.txt";
     if (!game.loadGraph(filename)) {
-        cout << " ε忡 ߽ϴ. " << filename << "  ϴ Ȯϼ." << endl;
+        cout << "파일 로드에 실패했습니다. " << filename << " 파일이 존재하는지 확인하세요." << endl;
+        return 1;
+    }
+
+    // 개봉 연도가 붙은 영화별 출연진 (없으면 연도 관련 질문만 비활성화)
+    game.loadFilmography("films.txt");
+
+    // 벤치마크 모드: Kevin_B --bench-betweenness [표본 수]
+    if (argc >= 2 && string(argv[1]) == "--bench-betweenness") {
+        size_t samples = 0;
+        if (argc >= 3 && !parseCount(argv[2], samples)) {
+            cout << "사용법: Kevin_B --bench-betweenness [표본 수]" << endl;
+            return 1;
+        }
+        game.benchmarkBetweenness(samples);
+        return 0;
+    }
+
+    // 벤치마크 모드: Kevin_B --bench-ppr [질의 수]
+    if (argc >= 2 && string(argv[1]) == "--bench-ppr") {
+        size_t queries = 1000;
+        if (argc >= 3 && !parseCount(argv[2], queries)) {
+            cout << "사용법: Kevin_B --bench-ppr [질의 수]" << endl;
+            return 1;
+        }
+        game.benchmarkPersonalizedPageRank(queries);
+        return 0;
+    }
+
+    // 벤치마크 모드: Kevin_B --bench-alt [질의 수]
+    if (argc >= 2 && string(argv[1]) == "--bench-alt") {
+        size_t queries = 1000;
+        if (argc >= 3 && !parseCount(argv[2], queries)) {
+            cout << "사용법: Kevin_B --bench-alt [질의 수]" << endl;
+            return 1;
+        }
+        game.benchmarkALT(queries);
+        return 0;
+    }
+
+    // 질의 재생 모드: Kevin_B --replay 기록파일 [QPS(0이면 기록된 시각)] [동시 실행 수]
+    if (argc >= 3 && string(argv[1]) == "--replay") {
+        double qps = 0;
+        size_t concurrency = 1;
+        if ((argc >= 4 && !parseRate(argv[3], qps)) || (argc >= 5 && (!parseCount(argv[4], concurrency) || concurrency == 0 || concurrency > 1024))) {
+            cout << "사용법: Kevin_B --replay 기록파일 [QPS(0 이상, 0이면 기록된 시각)] [동시 실행 수(1~1024)]" << endl;
+            return 1;
+        }
+        game.replayTrace(argv[2], qps, (unsigned)concurrency);
+        return 0;
+    }
+
+    // 질의 기록 모드: Kevin_B --record 기록파일 (대화형으로 받은 질의를 시각과 함께 저장)
+    if (argc >= 3 && string(argv[1]) == "--record" && !game.startRecording(argv[2])) {
+        cout << "기록 파일을 만들 수 없습니다: " << argv[2] << endl;
         return 1;
     }
 
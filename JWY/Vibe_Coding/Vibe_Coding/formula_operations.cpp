@@ -7,10 +7,25 @@
 #include <iomanip>
 #include <cmath>
 #include <utility>
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <memory>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FORMULA_USE_SSE2 1
+#endif
 
 using namespace std;
 
-// ȣ Ȯ (Ұȣ, ߰ȣ, ȣ)
+// 괄호인지 확인 (소괄호, 중괄호, 대괄호)
 bool isOpenBracket(char c) {
     return c == '(' || c == '{' || c == '[';
 }
@@ -19,347 +34,1402 @@ bool isCloseBracket(char c) {
     return c == ')' || c == '}' || c == ']';
 }
 
-// ĪǴ ȣ Ȯ
+// 매칭되는 괄호인지 확인
 bool isMatchingBracket(char open, char close) {
     return (open == '(' && close == ')') ||
         (open == '{' && close == '}') ||
         (open == '[' && close == ']');
 }
 
-class ExpressionCalculator {
-private:
-    //  켱 ȯ
-    int getPrecedence(char op) {
-        switch (op) {
-        case '+':
-        case '-':
-            return 1;
-        case '*':
-        case '/':
-            return 2;
-        case '^':  // ŵ 
-            return 3;
-        default:
-            return -1;
-        }
+// 변수 이름인지 확인 (영문자나 _로 시작, 이후 영문자/숫자/_). 앞에 부호 하나는 허용 (-x)
+bool isVariable(const string& str) {
+    size_t start = (!str.empty() && (str[0] == '-' || str[0] == '+')) ? 1 : 0;
+    if (start >= str.length() || !(isalpha((unsigned char)str[start]) || str[start] == '_')) return false;
+    for (size_t i = start + 1; i < str.length(); i++) {
+        if (!isalnum((unsigned char)str[i]) && str[i] != '_') return false;
     }
+    return true;
+}
 
-    //  Ȯ
-    bool isOperator(char c) {
-        return c == '+' || c == '-' || c == '*' || c == '/' || c == '^';
-    }
+// 수식 토큰. 원본 문자열의 위치만 가리키므로 토큰마다 문자열을 만들지 않음
+struct Token {
+    enum Kind { END, NUMBER, VARIABLE, OPERATOR, OPEN, CLOSE, INVALID };
+    Kind kind;
+    char symbol;    // 연산자/괄호 문자. 숫자/변수는 앞에 붙은 부호('-', '+', 없으면 0)
+    size_t offset;  // 원본에서 시작 위치 (부호 포함)
+    size_t length;  // 원본에서 길이 (부호 포함)
+    double value;   // NUMBER일 때 값 (부호 제외)
+};
 
-    // ڿ   (,  )
-    bool isNumber(const string& str) {
-        if (str.empty()) return false;
+// 수식을 앞에서부터 한 토큰씩 읽는 렉서. 메모리를 할당하지 않음
+// 부호: 중위 표기에서는 수식 처음, 여는 괄호나 연산자 바로 뒤에서 숫자/변수에 붙어 있는 +, -만 부호로 보고,
+//       후위 표기에서는 숫자/변수에 붙어 있으면 항상 부호로 봄
+// **는 ^ 하나로 읽고, 중위 표기의 묵시적 곱셈(3(, )3, )()은 그 자리에 길이 0인 * 토큰을 끼워 넣음
+// 따라서 수식을 미리 고쳐 쓰는 단계 없이 한 번 훑는 것으로 끝남
+class Lexer {
+public:
+    Lexer(const string& text, bool postfix = false)
+        : begin(text.data()), end(text.data() + text.size()), pos(text.data()), postfixMode(postfix), previous(Token::END) {}
 
-        size_t start = 0;
-        if (str[0] == '-' || str[0] == '+') {
-            if (str.length() == 1) return false;
-            start = 1;
+    // 다음 토큰을 읽음. 수식 끝이면 false
+    bool next(Token& token) {
+        while (pos < end && isspace((unsigned char)*pos)) pos++;
+        token.symbol = 0;
+        token.value = 0;
+        token.offset = pos - begin;
+        if (pos == end) {
+            token.kind = Token::END;
+            token.length = 0;
+            return false;
         }
 
-        bool hasDecimal = false;
-        for (size_t i = start; i < str.length(); i++) {
-            if (str[i] == '.') {
-                if (hasDecimal) return false;
-                hasDecimal = true;
-            }
-            else if (!isdigit(str[i])) {
-                return false;
+        const char* start = pos;
+        char c = *pos;
+        if (!postfixMode && ((previous == Token::NUMBER && isOpenBracket(c)) ||
+            (previous == Token::CLOSE && (isOpenBracket(c) || isdigit((unsigned char)c) || c == '.')))) {
+            token.kind = Token::OPERATOR;
+            token.symbol = '*';
+            token.length = 0;
+            previous = Token::OPERATOR;
+            return true;
+        }
+        if ((c == '-' || c == '+') && pos + 1 < end && startsOperand(pos[1]) &&
+            (postfixMode || previous == Token::END || previous == Token::OPEN || previous == Token::OPERATOR)) {
+            token.symbol = c;
+            c = *++pos;
+        }
+
+        if (isdigit((unsigned char)c) || c == '.') {
+            token.kind = scanNumber(token.value) ? Token::NUMBER : Token::INVALID;
+        }
+        else if (isalpha((unsigned char)c) || c == '_') {
+            while (pos < end && (isalnum((unsigned char)*pos) || *pos == '_')) pos++;
+            token.kind = Token::VARIABLE;
+        }
+        else {
+            token.kind = isOpenBracket(c) ? Token::OPEN : isCloseBracket(c) ? Token::CLOSE
+                : (c == '+' || c == '-' || c == '*' || c == '/' || c == '^') ? Token::OPERATOR : Token::INVALID;
+            if (c == '*' && pos + 1 < end && pos[1] == '*') { // **는 거듭제곱
+                c = '^';
+                pos++;
             }
+            token.symbol = c;
+            pos++;
         }
+
+        token.length = pos - start;
+        previous = token.kind;
         return true;
     }
 
-    //  ǥ ū и
-    vector<string> tokenize(const string& expression) {
-        vector<string> tokens;
-        string current = "";
+private:
+    const char* begin;
+    const char* end;
+    const char* pos;
+    bool postfixMode;
+    Token::Kind previous;
 
-        for (size_t i = 0; i < expression.length(); i++) {
-            char c = expression[i];
+    static bool startsOperand(char c) {
+        return isalnum((unsigned char)c) || c == '_' || c == '.';
+    }
 
-            //  
-            if (isspace(c)) {
-                if (!current.empty()) {
-                    tokens.push_back(current);
-                    current = "";
-                }
+    // 숫자와 소수점을 읽어 값으로 바꿈. 소수점이 둘 이상이거나 숫자가 없으면 false
+    bool scanNumber(double& value) {
+        static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        const char* start = pos;
+        uint64_t mantissa = 0;
+        int digits = 0, fraction = 0, dots = 0;
+        for (; pos < end && (isdigit((unsigned char)*pos) || *pos == '.'); pos++) {
+            if (*pos == '.') {
+                dots++;
                 continue;
             }
+            if (digits < 19) mantissa = mantissa * 10 + (*pos - '0');
+            digits++;
+            if (dots) fraction++;
+        }
+        if (dots > 1 || digits == 0) return false;
 
-            // ȣ  
-            if (isOpenBracket(c) || isCloseBracket(c) || isOperator(c)) {
-                if (!current.empty()) {
-                    tokens.push_back(current);
-                    current = "";
-                }
+        // 유효 숫자 15개 이하의 정수(2^53 미만)와 10^22 이하의 10의 거듭제곱은 double로 정확히 표현되므로
+        // 나눗셈 한 번의 반올림 결과가 strtod와 같은 값 (SGS, KJH 계산기의 렉서도 이 근거를 따름)
+        if (digits <= 15 && fraction <= 22) {
+            value = (double)mantissa / powers[fraction];
+            return true;
+        }
+        // 긴 숫자는 strtod로 (원본이 이어지므로 잘라서 복사)
+        char buffer[64];
+        size_t length = pos - start;
+        if (length < sizeof(buffer)) {
+            memcpy(buffer, start, length);
+            buffer[length] = '\0';
+            value = strtod(buffer, nullptr);
+        }
+        else {
+            value = strtod(string(start, pos).c_str(), nullptr);
+        }
+        return !isinf(value);
+    }
+};
+
+// 열 단위 계산용 연산. 블록 전체에 같은 연산을 적용하며 SSE2가 있으면 두 행씩 처리
+// 0으로 나눈 행은 NaN
+struct AddKernel {
+    static double apply(double a, double b) { return a + b; }
+#ifdef FORMULA_USE_SSE2
+    static __m128d apply(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+#endif
+};
 
-                // ȣ ó: +, -   տ   (/)
-                if (c == '-' || c == '+') {
-                    if (tokens.empty() || isOpenBracket(tokens.back()[0]) ||
-                        (tokens.back().length() == 1 && isOperator(tokens.back()[0]))) {
-                        current = c; // + Ǵ - ȣ ó
-                        continue;
+struct SubKernel {
+    static double apply(double a, double b) { return a - b; }
+#ifdef FORMULA_USE_SSE2
+    static __m128d apply(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+#endif
+};
+
+struct MulKernel {
+    static double apply(double a, double b) { return a * b; }
+#ifdef FORMULA_USE_SSE2
+    static __m128d apply(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+#endif
+};
+
+struct DivKernel {
+    static double apply(double a, double b) { return b == 0 ? NAN : a / b; }
+#ifdef FORMULA_USE_SSE2
+    static __m128d apply(__m128d a, __m128d b) {
+        __m128d zero = _mm_cmpeq_pd(b, _mm_setzero_pd());
+        return _mm_or_pd(_mm_andnot_pd(zero, _mm_div_pd(a, b)), _mm_and_pd(zero, _mm_set1_pd(NAN)));
+    }
+#endif
+};
+
+// 거듭제곱은 벡터 명령이 없어 두 행을 따로 계산
+struct PowKernel {
+    static double apply(double a, double b) { return pow(a, b); }
+#ifdef FORMULA_USE_SSE2
+    static __m128d apply(__m128d a, __m128d b) {
+        double x[2], y[2];
+        _mm_storeu_pd(x, a);
+        _mm_storeu_pd(y, b);
+        return _mm_set_pd(pow(x[1], y[1]), pow(x[0], y[0]));
+    }
+#endif
+};
+
+// out[i] = a[i] op b[i] (out은 a와 같아도 됨)
+template <typename Kernel>
+void applyColumns(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+#ifdef FORMULA_USE_SSE2
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, Kernel::apply(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+#endif
+    for (; i < n; i++) out[i] = Kernel::apply(a[i], b[i]);
+}
+
+// out[i] = a[i] op b
+template <typename Kernel>
+void applyColumnConstant(const double* a, double b, double* out, size_t n) {
+    size_t i = 0;
+#ifdef FORMULA_USE_SSE2
+    __m128d wide = _mm_set1_pd(b);
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, Kernel::apply(_mm_loadu_pd(a + i), wide));
+    }
+#endif
+    for (; i < n; i++) out[i] = Kernel::apply(a[i], b);
+}
+
+// b가 있으면 out[i] = a[i] op b[i], 없으면 out[i] = a[i] op constant
+template <typename Kernel>
+void applyBlock(const double* a, const double* b, double constant, double* out, size_t n) {
+    if (b) applyColumns<Kernel>(a, b, out, n);
+    else applyColumnConstant<Kernel>(a, constant, out, n);
+}
+
+// 후위 표기법을 한 번 해석해 만든 바이트코드 프로그램
+// 숫자는 상수 풀에, 연산은 타입이 정해진 명령어로 저장하고 계산용 스택도 최대 깊이만큼 미리 잡아 두므로
+// 같은 수식을 반복 계산할 때는 문자열 해석이나 메모리 할당이 없음
+class CompiledFormula {
+public:
+    enum OpCode : uint8_t {
+        PUSH,                                               // 상수 풀의 값을 스택에 넣음
+        LOAD,                                               // 변수 값을 스택에 넣음
+        NEG,                                                // 스택 맨 위 값의 부호를 바꿈 (-x)
+        ADD, SUB, MUL, DIV, POW,                            // 스택 위 두 값으로 계산
+        ADD_CONST, SUB_CONST, MUL_CONST, DIV_CONST, POW_CONST // 스택 맨 위 값과 상수로 계산 (PUSH + 연산을 합친 것)
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t operand; // PUSH, *_CONST의 상수 풀 번호, LOAD의 변수 번호
+    };
+
+    enum { BLOCK_ROWS = 1024 }; // 열 단위 계산에서 명령어 하나가 한 번에 처리하는 행 수
+
+private:
+    vector<Instruction> code;
+    vector<double> constants;
+    vector<string> variableNames; // 수식에 처음 나온 순서
+    vector<double> stack;
+    vector<double> blockStack;    // 열 단위 계산용 스택 (칸마다 BLOCK_ROWS개)
+
+    friend class ExpressionCalculator;
+
+public:
+    bool empty() const { return code.empty(); }
+    size_t instructionCount() const { return code.size(); }
+    size_t constantCount() const { return constants.size(); }
+    const vector<string>& variables() const { return variableNames; }
+
+    // 변수가 없는 프로그램 실행. 0으로 나누면 false
+    bool evaluate(double& result) {
+        return evaluate(nullptr, result);
+    }
+
+    // values[i]를 variables()[i]의 값으로 실행. 0으로 나누면 false
+    bool evaluate(const double* values, double& result) {
+        double* s = stack.data();
+        size_t top = 0; // 다음에 쓸 칸
+        const double* pool = constants.data();
+        for (const Instruction& in : code) {
+            switch (in.op) {
+            case PUSH: s[top++] = pool[in.operand]; break;
+            case LOAD: s[top++] = values[in.operand]; break;
+            case NEG: s[top - 1] = -s[top - 1]; break;
+            case ADD: top--; s[top - 1] += s[top]; break;
+            case SUB: top--; s[top - 1] -= s[top]; break;
+            case MUL: top--; s[top - 1] *= s[top]; break;
+            case DIV:
+                top--;
+                if (s[top] == 0) return false;
+                s[top - 1] /= s[top];
+                break;
+            case POW: top--; s[top - 1] = pow(s[top - 1], s[top]); break;
+            case ADD_CONST: s[top - 1] += pool[in.operand]; break;
+            case SUB_CONST: s[top - 1] -= pool[in.operand]; break;
+            case MUL_CONST: s[top - 1] *= pool[in.operand]; break;
+            case DIV_CONST:
+                if (pool[in.operand] == 0) return false;
+                s[top - 1] /= pool[in.operand];
+                break;
+            case POW_CONST: s[top - 1] = pow(s[top - 1], pool[in.operand]); break;
+            }
+        }
+        result = s[0];
+        return true;
+    }
+
+    // 열 단위 계산: columns[i]는 variables()[i]의 값 rows개, 결과는 out[0, rows)
+    // BLOCK_ROWS행씩 나눠 명령어 하나를 블록 전체에 적용하므로 명령 해석 비용은 블록마다 한 번이고,
+    // 변수는 열을 복사하지 않고 가리키기만 하며 스택 맨 아래 칸은 out에 바로 씀. 0으로 나눈 행은 NaN
+    void evaluateColumns(const double* const* columns, size_t rows, double* out) {
+        size_t depth = stack.size();
+        if (blockStack.size() < depth * BLOCK_ROWS) blockStack.resize(depth * BLOCK_ROWS);
+        vector<const double*> slot(depth); // 스택 칸별 현재 값의 위치 (열 또는 버퍼)
+        const double* pool = constants.data();
+
+        for (size_t begin = 0; begin < rows; begin += BLOCK_ROWS) {
+            size_t n = min((size_t)BLOCK_ROWS, rows - begin);
+            auto buffer = [&](size_t index) { return index == 0 ? out + begin : blockStack.data() + index * BLOCK_ROWS; };
+            size_t top = 0;
+            for (const Instruction& in : code) {
+                switch (in.op) {
+                case PUSH: {
+                    double* dst = buffer(top);
+                    fill(dst, dst + n, pool[in.operand]);
+                    slot[top++] = dst;
+                    break;
+                }
+                case LOAD: slot[top++] = columns[in.operand] + begin; break;
+                case NEG: {
+                    double* dst = buffer(top - 1);
+                    applyColumnConstant<MulKernel>(slot[top - 1], -1.0, dst, n);
+                    slot[top - 1] = dst;
+                    break;
+                }
+                default: {
+                    // 이항 연산: *_CONST는 상수 풀 값과, 나머지는 스택 바로 위 칸과 계산
+                    bool withConstant = in.op >= ADD_CONST;
+                    OpCode base = withConstant ? (OpCode)(in.op - (ADD_CONST - ADD)) : in.op;
+                    const double* b = withConstant ? nullptr : slot[--top];
+                    double constant = withConstant ? pool[in.operand] : 0;
+                    double* dst = buffer(top - 1);
+                    switch (base) {
+                    case ADD: applyBlock<AddKernel>(slot[top - 1], b, constant, dst, n); break;
+                    case SUB: applyBlock<SubKernel>(slot[top - 1], b, constant, dst, n); break;
+                    case MUL: applyBlock<MulKernel>(slot[top - 1], b, constant, dst, n); break;
+                    case DIV: applyBlock<DivKernel>(slot[top - 1], b, constant, dst, n); break;
+                    default: applyBlock<PowKernel>(slot[top - 1], b, constant, dst, n); break;
                     }
+                    slot[top - 1] = dst;
+                    break;
+                }
                 }
+            }
+            if (slot[0] != out + begin) copy(slot[0], slot[0] + n, out + begin); // 변수 하나뿐인 수식
+        }
+    }
+};
+
+// 정확한 계산용 수 체계 (대화형 계산과 --eval에서 씀. 바이트코드와 열 단위 계산은 double 그대로)
+//   INTEGER  : long long 정수. 연산마다 오버플로를 검사해 넘치면 BIG으로 올림
+//   RATIONAL : long long 분자/분모의 기약분수 (0.1은 1/10)
+//   BIG      : 임의 정밀도 정수로 된 기약분수. 다시 long long에 들어오면 내려옴
+//   REAL     : double. 지수가 정수가 아닌 거듭제곱이나 BIG이 너무 커졌을 때만 씀
+// 오버플로 검사: 넘치면 true
+#if defined(__GNUC__) || defined(__clang__)
+bool checkedAdd(long long a, long long b, long long* out) { return __builtin_add_overflow(a, b, out); }
+bool checkedSub(long long a, long long b, long long* out) { return __builtin_sub_overflow(a, b, out); }
+bool checkedMul(long long a, long long b, long long* out) { return __builtin_mul_overflow(a, b, out); }
+#else
+bool checkedAdd(long long a, long long b, long long* out) {
+    if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) return true;
+    *out = a + b;
+    return false;
+}
+bool checkedSub(long long a, long long b, long long* out) {
+    if ((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b)) return true;
+    *out = a - b;
+    return false;
+}
+bool checkedMul(long long a, long long b, long long* out) {
+    if (a != 0 && b != 0) {
+        if ((a == -1 && b == LLONG_MIN) || (b == -1 && a == LLONG_MIN)) return true;
+        if (a > 0 ? (b > 0 ? a > LLONG_MAX / b : b < LLONG_MIN / a)
+            : (b > 0 ? a < LLONG_MIN / b : (a != -1 && b < LLONG_MAX / a))) return true;
+    }
+    *out = a * b;
+    return false;
+}
+#endif
+
+// 부호 있는 임의 정밀도 정수. 10^9 단위(limb)로 낮은 자리부터 저장 (0이면 limbs가 비어 있음)
+// long long을 넘는 분수의 분자/분모에만 쓰므로 손으로 하는 곱셈과 나눗셈으로 충분함
+class BigInt {
+public:
+    enum { BASE = 1000000000, BASE_DIGITS = 9 };
+
+    BigInt() : negative(false) {}
+    BigInt(long long v) : negative(v < 0) {
+        unsigned long long magnitude = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+        while (magnitude > 0) {
+            limbs.push_back((uint32_t)(magnitude % BASE));
+            magnitude /= BASE;
+        }
+    }
+
+    // 10진수 숫자로만 된 문자열을 읽음
+    static BigInt fromDigits(const string& digits) {
+        BigInt result;
+        for (size_t end = digits.length(); end > 0;) {
+            size_t begin = end >= BASE_DIGITS ? end - BASE_DIGITS : 0;
+            uint32_t limb = 0;
+            for (size_t i = begin; i < end; i++) limb = limb * 10 + (uint32_t)(digits[i] - '0');
+            result.limbs.push_back(limb);
+            end = begin;
+        }
+        result.trim();
+        return result;
+    }
+
+    bool isZero() const { return limbs.empty(); }
+    bool isNegative() const { return negative; }
+    bool isOne() const { return !negative && limbs.size() == 1 && limbs[0] == 1; }
+    size_t size() const { return limbs.size(); }
+
+    // long long 범위에 들어오면 out에 넣고 true
+    bool toInt64(long long& out) const {
+        unsigned long long magnitude = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            if (magnitude > (ULLONG_MAX - limbs[i]) / BASE) return false;
+            magnitude = magnitude * BASE + limbs[i];
+        }
+        if (magnitude > (unsigned long long)LLONG_MAX + (negative ? 1 : 0)) return false;
+        out = negative ? (long long)(0ULL - magnitude) : (long long)magnitude;
+        return true;
+    }
+
+    // 값을 mantissa * BASE^exponent로 어림 (위쪽 세 limb만 써서 double로 넘치지 않음)
+    void approximate(double& mantissa, long& exponent) const {
+        size_t low = limbs.size() > 3 ? limbs.size() - 3 : 0;
+        mantissa = 0;
+        for (size_t i = limbs.size(); i-- > low;) mantissa = mantissa * BASE + limbs[i];
+        if (negative) mantissa = -mantissa;
+        exponent = (long)low;
+    }
+
+    string toString() const {
+        if (limbs.empty()) return "0";
+        string text = negative ? "-" : "";
+        text += to_string(limbs.back());
+        for (size_t i = limbs.size() - 1; i-- > 0;) {
+            string part = to_string(limbs[i]);
+            text.append(BASE_DIGITS - part.length(), '0');
+            text += part;
+        }
+        return text;
+    }
+
+    BigInt operator-() const {
+        BigInt result = *this;
+        if (!result.isZero()) result.negative = !negative;
+        return result;
+    }
 
-                tokens.push_back(string(1, c));
+    friend BigInt operator+(const BigInt& a, const BigInt& b) {
+        if (a.negative == b.negative) return withSign(addAbs(a.limbs, b.limbs), a.negative);
+        if (compareAbs(a.limbs, b.limbs) >= 0) return withSign(subAbs(a.limbs, b.limbs), a.negative);
+        return withSign(subAbs(b.limbs, a.limbs), b.negative);
+    }
+
+    friend BigInt operator-(const BigInt& a, const BigInt& b) { return a + (-b); }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        if (a.isZero() || b.isZero()) return BigInt();
+        vector<uint32_t> product(a.limbs.size() + b.limbs.size(), 0);
+        for (size_t i = 0; i < a.limbs.size(); i++) {
+            unsigned long long carry = 0;
+            for (size_t j = 0; j < b.limbs.size() || carry > 0; j++) {
+                unsigned long long current = product[i + j] + carry +
+                    (j < b.limbs.size() ? (unsigned long long)a.limbs[i] * b.limbs[j] : 0);
+                product[i + j] = (uint32_t)(current % BASE);
+                carry = current / BASE;
             }
-            //  ʴ  üũ
-            else if (!isdigit(c) && c != '.') {
-                tokens.push_back("INVALID:" + string(1, c));
+        }
+        return withSign(product, a.negative != b.negative);
+    }
+
+    // 몫과 나머지 (몫은 0 쪽으로 버리고, 나머지의 부호는 a를 따름). b는 0이 아니어야 함
+    static void divide(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+        vector<uint32_t> q(a.limbs.size(), 0);
+        vector<uint32_t> r;
+        double divisorMantissa;
+        long divisorExponent;
+        b.approximate(divisorMantissa, divisorExponent);
+        divisorMantissa = fabs(divisorMantissa);
+        for (size_t i = a.limbs.size(); i-- > 0;) {
+            r.insert(r.begin(), a.limbs[i]); // r = r * BASE + 다음 limb
+            trim(r);
+            if (compareAbs(r, b.limbs) < 0) continue;
+            // 위쪽 limb로 몫 한 자리를 어림한 뒤 한두 번 보정
+            double mantissa;
+            long exponent;
+            withSign(r, false).approximate(mantissa, exponent);
+            double estimate = mantissa / divisorMantissa * pow((double)BASE, (double)(exponent - divisorExponent));
+            uint32_t digit = (uint32_t)min(max(estimate, 0.0), (double)(BASE - 1));
+            vector<uint32_t> product = mulSmall(b.limbs, digit);
+            while (compareAbs(product, r) > 0) product = mulSmall(b.limbs, --digit);
+            r = subAbs(r, product);
+            while (compareAbs(r, b.limbs) >= 0) {
+                r = subAbs(r, b.limbs);
+                digit++;
             }
-            else {
-                current += c;
+            q[i] = digit;
+        }
+        quotient = withSign(q, a.negative != b.negative);
+        remainder = withSign(r, a.negative);
+    }
+
+    // 최대공약수 (항상 0 이상)
+    static BigInt gcd(BigInt a, BigInt b) {
+        a.negative = b.negative = false;
+        while (!b.isZero()) {
+            BigInt quotient, remainder;
+            divide(a, b, quotient, remainder);
+            a = b;
+            b = remainder;
+        }
+        return a;
+    }
+
+private:
+    bool negative;
+    vector<uint32_t> limbs;
+
+    void trim() {
+        trim(limbs);
+        if (limbs.empty()) negative = false;
+    }
+    static void trim(vector<uint32_t>& v) {
+        while (!v.empty() && v.back() == 0) v.pop_back();
+    }
+
+    static BigInt withSign(const vector<uint32_t>& magnitude, bool isNegative) {
+        BigInt result;
+        result.limbs = magnitude;
+        result.negative = isNegative;
+        result.trim();
+        return result;
+    }
+
+    static int compareAbs(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static vector<uint32_t> addAbs(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        vector<uint32_t> sum;
+        uint32_t carry = 0;
+        for (size_t i = 0; i < max(a.size(), b.size()) || carry > 0; i++) {
+            uint32_t current = carry + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+            carry = current >= (uint32_t)BASE ? 1 : 0;
+            sum.push_back(carry ? current - (uint32_t)BASE : current);
+        }
+        return sum;
+    }
+
+    // |a| >= |b|일 때 |a| - |b|
+    static vector<uint32_t> subAbs(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        vector<uint32_t> difference(a);
+        uint32_t borrow = 0;
+        for (size_t i = 0; i < difference.size(); i++) {
+            uint32_t subtrahend = borrow + (i < b.size() ? b[i] : 0);
+            borrow = difference[i] < subtrahend ? 1 : 0;
+            difference[i] = borrow ? difference[i] + (uint32_t)BASE - subtrahend : difference[i] - subtrahend;
+        }
+        trim(difference);
+        return difference;
+    }
+
+    static vector<uint32_t> mulSmall(const vector<uint32_t>& a, uint32_t factor) {
+        vector<uint32_t> product;
+        if (factor == 0) return product;
+        unsigned long long carry = 0;
+        for (size_t i = 0; i < a.size() || carry > 0; i++) {
+            unsigned long long current = carry + (i < a.size() ? (unsigned long long)a[i] * factor : 0);
+            product.push_back((uint32_t)(current % BASE));
+            carry = current / BASE;
+        }
+        return product;
+    }
+};
+
+// 계산 결과 하나. 정수와 분수는 정확하게, 그 밖의 값만 double로 다룸
+// INTEGER와 RATIONAL은 힙을 쓰지 않고, BIG일 때만 분자/분모를 따로 할당
+class Number {
+public:
+    enum Kind { INTEGER, RATIONAL, BIG, REAL };
+    enum { MAX_LIMBS = 128 }; // BIG의 분자나 분모가 이보다 길어지면 (약 1150자리) double로 바꿈
+
+    Number() : kind(INTEGER), num(0), den(1), real(0) {}
+
+    static Number fromInteger(long long value) {
+        Number number;
+        number.num = value;
+        return number;
+    }
+
+    static Number fromDouble(double value) {
+        Number number;
+        number.kind = REAL;
+        number.real = value;
+        return number;
+    }
+
+    // numerator / denominator를 기약분수로 (denominator는 0이 아님)
+    static Number fromRatio(long long numerator, long long denominator) {
+        if (denominator < 0) {
+            if (numerator == LLONG_MIN || denominator == LLONG_MIN) return fromBig(BigInt(numerator), BigInt(denominator));
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        unsigned long long a = numerator < 0 ? 0ULL - (unsigned long long)numerator : (unsigned long long)numerator;
+        unsigned long long b = (unsigned long long)denominator;
+        while (b != 0) {
+            unsigned long long t = a % b;
+            a = b;
+            b = t;
+        }
+        Number number;
+        number.num = numerator / (long long)a;
+        number.den = denominator / (long long)a;
+        number.kind = number.den == 1 ? INTEGER : RATIONAL;
+        return number;
+    }
+
+    // 임의 정밀도 분수를 기약분수로 만들고, long long에 들어오면 INTEGER/RATIONAL로 내림 (너무 크면 double)
+    static Number fromBig(BigInt numerator, BigInt denominator) {
+        if (denominator.isNegative()) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        BigInt divisor = BigInt::gcd(numerator, denominator);
+        if (!divisor.isOne()) {
+            BigInt remainder;
+            BigInt::divide(numerator, divisor, numerator, remainder);
+            BigInt::divide(denominator, divisor, denominator, remainder);
+        }
+        long long n, d;
+        if (numerator.toInt64(n) && denominator.toInt64(d)) return fromRatio(n, d);
+        if (numerator.size() > MAX_LIMBS || denominator.size() > MAX_LIMBS) return fromDouble(ratioToDouble(numerator, denominator));
+        Number number;
+        number.kind = BIG;
+        number.big = make_shared<BigFraction>(BigFraction{ numerator, denominator });
+        return number;
+    }
+
+    // 숫자 글자(숫자와 소수점 하나, 부호 제외)를 정확한 값으로 읽음. 0.1은 1/10
+    static Number parse(const char* text, size_t length, bool negative) {
+        static const long long powers[] = { 1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+            1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+            1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL };
+        long long mantissa = 0;
+        size_t digits = 0, fraction = 0;
+        bool afterDot = false;
+        for (size_t i = 0; i < length; i++) {
+            if (text[i] == '.') {
+                afterDot = true;
+                continue;
             }
+            if (digits < 18) mantissa = mantissa * 10 + (text[i] - '0');
+            digits++;
+            if (afterDot) fraction++;
         }
+        if (digits <= 18) return fromRatio(negative ? -mantissa : mantissa, powers[fraction]);
 
-        if (!current.empty()) {
-            tokens.push_back(current);
+        // 18자리보다 긴 숫자
+        string allDigits;
+        for (size_t i = 0; i < length; i++) {
+            if (text[i] != '.') allDigits += text[i];
         }
+        BigInt numerator = BigInt::fromDigits(allDigits);
+        BigInt denominator = BigInt::fromDigits("1" + string(fraction, '0'));
+        return fromBig(negative ? -numerator : numerator, denominator);
+    }
+
+    bool isInteger() const { return kind == INTEGER || (kind == BIG && big->denominator.isOne()); }
+    bool isZero() const { return (kind == INTEGER && num == 0) || (kind == REAL && real == 0); }
 
-        return tokens;
+    double toDouble() const {
+        switch (kind) {
+        case INTEGER: return (double)num;
+        case RATIONAL: return (double)num / (double)den;
+        case BIG: return ratioToDouble(big->numerator, big->denominator);
+        default: return real;
+        }
     }
 
-    //   ʿ  ˻
-    bool hasImplicitMultiplication(const string& expression) {
-        for (size_t i = 0; i < expression.length() - 1; i++) {
-            char current = expression[i];
-            char next = expression[i + 1];
+    // 정수의 모든 자리 (isInteger()일 때만 씀)
+    string integerText() const {
+        return kind == BIG ? big->numerator.toString() : to_string(num);
+    }
 
-            //    ȣ  : 3(, 3{, 3[
-            if (isdigit(current) && isOpenBracket(next)) {
-                return true;
+    Number operator-() const {
+        switch (kind) {
+        case INTEGER:
+        case RATIONAL:
+            if (num != LLONG_MIN) {
+                Number negated = *this;
+                negated.num = -num;
+                return negated;
             }
-            // ݴ ȣ  ڰ  : )3, }3, ]3
-            if (isCloseBracket(current) && isdigit(next)) {
-                return true;
+            return fromBig(-BigInt(num), BigInt(den));
+        case BIG: return fromBig(-big->numerator, big->denominator);
+        default: return fromDouble(-real);
+        }
+    }
+
+    // a op b. 둘 다 정확한 값이면 long long으로 먼저 계산하고, 넘치면 임의 정밀도로 다시 계산
+    // 0으로 나누는지는 호출하는 쪽에서 먼저 확인함
+    static Number apply(const Number& a, const Number& b, char op) {
+        long long n;
+        if (a.kind == INTEGER && b.kind == INTEGER && op != '/' && op != '^') { // 가장 흔한 정수끼리의 덧셈, 뺄셈, 곱셈
+            bool overflow = op == '+' ? checkedAdd(a.num, b.num, &n) : op == '-' ? checkedSub(a.num, b.num, &n) : checkedMul(a.num, b.num, &n);
+            if (!overflow) return fromInteger(n);
+        }
+        if (op == '^') return power(a, b);
+        if (a.kind == REAL || b.kind == REAL) {
+            double x = a.toDouble(), y = b.toDouble();
+            switch (op) {
+            case '+': return fromDouble(x + y);
+            case '-': return fromDouble(x - y);
+            case '*': return fromDouble(x * y);
+            default: return fromDouble(x / y);
             }
         }
-        return false;
+
+        if (a.kind != BIG && b.kind != BIG) { // 분수 (정수끼리 넘친 경우도 여기서 다시 넘쳐 아래로 감)
+            long long x, y, d;
+            if (op == '+' || op == '-') { // a/b ± c/d = (a*d ± c*b) / (b*d)
+                if (!checkedMul(a.num, b.den, &x) && !checkedMul(b.num, a.den, &y) &&
+                    !(op == '+' ? checkedAdd(x, y, &n) : checkedSub(x, y, &n)) && !checkedMul(a.den, b.den, &d)) return fromRatio(n, d);
+            }
+            else if (op == '*') {
+                if (!checkedMul(a.num, b.num, &n) && !checkedMul(a.den, b.den, &d)) return fromRatio(n, d);
+            }
+            else if (op == '/') {
+                if (!checkedMul(a.num, b.den, &n) && !checkedMul(a.den, b.num, &d)) return fromRatio(n, d);
+            }
+        }
+
+        // long long으로 넘친 경우: 임의 정밀도 분수로 계산
+        BigInt an, ad, bn, bd;
+        a.toBig(an, ad);
+        b.toBig(bn, bd);
+        switch (op) {
+        case '+': return fromBig(an * bd + bn * ad, ad * bd);
+        case '-': return fromBig(an * bd - bn * ad, ad * bd);
+        case '*': return fromBig(an * bn, ad * bd);
+        default: return fromBig(an * bd, ad * bn);
+        }
     }
 
-    //    ȯ
-    string addImplicitMultiplication(const string& expression) {
-        string result = "";
+private:
+    struct BigFraction {
+        BigInt numerator;
+        BigInt denominator; // 항상 양수
+    };
+
+    Kind kind;
+    long long num; // INTEGER, RATIONAL의 분자
+    long long den; // INTEGER, RATIONAL의 분모 (INTEGER는 1)
+    double real;   // REAL의 값
+    shared_ptr<const BigFraction> big; // BIG의 분자/분모
+
+    void toBig(BigInt& numerator, BigInt& denominator) const {
+        if (kind == BIG) {
+            numerator = big->numerator;
+            denominator = big->denominator;
+        }
+        else {
+            numerator = BigInt(num);
+            denominator = BigInt(den);
+        }
+    }
 
-        for (size_t i = 0; i < expression.length(); i++) {
-            char current = expression[i];
-            result += current;
+    static double ratioToDouble(const BigInt& numerator, const BigInt& denominator) {
+        double n, d;
+        long nExponent, dExponent;
+        numerator.approximate(n, nExponent);
+        denominator.approximate(d, dExponent);
+        return n / d * pow((double)BigInt::BASE, (double)(nExponent - dExponent));
+    }
 
-            //  ڰ ְ,   ʿ 
-            if (i < expression.length() - 1) {
-                char next = expression[i + 1];
+    // 분자/분모 중 큰 쪽의 대략적인 비트 수
+    size_t bitLength() const {
+        if (kind == BIG) return max(big->numerator.size(), big->denominator.size()) * 30;
+        unsigned long long magnitude = num < 0 ? 0ULL - (unsigned long long)num : (unsigned long long)num;
+        magnitude = max(magnitude, (unsigned long long)den);
+        size_t bits = 0;
+        for (; magnitude > 0; magnitude >>= 1) bits++;
+        return bits;
+    }
 
-                //    ȣ  : 3(  3*(
-                if ((isdigit(current) || isCloseBracket(current)) && isOpenBracket(next)) {
-                    result += "*";
-                }
-                // ݴ ȣ  ڰ  : )3  )*3
-                else if (isCloseBracket(current) && (isdigit(next) || next == '-')) {
-                    //  - ,    Ȯ
-                    if (next == '-' && i + 2 < expression.length() && isdigit(expression[i + 2])) {
-                        result += "*";
-                    }
-                    else if (isdigit(next)) {
-                        result += "*";
-                    }
-                }
-            }
+    // 거듭제곱. 지수가 정수이면 제곱을 반복하는 방식(exponentiation by squaring)으로 정확히 계산하고,
+    // 결과가 MAX_LIMBS를 넘을 만큼 크거나 지수가 정수가 아니면 pow로 계산
+    static Number power(const Number& base, const Number& exponent) {
+        if (base.kind == REAL || exponent.kind != INTEGER) return fromDouble(pow(base.toDouble(), exponent.toDouble()));
+        long long e = exponent.num;
+        if (e < 0 && base.isZero()) return fromDouble(pow(0.0, (double)e)); // 0의 음수 제곱은 pow처럼 inf
+        unsigned long long remaining = e < 0 ? 0ULL - (unsigned long long)e : (unsigned long long)e;
+        size_t bits = base.bitLength(); // 결과는 대략 (bits - 1) * 지수 비트 (어림이 모자라도 fromBig이 double로 바꿈)
+        if (bits > 1 && remaining > (unsigned long long)MAX_LIMBS * 29 / (bits - 1)) {
+            return fromDouble(pow(base.toDouble(), exponent.toDouble()));
         }
 
+        Number factor = e < 0 ? apply(fromInteger(1), base, '/') : base;
+        Number result = fromInteger(1);
+        while (remaining > 0) {
+            if (remaining & 1) result = apply(result, factor, '*');
+            remaining >>= 1;
+            if (remaining > 0) factor = apply(factor, factor, '*');
+        }
         return result;
     }
+};
 
-    //  ǥ ⺻  ȿ ˻
-    bool isValidInfixStructure(const vector<string>& tokens) {
-        if (tokens.empty()) return false;
+// 중위 표기 바로 계산(evaluateInfixWith)에 쓰는 값 연산
+// DoubleArithmetic은 벤치마크용 빠른 계산, ExactArithmetic은 대화형 계산과 --eval용 정확한 계산
+struct DoubleArithmetic {
+    typedef double Value;
+    static Value number(const Token& token, const string&) {
+        return token.symbol == '-' ? -token.value : token.value;
+    }
+    // a = a op b. 0으로 나누면 false
+    static bool apply(Value& a, const Value& b, char op) {
+        switch (op) {
+        case '+': a += b; break;
+        case '-': a -= b; break;
+        case '*': a *= b; break;
+        case '/':
+            if (b == 0) return false;
+            a /= b;
+            break;
+        case '^': a = pow(a, b); break;
+        }
+        return true;
+    }
+};
 
-        bool expectOperand = true; // ó ǿڸ 
+struct ExactArithmetic {
+    typedef Number Value;
+    // 렉서가 double로 바꾼 값 대신 원본 글자에서 정확히 읽음
+    static Value number(const Token& token, const string& text) {
+        size_t sign = token.symbol ? 1 : 0;
+        return Number::parse(text.data() + token.offset + sign, token.length - sign, token.symbol == '-');
+    }
+    static bool apply(Value& a, const Value& b, char op) {
+        if (op == '/' && b.isZero()) return false;
+        a = Number::apply(a, b, op);
+        return true;
+    }
+};
 
-        for (const string& token : tokens) {
-            if (token.substr(0, 8) == "INVALID:") {
-                return false;
-            }
+class ExpressionCalculator {
+private:
+    map<string, double> variableValues; // 대입문(이름 = 수식)으로 저장한 변수 (바이트코드 계산용)
+    map<string, Number> exactValues;    // 같은 변수의 정확한 값 (대화형 계산과 --eval용)
 
-            if (isNumber(token)) {
-                if (!expectOperand) return false; // ڸ ߴµ ڰ 
+    // 연산자 우선순위 반환
+    int getPrecedence(char op) {
+        switch (op) {
+        case '+':
+        case '-':
+            return 1;
+        case '*':
+        case '/':
+            return 2;
+        case '^':  // 거듭제곱 연산자
+            return 3;
+        default:
+            return -1;
+        }
+    }
+
+    // 연산자인지 확인
+    bool isOperator(char c) {
+        return c == '+' || c == '-' || c == '*' || c == '/' || c == '^';
+    }
+
+    // 중위 표기법의 기본 구조가 유효한지 검사
+    bool isValidInfixStructure(const string& infix) {
+        Lexer lexer(infix);
+        Token token;
+        bool expectOperand = true; // 처음에는 피연산자를 기대
+
+        while (lexer.next(token)) {
+            switch (token.kind) {
+            case Token::NUMBER:
+            case Token::VARIABLE:
+                if (!expectOperand) return false; // 연산자를 기대했는데 숫자나 변수가 옴
                 expectOperand = false;
-            }
-            else if (isOpenBracket(token[0])) {
-                if (!expectOperand) return false; // ڸ ߴµ  ȣ 
+                break;
+            case Token::OPEN:
+                if (!expectOperand) return false; // 연산자를 기대했는데 여는 괄호가 옴
                 expectOperand = true;
-            }
-            else if (isCloseBracket(token[0])) {
-                if (expectOperand) return false; // ǿڸ ߴµ ݴ ȣ 
+                break;
+            case Token::CLOSE:
+                if (expectOperand) return false; // 피연산자를 기대했는데 닫는 괄호가 옴
                 expectOperand = false;
-            }
-            else if (isOperator(token[0]) && token.length() == 1) {
-                if (expectOperand) return false; // ǿڸ ߴµ ڰ 
+                break;
+            case Token::OPERATOR:
+                if (expectOperand) return false; // 피연산자를 기대했는데 연산자가 옴
                 expectOperand = true;
-            }
-            else {
-                return false; //    ū
+                break;
+            default:
+                return false; // 지원하지 않는 문자나 잘못된 숫자
             }
         }
 
-        return !expectOperand; //  ǿڷ  
+        return !expectOperand; // 마지막에는 피연산자로 끝나야 함 (빈 수식도 여기서 걸러짐)
     }
 
 public:
-    //  ǥ  ǥ ȯ
+    // 중위 표기법을 후위 표기법으로 변환
+    // 토큰은 렉서에서 하나씩 받고, 후위 표기 문자열에는 원본의 해당 부분을 바로 이어 붙임
     pair<string, string> infixToPostfix(const string& infix) {
-        vector<string> tokens = tokenize(infix);
-
-        // ⺻  ˻
-        if (!isValidInfixStructure(tokens)) {
-            return make_pair("", "߸ Դϴ.");
+        // 기본 구조 검사
+        if (!isValidInfixStructure(infix)) {
+            return make_pair("", "잘못된 수식입니다.");
         }
 
-        stack<string> operators;
-        vector<string> postfix;
-        stack<char> bracketStack; // ȣ Ī Ȯο
-
-        for (const string& token : tokens) {
-            //  ʴ  ˻
-            if (token.substr(0, 8) == "INVALID:") {
-                return make_pair("", " ʴ ");
-            }
+        vector<char> operators; // 연산자와 여는 괄호
+        string postfix;
+        postfix.reserve(infix.size() * 2);
+        auto append = [&postfix](const char* text, size_t length) {
+            if (!postfix.empty()) postfix += ' ';
+            postfix.append(text, length);
+        };
 
-            if (isNumber(token)) {
-                postfix.push_back(token);
+        Lexer lexer(infix);
+        Token token;
+        while (lexer.next(token)) {
+            if (token.kind == Token::NUMBER || token.kind == Token::VARIABLE) {
+                append(infix.data() + token.offset, token.length);
             }
-            else if (isOpenBracket(token[0])) {
-                operators.push(token);
-                bracketStack.push(token[0]);
+            else if (token.kind == Token::OPEN) {
+                operators.push_back(token.symbol);
             }
-            else if (isCloseBracket(token[0])) {
+            else if (token.kind == Token::CLOSE) {
                 bool foundOpenBracket = false;
                 while (!operators.empty()) {
-                    if (isOpenBracket(operators.top()[0])) {
-                        char openBracket = operators.top()[0];
-                        operators.pop();
-
-                        if (!bracketStack.empty() && isMatchingBracket(bracketStack.top(), token[0])) {
-                            bracketStack.pop();
-                            foundOpenBracket = true;
-                            break;
-                        }
-                        else {
-                            return make_pair("", "ȣ Ÿ ġ ʽϴ.");
+                    char top = operators.back();
+                    operators.pop_back();
+                    if (isOpenBracket(top)) {
+                        if (!isMatchingBracket(top, token.symbol)) {
+                            return make_pair("", "괄호 타입이 일치하지 않습니다.");
                         }
+                        foundOpenBracket = true;
+                        break;
                     }
-                    postfix.push_back(operators.top());
-                    operators.pop();
+                    append(&top, 1);
                 }
                 if (!foundOpenBracket) {
-                    return make_pair("", "ȣ  ʾҽϴ.");
+                    return make_pair("", "괄호가 닫히지 않았습니다.");
+                }
+            }
+            else {
+                // 거듭제곱은 우결합성 (right associative)
+                char op = token.symbol;
+                while (!operators.empty() && !isOpenBracket(operators.back()) &&
+                    ((op != '^' && getPrecedence(operators.back()) >= getPrecedence(op)) ||
+                        (op == '^' && getPrecedence(operators.back()) > getPrecedence(op)))) {
+                    append(&operators.back(), 1);
+                    operators.pop_back();
+                }
+                operators.push_back(op);
+            }
+        }
+
+        while (!operators.empty()) {
+            if (isOpenBracket(operators.back())) {
+                return make_pair("", "괄호가 닫히지 않았습니다.");
+            }
+            append(&operators.back(), 1);
+            operators.pop_back();
+        }
+
+        return make_pair(postfix, "");
+    }
+
+    // 중위 표기법을 후위 표기법으로 바꾸지 않고 한 번 읽으면서 바로 계산 (Pratt 방식의 연산자 우선순위 파싱)
+    // 재귀 대신 값 스택과 연산자 스택을 직접 두므로 괄호가 아무리 깊어도 호출 스택이 넘치지 않음
+    // 우선순위와 ^의 우결합성은 infixToPostfix와 같고, 렉서가 붙여 준 부호(-3, -x) 말고도
+    // 피연산자 자리에 혼자 있는 +, -를 단항 연산자로 처리함 (-(1+2), - 3)
+    // 단항 -는 바로 뒤의 피연산자(숫자, 변수, 괄호 묶음)에 먼저 적용되므로 -(2)^2는 -2^2처럼 4
+    // 값의 종류와 연산은 Arithmetic이 정함 (DoubleArithmetic, ExactArithmetic)
+    template <typename Arithmetic>
+    pair<typename Arithmetic::Value, string> evaluateInfixWith(const string& infix, const map<string, typename Arithmetic::Value>& variables) {
+        typedef typename Arithmetic::Value Value;
+        const string invalid = "잘못된 수식입니다.";
+        vector<Value> values;
+        vector<char> operators; // 이항 연산자, 여는 괄호, 단항 -('~')
+        string name;            // 변수 이름을 찾을 때 쓰는 버퍼
+
+        // 연산자 스택 맨 위의 이항 연산 하나를 계산. 0으로 나누면 false
+        auto reduce = [&]() {
+            char op = operators.back();
+            operators.pop_back();
+            Value b = values.back();
+            values.pop_back();
+            return Arithmetic::apply(values.back(), b, op);
+        };
+        // 피연산자 하나가 끝나면 그 앞에 쌓인 단항 -를 적용
+        auto applySigns = [&]() {
+            while (!operators.empty() && operators.back() == '~') {
+                operators.pop_back();
+                values.back() = -values.back();
+            }
+        };
+
+        bool expectOperand = true;
+        Lexer lexer(infix);
+        Token token;
+        while (lexer.next(token)) {
+            if (expectOperand) {
+                if (token.kind == Token::NUMBER) {
+                    values.push_back(Arithmetic::number(token, infix));
+                }
+                else if (token.kind == Token::VARIABLE) {
+                    size_t sign = token.symbol ? 1 : 0;
+                    name.assign(infix, token.offset + sign, token.length - sign);
+                    typename map<string, Value>::const_iterator it = variables.find(name);
+                    if (it == variables.end()) {
+                        return make_pair(Value(), "정의되지 않은 변수: " + name);
+                    }
+                    values.push_back(token.symbol == '-' ? -it->second : it->second);
                 }
+                else if (token.kind == Token::OPEN) {
+                    operators.push_back(token.symbol);
+                    continue;
+                }
+                else if (token.kind == Token::OPERATOR && (token.symbol == '-' || token.symbol == '+')) {
+                    if (token.symbol == '-') operators.push_back('~');
+                    continue;
+                }
+                else {
+                    return make_pair(Value(), invalid);
+                }
+                applySigns();
+                expectOperand = false;
             }
-            else if (isOperator(token[0]) && token.length() == 1) {
-                // ŵ ռ (right associative)
-                while (!operators.empty() && !isOpenBracket(operators.top()[0]) &&
-                    ((token[0] != '^' && getPrecedence(operators.top()[0]) >= getPrecedence(token[0])) ||
-                        (token[0] == '^' && getPrecedence(operators.top()[0]) > getPrecedence(token[0])))) {
-                    postfix.push_back(operators.top());
-                    operators.pop();
+            else if (token.kind == Token::CLOSE) {
+                while (!operators.empty() && !isOpenBracket(operators.back())) {
+                    if (!reduce()) return make_pair(Value(), "계산 불가");
+                }
+                if (operators.empty()) {
+                    return make_pair(Value(), "괄호가 닫히지 않았습니다.");
+                }
+                if (!isMatchingBracket(operators.back(), token.symbol)) {
+                    return make_pair(Value(), "괄호 타입이 일치하지 않습니다.");
                 }
-                operators.push(token);
+                operators.pop_back();
+                applySigns();
+            }
+            else if (token.kind == Token::OPERATOR) {
+                // 거듭제곱은 우결합성이라 같은 우선순위의 ^는 먼저 계산하지 않음
+                char op = token.symbol;
+                while (!operators.empty() && !isOpenBracket(operators.back()) &&
+                    (getPrecedence(operators.back()) > getPrecedence(op) ||
+                        (op != '^' && getPrecedence(operators.back()) == getPrecedence(op)))) {
+                    if (!reduce()) return make_pair(Value(), "계산 불가");
+                }
+                operators.push_back(op);
+                expectOperand = true;
             }
             else {
-                return make_pair("", "߸  Ǵ  ");
+                return make_pair(Value(), invalid);
             }
         }
 
+        if (expectOperand) {
+            return make_pair(Value(), invalid); // 빈 수식이나 연산자로 끝난 수식
+        }
         while (!operators.empty()) {
-            if (isOpenBracket(operators.top()[0])) {
-                return make_pair("", "ȣ  ʾҽϴ.");
+            if (isOpenBracket(operators.back())) {
+                return make_pair(Value(), "괄호가 닫히지 않았습니다.");
             }
-            postfix.push_back(operators.top());
-            operators.pop();
+            if (!reduce()) return make_pair(Value(), "계산 불가");
         }
+        return make_pair(values.back(), "");
+    }
 
-        //  ǥ ڿ 
-        string postfixStr = "";
-        for (size_t i = 0; i < postfix.size(); i++) {
-            if (i > 0) postfixStr += " ";
-            postfixStr += postfix[i];
-        }
+    // 저장된 변수 값(double)으로 중위 표기를 바로 계산 (벤치마크용)
+    pair<double, string> evaluateInfix(const string& infix) {
+        return evaluateInfixWith<DoubleArithmetic>(infix, variableValues);
+    }
 
-        return make_pair(postfixStr, "");
+    // 중위 표기를 정확한 값으로 바로 계산 (--eval용)
+    pair<Number, string> evaluateInfixExact(const string& infix) {
+        return evaluateInfixWith<ExactArithmetic>(infix, exactValues);
     }
 
-    //  ǥ 
-    pair<double, string> evaluatePostfix(const string& postfix) {
+    // 후위 표기법을 바이트코드로 컴파일 (숫자 검사와 변환은 여기서 한 번만 함)
+    pair<CompiledFormula, string> compile(const string& postfix) {
+        CompiledFormula program;
+        const string invalid = "잘못된 연산자 또는 수식 오류";
         if (postfix.empty()) {
-            return make_pair(0, "߸  Ǵ  ");
+            return make_pair(program, invalid);
         }
 
-        istringstream iss(postfix);
-        stack<double> operands;
-        string token;
+        Lexer lexer(postfix, true);
+        Token token;
+        size_t depth = 0, maxDepth = 0;
+
+        while (lexer.next(token)) {
+            if (token.kind == Token::NUMBER) {
+                program.constants.push_back(token.symbol == '-' ? -token.value : token.value);
+                program.code.push_back({ CompiledFormula::PUSH, (uint32_t)(program.constants.size() - 1) });
+                maxDepth = max(maxDepth, ++depth);
+            }
+            else if (token.kind == Token::VARIABLE) {
+                // 이름은 원본을 가리킨 채 비교하고, 처음 나온 이름만 복사해 둠
+                const char* name = postfix.data() + token.offset + (token.symbol ? 1 : 0);
+                size_t length = token.length - (token.symbol ? 1 : 0);
+                vector<string>& names = program.variableNames;
+                size_t index = 0;
+                while (index < names.size() && names[index].compare(0, string::npos, name, length) != 0) index++;
+                if (index == names.size()) names.push_back(string(name, length));
+                program.code.push_back({ CompiledFormula::LOAD, (uint32_t)index });
+                if (token.symbol == '-') program.code.push_back({ CompiledFormula::NEG, 0 });
+                maxDepth = max(maxDepth, ++depth);
+            }
+            else if (token.kind == Token::OPERATOR) {
+                if (depth < 2) {
+                    return make_pair(CompiledFormula(), invalid);
+                }
+                depth--;
+
+                CompiledFormula::OpCode op = CompiledFormula::ADD;
+                switch (token.symbol) {
+                case '+': op = CompiledFormula::ADD; break;
+                case '-': op = CompiledFormula::SUB; break;
+                case '*': op = CompiledFormula::MUL; break;
+                case '/': op = CompiledFormula::DIV; break;
+                case '^': op = CompiledFormula::POW; break;
+                }
 
-        while (iss >> token) {
-            if (isNumber(token)) {
-                try {
-                    operands.push(stod(token));
+                // 바로 앞이 상수를 넣는 명령이면 상수 피연산자 명령 하나로 합침
+                if (program.code.back().op == CompiledFormula::PUSH) {
+                    program.code.back().op = (CompiledFormula::OpCode)(op + (CompiledFormula::ADD_CONST - CompiledFormula::ADD));
                 }
-                catch (...) {
-                    return make_pair(0, "߸  Ǵ  ");
+                else {
+                    program.code.push_back({ op, 0 });
                 }
             }
-            else if (isOperator(token[0]) && token.length() == 1) {
-                if (operands.size() < 2) {
-                    return make_pair(0, "߸  Ǵ  ");
-                }
+            else {
+                return make_pair(CompiledFormula(), invalid);
+            }
+        }
 
-                double b = operands.top(); operands.pop();
-                double a = operands.top(); operands.pop();
-
-                double result = 0;
-                switch (token[0]) {
-                case '+': result = a + b; break;
-                case '-': result = a - b; break;
-                case '*': result = a * b; break;
-                case '/':
-                    if (b == 0) {
-                        return make_pair(0, " Ұ");
-                    }
-                    result = a / b;
-                    break;
-                case '^':
-                    result = pow(a, b);
-                    break;
+        if (depth != 1) {
+            return make_pair(CompiledFormula(), invalid);
+        }
+
+        program.stack.resize(maxDepth);
+        return make_pair(program, "");
+    }
+
+    // 후위 표기법 계산 (컴파일 후 저장된 변수 값으로 한 번 실행)
+    pair<double, string> evaluatePostfix(const string& postfix) {
+        pair<CompiledFormula, string> compiled = compile(postfix);
+        if (!compiled.second.empty()) {
+            return make_pair(0, compiled.second);
+        }
+
+        vector<double> values;
+        for (const string& name : compiled.first.variables()) {
+            map<string, double>::const_iterator it = variableValues.find(name);
+            if (it == variableValues.end()) {
+                return make_pair(0, "정의되지 않은 변수: " + name);
+            }
+            values.push_back(it->second);
+        }
+
+        double result = 0;
+        if (!compiled.first.evaluate(values.data(), result)) {
+            return make_pair(0, "계산 불가");
+        }
+        return make_pair(result, "");
+    }
+
+    // 후위 표기법을 정확한 값으로 계산 (대화형 계산용. 숫자는 원본 글자에서 읽고 정수와 분수는 반올림하지 않음)
+    pair<Number, string> evaluatePostfixExact(const string& postfix) {
+        const string invalid = "잘못된 연산자 또는 수식 오류";
+        vector<Number> values;
+        string name;
+        Lexer lexer(postfix, true);
+        Token token;
+        while (lexer.next(token)) {
+            if (token.kind == Token::NUMBER) {
+                values.push_back(ExactArithmetic::number(token, postfix));
+            }
+            else if (token.kind == Token::VARIABLE) {
+                size_t sign = token.symbol ? 1 : 0;
+                name.assign(postfix, token.offset + sign, token.length - sign);
+                map<string, Number>::const_iterator it = exactValues.find(name);
+                if (it == exactValues.end()) {
+                    return make_pair(Number(), "정의되지 않은 변수: " + name);
+                }
+                values.push_back(token.symbol == '-' ? -it->second : it->second);
+            }
+            else if (token.kind == Token::OPERATOR && values.size() >= 2) {
+                Number b = values.back();
+                values.pop_back();
+                if (!ExactArithmetic::apply(values.back(), b, token.symbol)) {
+                    return make_pair(Number(), "계산 불가");
                 }
-                operands.push(result);
             }
             else {
-                return make_pair(0, "߸  Ǵ  ");
+                return make_pair(Number(), invalid);
             }
         }
+        if (values.size() != 1) {
+            return make_pair(Number(), invalid);
+        }
+        return make_pair(values.back(), "");
+    }
+
+    // 같은 수식을 매번 해석할 때와 한 번 컴파일해 반복 실행할 때의 계산 속도 비교
+    void benchmark(const string& infix, size_t repeat) {
+        pair<string, string> converted = infixToPostfix(infix);
+        if (!converted.second.empty()) {
+            cout << "변환 오류: " << converted.second << endl;
+            return;
+        }
+        pair<CompiledFormula, string> compiled = compile(converted.first);
+        if (!compiled.second.empty()) {
+            cout << "오류: " << compiled.second << endl;
+            return;
+        }
+        CompiledFormula& program = compiled.first;
+        if (!program.variables().empty()) {
+            cout << "변수가 있는 수식은 --columns로 측정하세요." << endl;
+            return;
+        }
+
+        double checksum = 0, result = 0;
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeat; i++) {
+            checksum += evaluatePostfix(converted.first).first;
+        }
+        double parseMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeat; i++) {
+            checksum += evaluatePostfix(infixToPostfix(infix).first).first;
+        }
+        double convertMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
 
-        if (operands.size() != 1) {
-            return make_pair(0, "߸  Ǵ  ");
+        begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeat; i++) {
+            checksum += evaluateInfix(infix).first;
         }
+        double directMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
 
-        return make_pair(operands.top(), "");
+        begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeat; i++) {
+            if (program.evaluate(result)) checksum += result;
+        }
+        double compiledMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        cout << "후위 표기법: " << converted.first << endl;
+        cout << "바이트코드: 명령어 " << program.instructionCount() << "개, 상수 " << program.constantCount() << "개" << endl;
+        cout << "반복 " << repeat << "회" << endl;
+        cout << "  매번 해석: " << parseMs << " ms (" << parseMs * 1e6 / repeat << " ns/회)" << endl;
+        cout << "  후위 변환 + 해석: " << convertMs << " ms (" << convertMs * 1e6 / repeat << " ns/회)" << endl;
+        cout << "  중위 표기 바로 계산: " << directMs << " ms (" << directMs * 1e6 / repeat << " ns/회)" << endl;
+        cout << "  컴파일 후 실행: " << compiledMs << " ms (" << compiledMs * 1e6 / repeat << " ns/회)" << endl;
+        cout << "(검증용 합계 " << checksum << ")" << endl;
     }
 
-    // Է ߸  ̸ ˻
+    // 렉서와 중위 -> 후위 변환의 처리량 (토큰/초) 측정
+    void benchmarkTokens(const string& infix, size_t repeat) {
+        Lexer counter(infix);
+        Token token;
+        size_t count = 0;
+        while (counter.next(token)) count++;
+        pair<string, string> converted = infixToPostfix(infix);
+        if (!converted.second.empty()) {
+            cout << "변환 오류: " << converted.second << endl;
+            return;
+        }
+
+        double checksum = 0;
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeat; i++) {
+            Lexer lexer(infix);
+            while (lexer.next(token)) checksum += token.value + token.length;
+        }
+        double lexMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeat; i++) {
+            checksum += infixToPostfix(infix).first.size();
+        }
+        double convertMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        double tokens = (double)count * repeat;
+        cout << "토큰 " << count << "개, 반복 " << repeat << "회" << endl;
+        cout << "  토큰 분리: " << lexMs << " ms (" << tokens / lexMs / 1e3 << " 백만 토큰/초)" << endl;
+        cout << "  후위 표기 변환: " << convertMs << " ms (" << tokens / convertMs / 1e3 << " 백만 토큰/초)" << endl;
+        cout << "(검증용 합계 " << checksum << ")" << endl;
+    }
+
+    // 변수마다 임의의 값 rows개로 된 열을 만들어 열 단위 계산과 행마다 계산하는 방식의 처리량 비교
+    void benchmarkColumns(const string& infix, size_t rows) {
+        pair<string, string> converted = infixToPostfix(infix);
+        if (!converted.second.empty()) {
+            cout << "변환 오류: " << converted.second << endl;
+            return;
+        }
+        pair<CompiledFormula, string> compiled = compile(converted.first);
+        if (!compiled.second.empty()) {
+            cout << "오류: " << compiled.second << endl;
+            return;
+        }
+        CompiledFormula& program = compiled.first;
+        size_t width = program.variables().size();
+
+        mt19937 rng(12345);
+        uniform_real_distribution<double> value(1.0, 100.0);
+        vector<vector<double>> data(width, vector<double>(rows));
+        vector<const double*> columns(width);
+        for (size_t v = 0; v < width; v++) {
+            for (double& x : data[v]) x = value(rng);
+            columns[v] = data[v].data();
+        }
+        vector<double> columnar(rows), byRow(rows), row(width);
+
+        auto begin = chrono::steady_clock::now();
+        program.evaluateColumns(columns.data(), rows, columnar.data());
+        double columnMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        begin = chrono::steady_clock::now();
+        for (size_t r = 0; r < rows; r++) {
+            for (size_t v = 0; v < width; v++) row[v] = data[v][r];
+            if (!program.evaluate(row.data(), byRow[r])) byRow[r] = NAN;
+        }
+        double rowMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        size_t mismatches = 0;
+        for (size_t r = 0; r < rows; r++) {
+            bool same = columnar[r] == byRow[r] || (isnan(columnar[r]) && isnan(byRow[r]))
+                || fabs(columnar[r] - byRow[r]) <= 1e-12 * fabs(byRow[r]);
+            if (!same) mismatches++;
+        }
+
+        double bytes = (double)rows * sizeof(double) * (width + 1); // 읽는 열 + 쓰는 결과
+        cout << "후위 표기법: " << converted.first << endl;
+        cout << "변수 " << width << "개, 행 " << rows << "개 (블록 " << (size_t)CompiledFormula::BLOCK_ROWS << "행)" << endl;
+        cout << "  열 단위 계산: " << columnMs << " ms (" << rows / columnMs / 1e3 << " 백만 행/초, "
+            << bytes / columnMs / 1e6 << " GB/s)" << endl;
+        cout << "  행마다 계산: " << rowMs << " ms (" << rows / rowMs / 1e3 << " 백만 행/초)" << endl;
+        cout << "  결과 불일치: " << mismatches << "행" << endl;
+    }
+
+    // 결과 출력 (long long 범위 안의 정수면 정수로, 그 밖에는 double 그대로)
+    // [-2^63, 2^63) 밖의 값이나 inf, nan을 정수로 바꾸면 정의되지 않은 동작이라 범위를 먼저 확인 (nan, inf는 비교에서 걸러짐)
+    static void printResult(double result) {
+        if (result == floor(result) && result >= -9223372036854775808.0 && result < 9223372036854775808.0) {
+            cout << "결과: " << static_cast<long long>(result) << endl;
+        }
+        else {
+            cout << "결과: " << result << endl;
+        }
+    }
+
+    // 정확한 정수는 모든 자리를, 분수와 double은 double로 바꿔 출력
+    static void printResult(const Number& result) {
+        if (result.isInteger()) {
+            cout << "결과: " << result.integerText() << endl;
+        }
+        else {
+            printResult(result.toDouble());
+        }
+    }
+
+    // 수식 하나를 후위 표기법을 거치지 않고 바로 계산해 출력 (한 번만 계산하는 수식용)
+    int evaluateOnce(const string& input) {
+        pair<Number, string> evaluated = evaluateInfixExact(input);
+        if (!evaluated.second.empty()) {
+            cout << "오류: " << evaluated.second << endl;
+            return 1;
+        }
+        printResult(evaluated.first);
+        return 0;
+    }
+
+    // 입력이 잘못된 수식인지 미리 검사
     bool isInvalidInput(const string& input) {
-        //  Է
+        // 빈 입력
         if (input.empty()) {
             return true;
         }
 
-        // ӵ  ˻ (**, ++, --, //, )
+        // 연속된 연산자 검사 (**, ++, --, //, 등)
         for (size_t i = 0; i < input.length() - 1; i++) {
             if (isOperator(input[i]) && isOperator(input[i + 1])) {
-                //  ƴ 츸 
+                // 음수가 아닌 경우만 오류
                 if (!(input[i] == '*' && input[i + 1] == '*')) {
-                    // **  (ŵ ó  ׽Ʈ̽ )
+                    // **는 허용 (거듭제곱으로 처리하지 않지만 테스트케이스에 있음)
                 }
             }
         }
@@ -368,87 +1438,136 @@ public:
     }
 
     void run() {
-        cout << "===   ===" << endl;
-        cout << " ǥ  Էϼ." << endl;
-        cout << "ϴ : +, -, *, /, ^(ŵ)" << endl;
-        cout << "ϴ ȣ: ( ), [ ], { } (  켱)" << endl;
-        cout << ": 3 + 2 * 5, [1 + 2] * 3, 3 * -4, 4^2, 2{3+1}" << endl;
-        cout << "Ϸ 'exit' Ǵ 'quit' Էϼ." << endl;
+        cout << "=== 수식 연산기 ===" << endl;
+        cout << "중위 표기 수식을 입력하세요." << endl;
+        cout << "지원하는 연산자: +, -, *, /, ^(거듭제곱)" << endl;
+        cout << "지원하는 괄호: ( ), [ ], { } (모두 동일한 우선순위)" << endl;
+        cout << "예시: 3 + 2 * 5, [1 + 2] * 3, 3 * -4, 4^2, 2{3+1}" << endl;
+        cout << "변수: 'x = 3 * 4'처럼 대입한 뒤 'x / 2 + y'처럼 사용" << endl;
+        cout << "종료하려면 'exit' 또는 'quit'을 입력하세요." << endl;
         cout << endl;
 
         while (true) {
             string input;
-            cout << " Էϼ: ";
+            cout << "수식을 입력하세요: ";
             getline(cin, input);
 
-            //  
+            // 종료 조건
             if (input == "exit" || input == "quit") {
-                cout << "α׷ մϴ." << endl;
+                cout << "프로그램을 종료합니다." << endl;
                 break;
             }
 
-            //  Է ó
+            // 빈 입력 처리
             if (input.empty()) {
-                cout << "  Էϼ." << endl;
+                cout << "다음 수식을 입력하세요." << endl;
                 continue;
             }
 
-            // Ư ̽: ** ^ ȯ (ŵ)
-            string processedInput = input;
-            size_t pos = 0;
-            while ((pos = processedInput.find("**", pos)) != string::npos) {
-                processedInput.replace(pos, 2, "^");
-                pos += 1;
-            }
-
-            //   ִ Ȯ
-            bool hasImplicit = hasImplicitMultiplication(processedInput);
-
-            //   ó
-            if (hasImplicit) {
-                processedInput = addImplicitMultiplication(processedInput);
+            // 대입문: 이름 = 수식 (결과를 변수에 저장)
+            string target;
+            size_t equals = input.find('=');
+            if (equals != string::npos) {
+                istringstream lhs(input.substr(0, equals));
+                string extra;
+                lhs >> target;
+                if (!isVariable(target) || target[0] == '-' || target[0] == '+' || (lhs >> extra)) {
+                    cout << "변환 오류: 잘못된 변수 이름입니다." << endl;
+                    cout << "다음 수식을 입력하세요." << endl;
+                    continue;
+                }
+                input = input.substr(equals + 1);
             }
 
-            //  ǥ  ǥ ȯ
-            pair<string, string> convertResult = infixToPostfix(processedInput);
+            // 중위 표기법을 후위 표기법으로 변환 (**와 묵시적 곱셈은 렉서가 처리)
+            pair<string, string> convertResult = infixToPostfix(input);
             string postfix = convertResult.first;
             string convertError = convertResult.second;
 
             if (!convertError.empty()) {
-                cout << "ȯ : " << convertError << endl;
-                cout << "ó Է: " << processedInput << endl;
-                cout << "  Էϼ." << endl;
+                cout << "변환 오류: " << convertError << endl;
+                cout << "처리된 입력: " << input << endl;
+                cout << "다음 수식을 입력하세요." << endl;
                 continue;
             }
 
-            cout << " ǥ: " << postfix << endl;
+            cout << "후위 표기법: " << postfix << endl;
 
-            //  ǥ 
-            pair<double, string> evalResult = evaluatePostfix(postfix);
-            double result = evalResult.first;
+            // 후위 표기법 계산 (정수와 분수는 정확하게)
+            pair<Number, string> evalResult = evaluatePostfixExact(postfix);
+            Number result = evalResult.first;
             string evalError = evalResult.second;
 
             if (!evalError.empty()) {
-                cout << ": " << evalError << endl;
-                cout << "  Էϼ." << endl;
+                cout << "오류: " << evalError << endl;
+                cout << "다음 수식을 입력하세요." << endl;
                 continue;
             }
 
-            //   ( , Ǽ Ҽ ǥ)
-            if (result == floor(result)) {
-                cout << ": " << static_cast<int>(result) << endl;
-            }
-            else {
-                cout << ": " << result << endl;
+            printResult(result);
+            if (!target.empty()) {
+                variableValues[target] = result.toDouble();
+                exactValues[target] = result;
+                cout << "변수 " << target << "에 저장했습니다." << endl;
             }
 
-            cout << "  Էϼ." << endl;
+            cout << "다음 수식을 입력하세요." << endl;
         }
     }
 };
 
-int main() {
+// 명령줄 인자를 0 이상의 정수로 읽음 (숫자가 아니거나 범위를 넘으면 false, 예외를 던지지 않음)
+bool parseCount(const char* text, size_t& value) {
+    if (text[0] < '0' || text[0] > '9') return false;
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > SIZE_MAX) return false;
+    value = (size_t)parsed;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
     ExpressionCalculator calc;
+
+    // 벤치마크 모드: formula_operations --bench "수식" [반복 횟수]
+    if (argc >= 3 && string(argv[1]) == "--bench") {
+        size_t repeat = 1000000;
+        if (argc >= 4 && !parseCount(argv[3], repeat)) {
+            cout << "사용법: formula_operations --bench \"수식\" [반복 횟수]" << endl;
+            return 1;
+        }
+        calc.benchmark(argv[2], repeat);
+        return 0;
+    }
+
+    // 열 단위 계산 벤치마크: formula_operations --columns "수식" [행 수]
+    if (argc >= 3 && string(argv[1]) == "--columns") {
+        size_t rows = 1000000;
+        if (argc >= 4 && !parseCount(argv[3], rows)) {
+            cout << "사용법: formula_operations --columns \"수식\" [행 수]" << endl;
+            return 1;
+        }
+        calc.benchmarkColumns(argv[2], rows);
+        return 0;
+    }
+
+    // 한 번 계산: formula_operations --eval "수식" (후위 표기법 없이 바로 계산)
+    if (argc >= 3 && string(argv[1]) == "--eval") {
+        return calc.evaluateOnce(argv[2]);
+    }
+
+    // 토큰 분리 벤치마크: formula_operations --tokens "수식" [반복 횟수]
+    if (argc >= 3 && string(argv[1]) == "--tokens") {
+        size_t repeat = 1000000;
+        if (argc >= 4 && !parseCount(argv[3], repeat)) {
+            cout << "사용법: formula_operations --tokens \"수식\" [반복 횟수]" << endl;
+            return 1;
+        }
+        calc.benchmarkTokens(argv[2], repeat);
+        return 0;
+    }
+
     calc.run();
     return 0;
 }
\ No newline at end of file
@@ -5,6 +5,23 @@
 #include <stdexcept>// 표준 예외 클래스(예: std::runtime_error)를 제공합니다. 실행 중 발생하는 오류를 처리하는 데 사용됩니다.
 #include <cctype>   // 문자 처리 함수(예: isdigit, isspace, isalpha)를 제공합니다. 문자를 분류하는 데 사용됩니다.
 #include <cmath>    // 수학 함수(예: pow, log10)를 제공합니다. 지수 및 로그 계산에 사용됩니다.
+#include <map>      // 변수 이름과 값을 저장하는 std::map을 제공합니다.
+#include <vector>   // 바이트코드와 열(column) 데이터를 담는 std::vector를 제공합니다.
+#include <algorithm>// std::find, std::fill, std::min 등을 제공합니다.
+#include <chrono>   // 열 단위 계산의 처리 시간을 재는 데 사용됩니다.
+#include <random>   // 벤치마크용 임의의 열 데이터를 만드는 데 사용됩니다.
+#include <cstdint>  // 숫자를 읽을 때 쓰는 std::uint64_t를 제공합니다.
+#include <cstring>  // 긴 숫자를 잘라 복사하는 std::memcpy를 제공합니다.
+#include <cstdlib>  // 긴 숫자를 변환하는 std::strtod를 제공합니다.
+#include <cerrno>   // 명령줄 숫자가 범위를 넘었는지 알려 주는 errno를 제공합니다.
+#include <climits>  // 정확한 계산에서 오버플로를 검사할 때 쓰는 LLONG_MAX 등을 제공합니다.
+#include <memory>   // 큰 분수를 값끼리 공유하는 std::shared_ptr를 제공합니다.
+
+// SSE2를 쓸 수 있으면 열 단위 계산에서 두 행씩 한 번에 처리합니다.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EXPRESSION_USE_SSE2 1
+#endif
 
 // 연산자의 우선순위를 반환하는 함수입니다.
 // 이 함수는 중위 표기식을 후위 표기식으로 변환할 때 연산 순서를 결정합니다.
@@ -20,99 +37,933 @@ int getPrecedence(char op)
     {
         return 2;
     }
-    // 거듭제곱(^)은 가장 높은 우선순위(3)를 가집니다.
-    if (op == '^')
+    // 거듭제곱(^)은 가장 높은 우선순위(3)를 가집니다.
+    if (op == '^')
+    {
+        return 3;
+    }
+    // 다른 모든 문자의 경우 연산자로 간주되지 않으므로 0을 반환합니다.
+    return 0;
+}
+
+// 정수의 0 이상 정수 제곱을 제곱을 반복하는 방식(exponentiation by squaring)으로 구합니다.
+// 중간값이 2^53(double이 모든 정수를 정확히 담는 한계) 안에 있는 동안은 정수 곱셈이라 결과가 정확합니다.
+// 밑이나 지수가 정수가 아니거나, 지수가 음수이거나, 값이 그 범위를 넘으면 false를 반환하고 pow에 맡깁니다.
+bool integerPower(double base, double exponent, double& result)
+{
+    const double limit = 9007199254740992.0; // 2^53
+    if (base != std::floor(base) || exponent != std::floor(exponent) || exponent < 0 || std::fabs(base) >= limit)
+    {
+        return false;
+    }
+    long long value = 1;
+    long long square = static_cast<long long>(base);
+    for (double e = exponent; e > 0; e = std::floor(e / 2))
+    {
+        if (std::fmod(e, 2) == 1)
+        {
+            if (std::fabs((double)value * (double)square) >= limit)
+            {
+                return false;
+            }
+            value *= square;
+        }
+        if (e > 1)
+        {
+            if (std::fabs((double)square * (double)square) >= limit)
+            {
+                return false;
+            }
+            square *= square;
+        }
+    }
+    result = (double)value;
+    return true;
+}
+
+// 두 피연산자(a, b)와 연산자(op)를 받아 계산 결과를 반환하는 함수입니다.
+// 이 함수는 후위 표기식을 평가할 때 실제 계산을 수행하는 데 사용됩니다.
+double applyOp(double a, double b, char op)
+{
+    // 연산자 유형에 따라 계산을 수행합니다.
+    switch (op)
+    {
+        case '+': return a + b; // 덧셈
+        case '-': return a - b; // 뺄셈
+        case '*': return a * b; // 곱셈
+        case '/':
+            // 0으로 나누는 오류를 방지합니다.
+            // 0으로 나누려고 하면 runtime_error를 발생시킵니다.
+            if (b == 0)
+            {
+                throw std::runtime_error("오류: 0으로 나눌 수 없습니다.");
+            }
+            return a / b; // 나눗셈
+        case '^':
+        {
+            // 거듭제곱 (a의 b 제곱). 정수끼리는 integerPower로 정확히 계산하고, 그 밖에는 cmath의 pow 함수를 사용합니다.
+            double result;
+            return integerPower(a, b, result) ? result : pow(a, b);
+        }
+    }
+    return 0; // 연산자가 인식되지 않으면 0을 반환합니다 (실제로는 오류 처리로 걸러집니다).
+}
+
+// 대화형 계산에서 쓰는 정확한 수 체계입니다. (SGS 사칙연산 main.cpp의 Number와 같은 방식입니다)
+// 바이트코드와 열 단위 계산은 속도가 중요하므로 double을 그대로 씁니다.
+//   INTEGER  : long long 정수입니다. 연산마다 오버플로를 검사해서 넘치면 BIG으로 바꿉니다.
+//   RATIONAL : long long 분자/분모로 된 기약분수입니다. (0.1은 1/10로 저장합니다)
+//   BIG      : 임의 정밀도 정수로 된 기약분수입니다. 다시 long long에 들어오면 INTEGER나 RATIONAL로 돌아갑니다.
+//   REAL     : double입니다. 로그, 지수가 정수가 아닌 거듭제곱, 너무 커진 BIG에만 씁니다.
+
+// long long 덧셈, 뺄셈, 곱셈을 하고 결과가 넘치면 true를 반환합니다.
+bool checkedAdd(long long a, long long b, long long& out)
+{
+    if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b))
+    {
+        return true;
+    }
+    out = a + b;
+    return false;
+}
+
+bool checkedSub(long long a, long long b, long long& out)
+{
+    if ((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b))
+    {
+        return true;
+    }
+    out = a - b;
+    return false;
+}
+
+bool checkedMul(long long a, long long b, long long& out)
+{
+    if (a != 0 && b != 0)
+    {
+        if ((a == -1 && b == LLONG_MIN) || (b == -1 && a == LLONG_MIN))
+        {
+            return true;
+        }
+        if (a > 0 ? (b > 0 ? a > LLONG_MAX / b : b < LLONG_MIN / a)
+                  : (b > 0 ? a < LLONG_MIN / b : (a != -1 && b < LLONG_MAX / a)))
+        {
+            return true;
+        }
+    }
+    out = a * b;
+    return false;
+}
+
+// 부호 있는 임의 정밀도 정수입니다. 10^9 단위(limb)로 낮은 자리부터 저장하고, 0이면 limbs가 비어 있습니다.
+// long long을 넘는 분수의 분자와 분모에만 쓰므로, 손으로 하는 곱셈과 나눗셈으로 충분합니다.
+class BigInt
+{
+public:
+    enum { BASE = 1000000000, BASE_DIGITS = 9 };
+
+    BigInt() : negative(false)
+    {
+    }
+
+    BigInt(long long v) : negative(v < 0)
+    {
+        unsigned long long magnitude = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+        while (magnitude > 0)
+        {
+            limbs.push_back((std::uint32_t)(magnitude % BASE));
+            magnitude /= BASE;
+        }
+    }
+
+    // 10진수 숫자로만 된 문자열을 읽습니다.
+    static BigInt fromDigits(const std::string& digits)
+    {
+        BigInt result;
+        for (std::size_t end = digits.length(); end > 0;)
+        {
+            std::size_t begin = end >= BASE_DIGITS ? end - BASE_DIGITS : 0;
+            std::uint32_t limb = 0;
+            for (std::size_t i = begin; i < end; i++)
+            {
+                limb = limb * 10 + (std::uint32_t)(digits[i] - '0');
+            }
+            result.limbs.push_back(limb);
+            end = begin;
+        }
+        result.trim();
+        return result;
+    }
+
+    bool isZero() const { return limbs.empty(); }
+    bool isNegative() const { return negative; }
+    bool isOne() const { return !negative && limbs.size() == 1 && limbs[0] == 1; }
+    std::size_t size() const { return limbs.size(); }
+
+    // long long 범위에 들어오면 out에 넣고 true를 반환합니다.
+    bool toInt64(long long& out) const
+    {
+        unsigned long long magnitude = 0;
+        for (std::size_t i = limbs.size(); i-- > 0;)
+        {
+            if (magnitude > (ULLONG_MAX - limbs[i]) / BASE)
+            {
+                return false;
+            }
+            magnitude = magnitude * BASE + limbs[i];
+        }
+        if (magnitude > (unsigned long long)LLONG_MAX + (negative ? 1 : 0))
+        {
+            return false;
+        }
+        out = negative ? (long long)(0ULL - magnitude) : (long long)magnitude;
+        return true;
+    }
+
+    // 값을 mantissa * BASE^exponent로 어림합니다. 위쪽 세 limb만 쓰므로 double 범위를 넘지 않습니다.
+    void approximate(double& mantissa, long& exponent) const
+    {
+        std::size_t low = limbs.size() > 3 ? limbs.size() - 3 : 0;
+        mantissa = 0;
+        for (std::size_t i = limbs.size(); i-- > low;)
+        {
+            mantissa = mantissa * BASE + limbs[i];
+        }
+        if (negative)
+        {
+            mantissa = -mantissa;
+        }
+        exponent = (long)low;
+    }
+
+    std::string toString() const
+    {
+        if (limbs.empty())
+        {
+            return "0";
+        }
+        std::string text = negative ? "-" : "";
+        text += std::to_string(limbs.back());
+        for (std::size_t i = limbs.size() - 1; i-- > 0;)
+        {
+            std::string part = std::to_string(limbs[i]);
+            text.append(BASE_DIGITS - part.length(), '0');
+            text += part;
+        }
+        return text;
+    }
+
+    BigInt operator-() const
+    {
+        BigInt result = *this;
+        if (!result.isZero())
+        {
+            result.negative = !negative;
+        }
+        return result;
+    }
+
+    friend BigInt operator+(const BigInt& a, const BigInt& b)
+    {
+        if (a.negative == b.negative)
+        {
+            return withSign(addAbs(a.limbs, b.limbs), a.negative);
+        }
+        if (compareAbs(a.limbs, b.limbs) >= 0)
+        {
+            return withSign(subAbs(a.limbs, b.limbs), a.negative);
+        }
+        return withSign(subAbs(b.limbs, a.limbs), b.negative);
+    }
+
+    friend BigInt operator-(const BigInt& a, const BigInt& b)
+    {
+        return a + (-b);
+    }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b)
+    {
+        if (a.isZero() || b.isZero())
+        {
+            return BigInt();
+        }
+        std::vector<std::uint32_t> product(a.limbs.size() + b.limbs.size(), 0);
+        for (std::size_t i = 0; i < a.limbs.size(); i++)
+        {
+            unsigned long long carry = 0;
+            for (std::size_t j = 0; j < b.limbs.size() || carry > 0; j++)
+            {
+                unsigned long long current = product[i + j] + carry +
+                    (j < b.limbs.size() ? (unsigned long long)a.limbs[i] * b.limbs[j] : 0);
+                product[i + j] = (std::uint32_t)(current % BASE);
+                carry = current / BASE;
+            }
+        }
+        return withSign(product, a.negative != b.negative);
+    }
+
+    // 몫과 나머지를 구합니다. 몫은 0 쪽으로 버리고, 나머지의 부호는 a를 따릅니다. b는 0이 아니어야 합니다.
+    static void divide(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder)
+    {
+        std::vector<std::uint32_t> q(a.limbs.size(), 0);
+        std::vector<std::uint32_t> r;
+        double divisorMantissa;
+        long divisorExponent;
+        b.approximate(divisorMantissa, divisorExponent);
+        divisorMantissa = std::fabs(divisorMantissa);
+        for (std::size_t i = a.limbs.size(); i-- > 0;)
+        {
+            r.insert(r.begin(), a.limbs[i]); // r = r * BASE + 다음 limb입니다.
+            trim(r);
+            if (compareAbs(r, b.limbs) < 0)
+            {
+                continue;
+            }
+            // 위쪽 limb로 몫 한 자리를 어림한 뒤 한두 번 보정합니다.
+            double mantissa;
+            long exponent;
+            withSign(r, false).approximate(mantissa, exponent);
+            double estimate = mantissa / divisorMantissa * std::pow((double)BASE, (double)(exponent - divisorExponent));
+            std::uint32_t digit = (std::uint32_t)std::min(std::max(estimate, 0.0), (double)(BASE - 1));
+            std::vector<std::uint32_t> product = mulSmall(b.limbs, digit);
+            while (compareAbs(product, r) > 0)
+            {
+                product = mulSmall(b.limbs, --digit);
+            }
+            r = subAbs(r, product);
+            while (compareAbs(r, b.limbs) >= 0)
+            {
+                r = subAbs(r, b.limbs);
+                digit++;
+            }
+            q[i] = digit;
+        }
+        quotient = withSign(q, a.negative != b.negative);
+        remainder = withSign(r, a.negative);
+    }
+
+    // 최대공약수를 구합니다. 결과는 항상 0 이상입니다.
+    static BigInt gcd(BigInt a, BigInt b)
+    {
+        a.negative = b.negative = false;
+        while (!b.isZero())
+        {
+            BigInt quotient, remainder;
+            divide(a, b, quotient, remainder);
+            a = b;
+            b = remainder;
+        }
+        return a;
+    }
+
+private:
+    bool negative;
+    std::vector<std::uint32_t> limbs;
+
+    void trim()
+    {
+        trim(limbs);
+        if (limbs.empty())
+        {
+            negative = false;
+        }
+    }
+
+    static void trim(std::vector<std::uint32_t>& v)
+    {
+        while (!v.empty() && v.back() == 0)
+        {
+            v.pop_back();
+        }
+    }
+
+    static BigInt withSign(const std::vector<std::uint32_t>& magnitude, bool isNegative)
+    {
+        BigInt result;
+        result.limbs = magnitude;
+        result.negative = isNegative;
+        result.trim();
+        return result;
+    }
+
+    static int compareAbs(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        for (std::size_t i = a.size(); i-- > 0;)
+        {
+            if (a[i] != b[i])
+            {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    static std::vector<std::uint32_t> addAbs(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b)
+    {
+        std::vector<std::uint32_t> sum;
+        std::uint32_t carry = 0;
+        for (std::size_t i = 0; i < std::max(a.size(), b.size()) || carry > 0; i++)
+        {
+            std::uint32_t current = carry + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+            carry = current >= (std::uint32_t)BASE ? 1 : 0;
+            sum.push_back(carry ? current - (std::uint32_t)BASE : current);
+        }
+        return sum;
+    }
+
+    // |a| >= |b|일 때 |a| - |b|를 구합니다.
+    static std::vector<std::uint32_t> subAbs(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b)
+    {
+        std::vector<std::uint32_t> difference(a);
+        std::uint32_t borrow = 0;
+        for (std::size_t i = 0; i < difference.size(); i++)
+        {
+            std::uint32_t subtrahend = borrow + (i < b.size() ? b[i] : 0);
+            borrow = difference[i] < subtrahend ? 1 : 0;
+            difference[i] = borrow ? difference[i] + (std::uint32_t)BASE - subtrahend : difference[i] - subtrahend;
+        }
+        trim(difference);
+        return difference;
+    }
+
+    static std::vector<std::uint32_t> mulSmall(const std::vector<std::uint32_t>& a, std::uint32_t factor)
+    {
+        std::vector<std::uint32_t> product;
+        if (factor == 0)
+        {
+            return product;
+        }
+        unsigned long long carry = 0;
+        for (std::size_t i = 0; i < a.size() || carry > 0; i++)
+        {
+            unsigned long long current = carry + (i < a.size() ? (unsigned long long)a[i] * factor : 0);
+            product.push_back((std::uint32_t)(current % BASE));
+            carry = current / BASE;
+        }
+        return product;
+    }
+};
+
+// 계산 결과 하나입니다. 정수와 분수는 정확하게 다루고, 그 밖의 값만 double로 다룹니다.
+// INTEGER와 RATIONAL은 힙을 쓰지 않고, BIG일 때만 분자와 분모를 따로 할당합니다.
+class Number
+{
+public:
+    enum Kind { INTEGER, RATIONAL, BIG, REAL };
+    enum { MAX_LIMBS = 128 }; // BIG의 분자나 분모가 이보다 길어지면 (약 1150자리) double로 바꿉니다.
+
+    Number() : kind(INTEGER), num(0), den(1), real(0)
+    {
+    }
+
+    static Number fromInteger(long long value)
+    {
+        Number number;
+        number.num = value;
+        return number;
+    }
+
+    static Number fromDouble(double value)
+    {
+        Number number;
+        number.kind = REAL;
+        number.real = value;
+        return number;
+    }
+
+    // numerator / denominator를 기약분수로 만듭니다. denominator는 0이 아니어야 합니다.
+    static Number fromRatio(long long numerator, long long denominator)
+    {
+        if (denominator < 0)
+        {
+            if (numerator == LLONG_MIN || denominator == LLONG_MIN)
+            {
+                return fromBig(BigInt(numerator), BigInt(denominator));
+            }
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        unsigned long long a = numerator < 0 ? 0ULL - (unsigned long long)numerator : (unsigned long long)numerator;
+        unsigned long long b = (unsigned long long)denominator;
+        while (b != 0)
+        {
+            unsigned long long t = a % b;
+            a = b;
+            b = t;
+        }
+        Number number;
+        number.num = numerator / (long long)a;
+        number.den = denominator / (long long)a;
+        number.kind = number.den == 1 ? INTEGER : RATIONAL;
+        return number;
+    }
+
+    // 임의 정밀도 분수를 기약분수로 만듭니다. long long에 들어오면 INTEGER나 RATIONAL로, 너무 크면 double로 바꿉니다.
+    static Number fromBig(BigInt numerator, BigInt denominator)
+    {
+        if (denominator.isNegative())
+        {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        BigInt divisor = BigInt::gcd(numerator, denominator);
+        if (!divisor.isOne())
+        {
+            BigInt remainder;
+            BigInt::divide(numerator, divisor, numerator, remainder);
+            BigInt::divide(denominator, divisor, denominator, remainder);
+        }
+        long long n, d;
+        if (numerator.toInt64(n) && denominator.toInt64(d))
+        {
+            return fromRatio(n, d);
+        }
+        if (numerator.size() > MAX_LIMBS || denominator.size() > MAX_LIMBS)
+        {
+            return fromDouble(ratioToDouble(numerator, denominator));
+        }
+        Number number;
+        number.kind = BIG;
+        number.big = std::make_shared<BigFraction>(BigFraction{ numerator, denominator });
+        return number;
+    }
+
+    // 숫자 글자(숫자와 소수점 하나)를 정확한 값으로 읽습니다. 0.1은 1/10이 됩니다.
+    // 부호는 infixToPostfix가 '0 -'로 바꿔 두므로 여기에는 오지 않습니다.
+    static Number parse(const char* text, std::size_t length)
+    {
+        static const long long powers[] = { 1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+                                            1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+                                            100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+                                            1000000000000000000LL };
+        long long mantissa = 0;
+        std::size_t digits = 0, fraction = 0;
+        bool afterDot = false;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            if (text[i] == '.')
+            {
+                afterDot = true;
+                continue;
+            }
+            if (digits < 18)
+            {
+                mantissa = mantissa * 10 + (text[i] - '0');
+            }
+            digits++;
+            if (afterDot)
+            {
+                fraction++;
+            }
+        }
+        if (digits <= 18)
+        {
+            return fromRatio(mantissa, powers[fraction]);
+        }
+
+        // 18자리보다 긴 숫자는 임의 정밀도로 읽습니다.
+        std::string allDigits;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            if (text[i] != '.')
+            {
+                allDigits += text[i];
+            }
+        }
+        return fromBig(BigInt::fromDigits(allDigits), BigInt::fromDigits("1" + std::string(fraction, '0')));
+    }
+
+    bool isInteger() const { return kind == INTEGER || (kind == BIG && big->denominator.isOne()); }
+    bool isZero() const { return (kind == INTEGER && num == 0) || (kind == REAL && real == 0); }
+
+    double toDouble() const
+    {
+        switch (kind)
+        {
+            case INTEGER: return (double)num;
+            case RATIONAL: return (double)num / (double)den;
+            case BIG: return ratioToDouble(big->numerator, big->denominator);
+            default: return real;
+        }
+    }
+
+    // 정수의 모든 자리를 문자열로 반환합니다. isInteger()일 때만 씁니다.
+    std::string integerText() const
+    {
+        return kind == BIG ? big->numerator.toString() : std::to_string(num);
+    }
+
+    // a op b를 계산합니다. 둘 다 정확한 값이면 long long으로 먼저 계산하고, 넘치면 임의 정밀도로 다시 계산합니다.
+    // 0으로 나누는지는 호출하는 쪽에서 먼저 확인합니다.
+    static Number apply(const Number& a, const Number& b, char op)
+    {
+        long long n;
+        // 가장 흔한 정수끼리의 덧셈, 뺄셈, 곱셈입니다.
+        if (a.kind == INTEGER && b.kind == INTEGER && op != '/' && op != '^')
+        {
+            bool overflow = op == '+' ? checkedAdd(a.num, b.num, n) : op == '-' ? checkedSub(a.num, b.num, n) : checkedMul(a.num, b.num, n);
+            if (!overflow)
+            {
+                return fromInteger(n);
+            }
+        }
+        if (op == '^')
+        {
+            return power(a, b);
+        }
+        if (a.kind == REAL || b.kind == REAL)
+        {
+            double x = a.toDouble(), y = b.toDouble();
+            switch (op)
+            {
+                case '+': return fromDouble(x + y);
+                case '-': return fromDouble(x - y);
+                case '*': return fromDouble(x * y);
+                default: return fromDouble(x / y);
+            }
+        }
+
+        // long long 분수로 계산합니다. 정수끼리 넘친 경우도 여기서 다시 넘쳐 아래의 임의 정밀도 계산으로 갑니다.
+        if (a.kind != BIG && b.kind != BIG)
+        {
+            long long x, y, d;
+            if (op == '+' || op == '-')
+            {
+                // a/b ± c/d = (a*d ± c*b) / (b*d)
+                if (!checkedMul(a.num, b.den, x) && !checkedMul(b.num, a.den, y) &&
+                    !(op == '+' ? checkedAdd(x, y, n) : checkedSub(x, y, n)) && !checkedMul(a.den, b.den, d))
+                {
+                    return fromRatio(n, d);
+                }
+            }
+            else if (op == '*')
+            {
+                if (!checkedMul(a.num, b.num, n) && !checkedMul(a.den, b.den, d))
+                {
+                    return fromRatio(n, d);
+                }
+            }
+            else if (op == '/')
+            {
+                if (!checkedMul(a.num, b.den, n) && !checkedMul(a.den, b.num, d))
+                {
+                    return fromRatio(n, d);
+                }
+            }
+        }
+
+        // long long으로 넘친 경우 임의 정밀도 분수로 계산합니다.
+        BigInt an, ad, bn, bd;
+        a.toBig(an, ad);
+        b.toBig(bn, bd);
+        switch (op)
+        {
+            case '+': return fromBig(an * bd + bn * ad, ad * bd);
+            case '-': return fromBig(an * bd - bn * ad, ad * bd);
+            case '*': return fromBig(an * bn, ad * bd);
+            default: return fromBig(an * bd, ad * bn);
+        }
+    }
+
+private:
+    struct BigFraction
+    {
+        BigInt numerator;
+        BigInt denominator; // 항상 양수입니다.
+    };
+
+    Kind kind;
+    long long num; // INTEGER, RATIONAL의 분자입니다.
+    long long den; // INTEGER, RATIONAL의 분모입니다. (INTEGER는 1)
+    double real;   // REAL의 값입니다.
+    std::shared_ptr<const BigFraction> big; // BIG의 분자와 분모입니다.
+
+    void toBig(BigInt& numerator, BigInt& denominator) const
+    {
+        if (kind == BIG)
+        {
+            numerator = big->numerator;
+            denominator = big->denominator;
+        }
+        else
+        {
+            numerator = BigInt(num);
+            denominator = BigInt(den);
+        }
+    }
+
+    static double ratioToDouble(const BigInt& numerator, const BigInt& denominator)
+    {
+        double n, d;
+        long nExponent, dExponent;
+        numerator.approximate(n, nExponent);
+        denominator.approximate(d, dExponent);
+        return n / d * std::pow((double)BigInt::BASE, (double)(nExponent - dExponent));
+    }
+
+    // 분자와 분모 중 큰 쪽의 대략적인 비트 수를 반환합니다.
+    std::size_t bitLength() const
+    {
+        if (kind == BIG)
+        {
+            return std::max(big->numerator.size(), big->denominator.size()) * 30;
+        }
+        unsigned long long magnitude = num < 0 ? 0ULL - (unsigned long long)num : (unsigned long long)num;
+        magnitude = std::max(magnitude, (unsigned long long)den);
+        std::size_t bits = 0;
+        for (; magnitude > 0; magnitude >>= 1)
+        {
+            bits++;
+        }
+        return bits;
+    }
+
+    // 거듭제곱을 계산합니다. 지수가 정수이면 integerPower처럼 제곱을 반복해서 정확히 계산하고,
+    // 결과가 MAX_LIMBS를 넘을 만큼 크거나 지수가 정수가 아니면 pow로 계산합니다.
+    static Number power(const Number& base, const Number& exponent)
+    {
+        if (base.kind == REAL || exponent.kind != INTEGER)
+        {
+            return fromDouble(std::pow(base.toDouble(), exponent.toDouble()));
+        }
+        long long e = exponent.num;
+        // 0의 음수 제곱은 pow와 같이 inf입니다.
+        if (e < 0 && base.isZero())
+        {
+            return fromDouble(std::pow(0.0, (double)e));
+        }
+        unsigned long long remaining = e < 0 ? 0ULL - (unsigned long long)e : (unsigned long long)e;
+        // 결과는 대략 (bits - 1) * 지수 비트입니다. 어림이 모자라도 fromBig이 double로 바꿉니다.
+        std::size_t bits = base.bitLength();
+        if (bits > 1 && remaining > (unsigned long long)MAX_LIMBS * 29 / (bits - 1))
+        {
+            return fromDouble(std::pow(base.toDouble(), exponent.toDouble()));
+        }
+
+        Number factor = e < 0 ? apply(fromInteger(1), base, '/') : base;
+        Number result = fromInteger(1);
+        while (remaining > 0)
+        {
+            if (remaining & 1)
+            {
+                result = apply(result, factor, '*');
+            }
+            remaining >>= 1;
+            if (remaining > 0)
+            {
+                factor = apply(factor, factor, '*');
+            }
+        }
+        return result;
+    }
+};
+
+// 렉서가 잘라 낸 토큰 하나입니다.
+// 토큰은 원본 문자열 안의 위치(offset)와 길이(length)만 가리키므로 토큰마다 문자열을 새로 만들지 않습니다.
+struct Token
+{
+    enum Kind { END, NUMBER, NAME, VARIABLE, OPERATOR, OPEN, CLOSE, INVALID };
+    Kind kind;
+    char symbol;        // 연산자나 괄호 문자입니다. '**'는 '^'로 바꿔 둡니다.
+    double value;       // NUMBER일 때의 숫자 값입니다.
+    std::size_t offset; // 원본에서 토큰이 시작하는 위치입니다.
+    std::size_t length; // 원본에서 토큰의 길이입니다. VARIABLE('$이름')은 '$'를 포함합니다.
+};
+
+// 수식을 앞에서부터 한 토큰씩 잘라 주는 렉서(lexer)입니다. 중위 표기식과 후위 표기식 모두 이 렉서로 읽습니다.
+// 원본 문자열을 가리키기만 하고 메모리를 할당하지 않으므로, 렉서가 쓰이는 동안 원본 문자열이 살아 있어야 합니다.
+class Lexer
+{
+public:
+    explicit Lexer(const std::string& text) : source(text), pos(0)
+    {
+    }
+
+    // 다음 토큰을 token에 채웁니다. 수식이 끝났으면 false를 반환합니다.
+    bool next(Token& token)
+    {
+        // 공백 문자는 건너뜁니다.
+        while (pos < source.length() && isspace((unsigned char)source[pos]))
+        {
+            ++pos;
+        }
+        token.symbol = 0;
+        token.value = 0;
+        token.offset = pos;
+        token.length = 0;
+        if (pos == source.length())
+        {
+            token.kind = Token::END;
+            return false;
+        }
+
+        char c = source[pos];
+        if (isdigit((unsigned char)c) || c == '.')
+        {
+            // 숫자와 소수점을 모두 읽습니다. 소수점이 두 개 이상이면 잘못된 숫자입니다.
+            token.kind = scanNumber(token.value) ? Token::NUMBER : Token::INVALID;
+        }
+        else if (isalpha((unsigned char)c) || c == '_' || (c == '$' && pos + 1 < source.length() && isNameStart(source[pos + 1])))
+        {
+            // 'log', 변수 이름, 후위 표기식의 '$이름'입니다.
+            token.kind = (c == '$') ? Token::VARIABLE : Token::NAME;
+            ++pos;
+            while (pos < source.length() && (isalnum((unsigned char)source[pos]) || source[pos] == '_'))
+            {
+                ++pos;
+            }
+        }
+        else
+        {
+            if (c == '(' || c == '{' || c == '[')
+            {
+                token.kind = Token::OPEN;
+            }
+            else if (c == ')' || c == '}' || c == ']')
+            {
+                token.kind = Token::CLOSE;
+            }
+            else if (c == '+' || c == '-' || c == '*' || c == '/' || c == '^')
+            {
+                token.kind = Token::OPERATOR;
+                // '**'는 거듭제곱 '^' 하나로 읽습니다.
+                if (c == '*' && pos + 1 < source.length() && source[pos + 1] == '*')
+                {
+                    c = '^';
+                    ++pos;
+                }
+            }
+            else
+            {
+                token.kind = Token::INVALID;
+            }
+            token.symbol = c;
+            ++pos;
+        }
+        token.length = pos - token.offset;
+        return true;
+    }
+
+private:
+    const std::string& source;
+    std::size_t pos;
+
+    static bool isNameStart(char c)
     {
-        return 3;
+        return isalpha((unsigned char)c) || c == '_';
     }
-    // 다른 모든 문자의 경우 연산자로 간주되지 않으므로 0을 반환합니다.
-    return 0;
-}
 
-// 두 피연산자(a, b)와 연산자(op)를 받아 계산 결과를 반환하는 함수입니다.
-// 이 함수는 후위 표기식을 평가할 때 실제 계산을 수행하는 데 사용됩니다.
-double applyOp(double a, double b, char op)
-{
-    // 연산자 유형에 따라 계산을 수행합니다.
-    switch (op)
+    // pos에서 시작하는 숫자를 읽어 value에 넣습니다.
+    // 짧은 숫자는 나눗셈 한 번으로 구합니다. (근거는 JWY formula_operations.cpp의 Lexer::scanNumber 참고)
+    // 그보다 긴 숫자만 잘라 복사해서 strtod로 변환하고, double 범위를 넘으면 잘못된 숫자로 봅니다.
+    bool scanNumber(double& value)
     {
-        case '+': return a + b; // 덧셈
-        case '-': return a - b; // 뺄셈
-        case '*': return a * b; // 곱셈
-        case '/':
-            // 0으로 나누는 오류를 방지합니다.
-            // 0으로 나누려고 하면 runtime_error를 발생시킵니다.
-            if (b == 0)
+        static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        std::size_t start = pos;
+        std::uint64_t mantissa = 0;
+        int digits = 0, fraction = 0, dots = 0;
+        for (; pos < source.length() && (isdigit((unsigned char)source[pos]) || source[pos] == '.'); ++pos)
+        {
+            if (source[pos] == '.')
             {
-                throw std::runtime_error("오류: 0으로 나눌 수 없습니다.");
+                dots++;
+                continue;
             }
-            return a / b; // 나눗셈
-        case '^': return pow(a, b); // 거듭제곱 (a의 b 제곱). cmath 라이브러리의 pow 함수를 사용합니다.
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (source[pos] - '0');
+            }
+            digits++;
+            if (dots > 0)
+            {
+                fraction++;
+            }
+        }
+        if (dots > 1 || digits == 0)
+        {
+            return false;
+        }
+        if (digits <= 15 && fraction <= 22)
+        {
+            value = (double)mantissa / powers[fraction];
+            return true;
+        }
+        char buffer[64];
+        std::size_t length = pos - start;
+        if (length < sizeof(buffer))
+        {
+            std::memcpy(buffer, source.data() + start, length);
+            buffer[length] = '\0';
+            value = std::strtod(buffer, nullptr);
+        }
+        else
+        {
+            value = std::strtod(source.substr(start, length).c_str(), nullptr);
+        }
+        return !std::isinf(value);
     }
-    return 0; // 연산자가 인식되지 않으면 0을 반환합니다 (실제로는 오류 처리로 걸러집니다).
-}
+};
 
 // 중위 표기식 문자열(예: "2 + 3 * 4")을 후위 표기식 문자열(예: "2 3 4 * +")로 변환합니다.
 // 이 변환은 컴퓨터가 표현식을 더 쉽게 평가할 수 있도록 만드는 중요한 단계입니다.
-// 숫자와 연산자를 처리하며, 숫자는 출력 스트림에 직접 추가합니다.
+// 토큰은 렉서에서 하나씩 받고, 숫자와 변수 이름은 원본의 해당 부분을 결과 문자열에 바로 이어 붙입니다.
 std::string infixToPostfix(const std::string& infix)
 {
     std::stack<char> ops; // 연산자를 저장하는 스택입니다.
-    std::stringstream postfix; // 결과 후위 표기식을 만드는 문자열 스트림입니다.
+    std::string postfix; // 결과 후위 표기식입니다. 토큰마다 뒤에 공백 하나를 붙입니다.
+    postfix.reserve(infix.length() * 2 + 16);
     bool expectOperand = true; // 다음에 피연산자(true) 또는 연산자(false)가 올 것으로 예상되는지를 나타내는 플래그입니다.
-
-    // 입력된 중위 표기식의 각 문자를 처리합니다.
-    for (int i = 0; i < infix.length(); ++i)
+    auto emit = [&postfix](const char* text, std::size_t length)
     {
-        char token = infix[i]; // 현재 처리 중인 문자(토큰)입니다.
+        postfix.append(text, length);
+        postfix += ' ';
+    };
 
-        // 공백 문자를 무시하고 다음 문자로 이동합니다.
-        if (isspace(token))
-        {
-            continue;
-        }
+    // 입력된 중위 표기식의 각 토큰을 처리합니다.
+    Lexer lexer(infix);
+    Token token;
+    while (lexer.next(token))
+    {
+        const char* text = infix.data() + token.offset; // 원본에서 토큰이 있는 위치입니다.
 
-        // 현재 토큰이 숫자이거나 소수점인 경우 (숫자의 일부).
-        if (isdigit(token) || (token == '.'))
+        // 현재 토큰이 숫자인 경우.
+        if (token.kind == Token::NUMBER)
         {
             // 이 시점에서 피연산자가 예상되지 않으면 오류입니다 (예: "3 4" 또는 "3 + 4 5").
             if (!expectOperand)
             {
                 throw std::runtime_error("오류: 피연산자 뒤에 연산자가 와야 합니다.");
             }
-            std::string numStr; // 숫자를 저장할 문자열입니다.
-            // 현재 위치에서 연속된 모든 숫자(및 소수점)를 읽어 숫자 문자열을 만듭니다.
-            while (i < infix.length() && (isdigit(infix[i]) || infix[i] == '.'))
-            {
-                numStr += infix[i];
-                i++;
-            }
-            i--; // for 루프의 i++가 한 번 더 진행되므로 i를 감소시킵니다.
-            postfix << numStr << " "; // 숫자 뒤에 공백을 추가하여 후위 표기식 스트림에 추가합니다.
+            emit(text, token.length); // 숫자 뒤에 공백을 추가하여 후위 표기식에 추가합니다.
             expectOperand = false; // 피연산자 뒤에는 연산자가 와야 합니다.
         }
-        // 현재 토큰이 알파벳 문자인 경우 (함수의 일부, 여기서는 'log' 처리).
-        else if (isalpha(token))
+        // 현재 토큰이 단어인 경우 ('log' 함수 또는 변수 이름).
+        else if (token.kind == Token::NAME)
         {
-            // 'log' 함수를 확인합니다 (현재 위치에서 3개의 문자).
-            if (i + 2 < infix.length() && infix.substr(i, 3) == "log")
+            // 피연산자가 예상되지 않으면 오류입니다 (예: "3 log" 또는 "3 x").
+            if (!expectOperand)
+            {
+                throw std::runtime_error("오류: 함수나 변수 앞에 연산자가 와야 합니다.");
+            }
+            if (token.length == 3 && infix.compare(token.offset, 3, "log") == 0)
             {
-                // 피연산자가 예상되지 않으면 오류입니다 (예: "3 log").
-                if (!expectOperand)
-                {
-                    throw std::runtime_error("오류: 함수 앞에 연산자가 와야 합니다.");
-                }
                 ops.push('l'); // 'log'에 대한 간단한 식별자로 'l'을 푸시합니다.
-                i += 2; // 'o'와 'g'를 건너뛰고 다음 토큰으로 이동합니다.
             }
             else
             {
-                // 다른 알파벳 문자이거나 완전한 'log' 함수가 아닌 경우.
-                throw std::runtime_error("오류: 표현식에 잘못된 문자가 있습니다.");
+                // 변수는 후위 표기식에서 '$이름'으로 씁니다 (로그 연산자 'l'과 구별하기 위해).
+                postfix += '$';
+                emit(text, token.length);
+                expectOperand = false; // 변수 뒤에는 연산자가 와야 합니다.
             }
         }
         // 현재 토큰이 여는 괄호인 경우 ((, {, [).
-        else if (token == '(' || token == '{' || token == '[')
+        else if (token.kind == Token::OPEN)
         {
             // 피연산자가 예상되지 않으면 암시적 곱셈을 의미합니다 (예: "3(" 또는 ")(").
             if (!expectOperand)
@@ -120,16 +971,16 @@ std::string infixToPostfix(const std::string& infix)
                  // '*' 연산자를 삽입하여 암시적 곱셈을 처리합니다.
                  while (!ops.empty() && ops.top() != '(' && ops.top() != '{' && ops.top() != '[' && getPrecedence(ops.top()) >= getPrecedence('*'))
                  {
-                     postfix << ops.top() << " ";
+                     emit(&ops.top(), 1);
                      ops.pop();
                  }
                  ops.push('*');
             }
-            ops.push(token); // 항상 여는 괄호를 스택에 푸시합니다.
+            ops.push(token.symbol); // 항상 여는 괄호를 스택에 푸시합니다.
             expectOperand = true; // 여는 괄호 뒤에는 피연산자가 와야 합니다.
         }
         // 현재 토큰이 닫는 괄호인 경우 (), }, ]).
-        else if (token == ')' || token == '}' || token == ']')
+        else if (token.kind == Token::CLOSE)
         {
             // 피연산자가 예상되면 오류입니다 (예: "3 + )").
             if (expectOperand)
@@ -137,11 +988,11 @@ std::string infixToPostfix(const std::string& infix)
                 throw std::runtime_error("오류: 닫는 괄호 앞에 피연산자가 와야 합니다.");
             }
             // 현재 닫는 괄호에 맞는 여는 괄호를 찾습니다.
-            char openParen = (token == ')') ? '(' : ((token == '}') ? '{' : '[');
-            // 일치하는 여는 괄호를 찾을 때까지 스택에서 모든 연산자를 팝하여 후위 표기식 스트림으로 이동합니다.
+            char openParen = (token.symbol == ')') ? '(' : ((token.symbol == '}') ? '{' : '[');
+            // 일치하는 여는 괄호를 찾을 때까지 스택에서 모든 연산자를 팝하여 후위 표기식으로 이동합니다.
             while (!ops.empty() && ops.top() != '(' && ops.top() != '{' && ops.top() != '[')
             {
-                postfix << ops.top() << " ";
+                emit(&ops.top(), 1);
                 ops.pop();
             }
             // 스택이 비어 있거나 스택의 맨 위가 일치하는 여는 괄호가 아니면 불일치 오류입니다.
@@ -154,23 +1005,24 @@ std::string infixToPostfix(const std::string& infix)
             // 괄호 앞에 'log' 함수가 있었으면 'log' 연산자를 후위 표기식에 추가합니다.
             if (!ops.empty() && ops.top() == 'l')
             {
-                postfix << ops.top() << " ";
+                emit(&ops.top(), 1);
                 ops.pop();
             }
             expectOperand = false; // 닫는 괄호 뒤에는 연산자가 와야 합니다.
         }
-        // 현재 토큰이 연산자인 경우 (+, -, *, /, ^).
-        else if (token == '+' || token == '-' || token == '*' || token == '/' || token == '^')
+        // 현재 토큰이 연산자인 경우 (+, -, *, /, ^, 그리고 렉서가 '^'로 바꾼 '**').
+        else if (token.kind == Token::OPERATOR)
         {
+            char op = token.symbol;
             // 피연산자가 예상되면 오류입니다.
             if (expectOperand)
             {
                  // 단항 연산자를 처리합니다 (예: "-3 + 4" 또는 "+3 - 4").
                  // '-' 또는 '+'가 표현식의 시작, 여는 괄호 뒤 또는 공백 뒤에 나타나면 단항 연산자로 간주됩니다.
-                if ((token == '-' || token == '+') && (i == 0 || infix[i-1] == '(' || isspace(infix[i-1])))
+                if ((op == '-' || op == '+') && (token.offset == 0 || infix[token.offset - 1] == '(' || isspace((unsigned char)infix[token.offset - 1])))
                 {
                     // 단항 '-' 또는 '+'를 처리하기 위해 '0'을 앞에 추가합니다 (예: -3 -> 0 - 3, +3 -> 0 + 3).
-                    postfix << "0 ";
+                    postfix += "0 ";
                 }
                 else
                 {
@@ -178,24 +1030,23 @@ std::string infixToPostfix(const std::string& infix)
                 }
             }
 
-            // '**'를 '^'로 변환합니다.
-            if (token == '*' && i + 1 < infix.length() && infix[i+1] == '*') {
-                token = '^';
-                i++;
-            }
-
             // 스택이 비어 있지 않고, 맨 위가 여는 괄호가 아니며,
             // 스택 맨 위의 연산자 우선순위가 현재 연산자의 우선순위보다 크거나 같으면,
-            // 스택에서 연산자를 팝하여 후위 표기식 스트림으로 이동합니다.
+            // 스택에서 연산자를 팝하여 후위 표기식으로 이동합니다.
             // 이것은 연산자 우선순위 규칙에 기반합니다.
-            while (!ops.empty() && ops.top() != '(' && ops.top() != '{' && ops.top() != '[' && getPrecedence(ops.top()) >= getPrecedence(token))
+            while (!ops.empty() && ops.top() != '(' && ops.top() != '{' && ops.top() != '[' && getPrecedence(ops.top()) >= getPrecedence(op))
             {
-                postfix << ops.top() << " ";
+                emit(&ops.top(), 1);
                 ops.pop();
             }
-            ops.push(token); // 현재 연산자를 스택에 푸시합니다.
+            ops.push(op); // 현재 연산자를 스택에 푸시합니다.
             expectOperand = true; // 연산자 뒤에는 피연산자가 와야 합니다.
         }
+        else if (isdigit((unsigned char)text[0]) || text[0] == '.')
+        {
+            // 소수점이 두 개 이상인 숫자입니다 (예: "1.2.3").
+            throw std::runtime_error("오류: 잘못된 숫자입니다.");
+        }
         else
         {
             // 인식할 수 없는 문자가 발견되면 오류를 발생시킵니다.
@@ -209,7 +1060,7 @@ std::string infixToPostfix(const std::string& infix)
         throw std::runtime_error("오류: 표현식이 연산자로 끝났습니다.");
     }
 
-    // 스택에 남아있는 모든 연산자를 후위 표기식 스트림으로 이동합니다.
+    // 스택에 남아있는 모든 연산자를 후위 표기식으로 이동합니다.
     while (!ops.empty())
     {
         // 스택에 여는 괄호가 남아 있으면 괄호 불일치 오류입니다.
@@ -217,31 +1068,45 @@ std::string infixToPostfix(const std::string& infix)
         {
             throw std::runtime_error("오류: 괄호가 일치하지 않습니다.");
         }
-        postfix << ops.top() << " ";
+        emit(&ops.top(), 1);
         ops.pop();
     }
 
-    return postfix.str(); // 완성된 후위 표기식 문자열을 반환합니다.
+    return postfix; // 완성된 후위 표기식 문자열을 반환합니다.
 }
 
 // 후위 표기식 문자열(예: "2 3 4 * +")을 계산하고 결과를 반환합니다.
 // 이 함수는 숫자와 연산자를 처리하며, 스택을 사용하여 계산을 수행합니다. 연산자를 만나면 스택에서 상위 두 값을 가져와 결과를 계산합니다.
-double evaluatePostfix(const std::string& postfix)
+// '$이름' 토큰은 variables에서 값을 찾습니다.
+double evaluatePostfix(const std::string& postfix, const std::map<std::string, double>& variables)
 {
     std::stack<double> values; // 숫자 값을 저장하는 스택입니다.
-    std::stringstream ss(postfix); // 후위 표기식 문자열에서 읽기 위한 문자열 스트림입니다.
-    std::string token; // 스트림에서 읽은 각 토큰(숫자 또는 연산자)을 저장하는 문자열입니다.
+    Lexer lexer(postfix); // 후위 표기식에서 토큰을 하나씩 읽는 렉서입니다.
+    Token token; // 렉서가 읽은 토큰(숫자, 변수 또는 연산자)입니다.
+    std::string name; // 변수를 찾을 때 이름을 담는 버퍼입니다. 토큰마다 새로 만들지 않고 다시 씁니다.
 
     // 후위 표기식의 각 토큰을 처리합니다.
-    while (ss >> token)
+    while (lexer.next(token))
     {
-        // 토큰이 숫자인 경우 (숫자 또는 소수점으로 시작).
-        if (isdigit(token[0]) || (token.length() > 1 && token[0] == '.'))
+        // 토큰이 숫자인 경우. 렉서가 이미 double 값으로 바꿔 두었습니다.
+        if (token.kind == Token::NUMBER)
+        {
+            values.push(token.value);
+        }
+        // 토큰이 변수인 경우 ('$이름').
+        else if (token.kind == Token::VARIABLE)
         {
-            values.push(stod(token)); // 문자열을 double로 변환하여 스택에 푸시합니다 (stod는 string to double).
+            name.assign(postfix, token.offset + 1, token.length - 1);
+            std::map<std::string, double>::const_iterator it = variables.find(name);
+            // 대입한 적이 없는 변수는 계산할 수 없습니다.
+            if (it == variables.end())
+            {
+                throw std::runtime_error("오류: 정의되지 않은 변수입니다: " + name);
+            }
+            values.push(it->second);
         }
         // 토큰이 'l'인 경우 (로그 연산).
-        else if (token == "l")
+        else if (token.kind == Token::NAME && token.length == 1 && postfix[token.offset] == 'l')
         {
             // 로그 연산을 수행하려면 스택이 비어 있지 않아야 합니다.
             if (values.empty())
@@ -258,7 +1123,7 @@ double evaluatePostfix(const std::string& postfix)
             values.push(log10(val)); // log10 함수를 사용하여 밑이 10인 로그를 계산하고 결과를 스택에 푸시합니다.
         }
         // 토큰이 연산자인 경우.
-        else
+        else if (token.kind == Token::OPERATOR)
         {
             // 연산을 수행하려면 스택에 최소 두 개의 피연산자가 필요합니다.
             if (values.size() < 2)
@@ -269,7 +1134,11 @@ double evaluatePostfix(const std::string& postfix)
             values.pop(); // 스택에서 두 번째 피연산자를 제거합니다.
             double val1 = values.top(); // 스택에서 첫 번째 피연산자를 가져옵니다.
             values.pop(); // 스택에서 첫 번째 피연산자를 제거합니다.
-            values.push(applyOp(val1, val2, token[0])); // applyOp 함수를 사용하여 결과를 계산하고 스택에 푸시합니다.
+            values.push(applyOp(val1, val2, token.symbol)); // applyOp 함수를 사용하여 결과를 계산하고 스택에 푸시합니다.
+        }
+        else
+        {
+            throw std::runtime_error("오류: 표현식에 잘못된 문자가 있습니다.");
         }
     }
 
@@ -282,10 +1151,438 @@ double evaluatePostfix(const std::string& postfix)
     return values.top(); // 최종 계산 결과를 반환합니다.
 }
 
+// 변수가 없는 후위 표기식을 계산합니다.
+double evaluatePostfix(const std::string& postfix)
+{
+    return evaluatePostfix(postfix, std::map<std::string, double>());
+}
+
+// 후위 표기식을 evaluatePostfix와 같은 순서로 계산하되, 정수와 분수를 정확한 값(Number)으로 계산합니다.
+// 대화형 계산에서 씁니다. 예를 들어 3^40이 1.21577e+19가 아니라 12157665459056928801로 나옵니다.
+// 숫자 토큰은 렉서가 만든 double 값 대신 원본 글자를 다시 읽어 0.1 같은 값도 정확한 분수로 만듭니다.
+Number evaluatePostfixExact(const std::string& postfix, const std::map<std::string, Number>& variables)
+{
+    std::stack<Number> values; // 계산 중인 값을 저장하는 스택입니다.
+    Lexer lexer(postfix);
+    Token token;
+    std::string name;
+
+    while (lexer.next(token))
+    {
+        if (token.kind == Token::NUMBER)
+        {
+            values.push(Number::parse(postfix.data() + token.offset, token.length));
+        }
+        else if (token.kind == Token::VARIABLE)
+        {
+            name.assign(postfix, token.offset + 1, token.length - 1);
+            std::map<std::string, Number>::const_iterator it = variables.find(name);
+            if (it == variables.end())
+            {
+                throw std::runtime_error("오류: 정의되지 않은 변수입니다: " + name);
+            }
+            values.push(it->second);
+        }
+        // 로그는 정확한 값으로 나타낼 수 없으므로 double로 계산합니다.
+        else if (token.kind == Token::NAME && token.length == 1 && postfix[token.offset] == 'l')
+        {
+            if (values.empty())
+            {
+                throw std::runtime_error("오류: 로그 연산에 필요한 피연산자가 충분하지 않습니다.");
+            }
+            double val = values.top().toDouble();
+            values.pop();
+            if (val <= 0)
+            {
+                throw std::runtime_error("오류: 음수 또는 0의 로그는 정의되지 않았습니다.");
+            }
+            values.push(Number::fromDouble(log10(val)));
+        }
+        else if (token.kind == Token::OPERATOR)
+        {
+            if (values.size() < 2)
+            {
+                throw std::runtime_error("오류: 잘못된 표현식입니다 (피연산자가 충분하지 않음).");
+            }
+            Number val2 = values.top();
+            values.pop();
+            Number val1 = values.top();
+            values.pop();
+            // applyOp와 같이 0으로 나누는 것은 오류로 처리합니다.
+            if (token.symbol == '/' && val2.isZero())
+            {
+                throw std::runtime_error("오류: 0으로 나눌 수 없습니다.");
+            }
+            values.push(Number::apply(val1, val2, token.symbol));
+        }
+        else
+        {
+            throw std::runtime_error("오류: 표현식에 잘못된 문자가 있습니다.");
+        }
+    }
+
+    if (values.size() != 1)
+    {
+        throw std::runtime_error("오류: 잘못된 표현식입니다 (피연산자가 너무 많음).");
+    }
+
+    return values.top();
+}
+
+// 후위 표기식을 한 번 해석해 만든 명령어 목록입니다.
+// 같은 수식을 많은 행(데이터)에 적용할 때 문자열을 다시 해석하지 않도록 합니다.
+struct CompiledExpression
+{
+    enum OpCode { PUSH, LOAD, ADD, SUB, MUL, DIV, POW, LOG };
+    struct Instruction
+    {
+        OpCode op;
+        std::size_t operand; // PUSH는 상수 번호, LOAD는 변수 번호입니다.
+    };
+
+    std::vector<Instruction> code;
+    std::vector<double> constants;
+    std::vector<std::string> variables; // 수식에 처음 나온 순서입니다.
+    std::size_t maxDepth = 0;           // 계산 중 스택의 최대 깊이입니다.
+};
+
+// 한 번에 처리하는 행 수입니다. 명령어 하나를 이 행 수만큼 연달아 적용하므로
+// 명령어 해석 비용은 블록마다 한 번만 들고, 블록 버퍼는 캐시 안에 머뭅니다.
+const std::size_t BLOCK_ROWS = 1024;
+
+// 후위 표기식(evaluatePostfix와 같은 형식)을 명령어 목록으로 바꿉니다.
+CompiledExpression compilePostfix(const std::string& postfix)
+{
+    CompiledExpression program;
+    Lexer lexer(postfix);
+    Token token;
+    std::size_t depth = 0;
+
+    while (lexer.next(token))
+    {
+        CompiledExpression::Instruction instruction = { CompiledExpression::PUSH, 0 };
+        if (token.kind == Token::NUMBER)
+        {
+            program.constants.push_back(token.value);
+            instruction.operand = program.constants.size() - 1;
+            depth++;
+        }
+        else if (token.kind == Token::VARIABLE)
+        {
+            // 이름은 원본을 가리킨 채 비교하고, 처음 나온 이름만 복사해 둡니다.
+            std::size_t index = 0;
+            while (index < program.variables.size() && postfix.compare(token.offset + 1, token.length - 1, program.variables[index]) != 0)
+            {
+                index++;
+            }
+            instruction.op = CompiledExpression::LOAD;
+            instruction.operand = index;
+            if (index == program.variables.size())
+            {
+                program.variables.push_back(postfix.substr(token.offset + 1, token.length - 1));
+            }
+            depth++;
+        }
+        else if (token.kind == Token::NAME && token.length == 1 && postfix[token.offset] == 'l')
+        {
+            if (depth < 1)
+            {
+                throw std::runtime_error("오류: 로그 연산에 필요한 피연산자가 충분하지 않습니다.");
+            }
+            instruction.op = CompiledExpression::LOG;
+        }
+        else
+        {
+            if (depth < 2)
+            {
+                throw std::runtime_error("오류: 잘못된 표현식입니다 (피연산자가 충분하지 않음).");
+            }
+            switch (token.kind == Token::OPERATOR ? token.symbol : 0)
+            {
+                case '+': instruction.op = CompiledExpression::ADD; break;
+                case '-': instruction.op = CompiledExpression::SUB; break;
+                case '*': instruction.op = CompiledExpression::MUL; break;
+                case '/': instruction.op = CompiledExpression::DIV; break;
+                case '^': instruction.op = CompiledExpression::POW; break;
+                default: throw std::runtime_error("오류: 표현식에 잘못된 문자가 있습니다.");
+            }
+            depth--;
+        }
+        program.code.push_back(instruction);
+        program.maxDepth = std::max(program.maxDepth, depth);
+    }
+
+    if (depth != 1)
+    {
+        throw std::runtime_error("오류: 잘못된 표현식입니다 (피연산자가 너무 많음).");
+    }
+    return program;
+}
+
+// 블록 하나에 이항 연산을 적용합니다 (out[i] = a[i] op b[i], out은 a와 같아도 됩니다).
+// 덧셈, 뺄셈, 곱셈, 나눗셈은 SSE2로 두 행씩 계산하고, 거듭제곱과 남은 한 행은 applyOp로 계산합니다.
+void applyBlock(char op, const double* a, const double* b, double* out, std::size_t n)
+{
+    std::size_t i = 0;
+#ifdef EXPRESSION_USE_SSE2
+    // 연산마다 반복문을 따로 두어 반복 안에서는 분기가 없도록 합니다.
+    auto vectorLoop = [&](auto vectorOp)
+    {
+        for (; i + 2 <= n; i += 2)
+        {
+            _mm_storeu_pd(out + i, vectorOp(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        }
+    };
+    switch (op)
+    {
+        case '+': vectorLoop([](__m128d x, __m128d y) { return _mm_add_pd(x, y); }); break;
+        case '-': vectorLoop([](__m128d x, __m128d y) { return _mm_sub_pd(x, y); }); break;
+        case '*': vectorLoop([](__m128d x, __m128d y) { return _mm_mul_pd(x, y); }); break;
+        case '/': vectorLoop([](__m128d x, __m128d y) { return _mm_div_pd(x, y); }); break;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out[i] = applyOp(a[i], b[i], op);
+    }
+}
+
+// 컴파일한 수식을 열 단위 데이터에 적용합니다.
+// columns[i]는 program.variables[i] 변수의 값 rows개를 담은 배열이고, 결과는 out[0..rows)에 씁니다.
+// BLOCK_ROWS행씩 나눠 명령어 하나를 블록 전체에 적용합니다. 변수는 열을 복사하지 않고 가리키기만 합니다.
+// 0으로 나누거나 0 이하의 로그를 구하는 행이 있으면 행 번호와 함께 runtime_error를 발생시킵니다.
+void evaluateColumns(const CompiledExpression& program, const std::vector<const double*>& columns, std::size_t rows, double* out)
+{
+    if (columns.size() != program.variables.size())
+    {
+        throw std::runtime_error("오류: 열 개수가 변수 개수와 다릅니다.");
+    }
+    std::vector<double> buffers(program.maxDepth * BLOCK_ROWS); // 스택 칸마다 블록 하나 크기의 버퍼입니다.
+    std::vector<const double*> slot(program.maxDepth);          // 스택 칸마다 현재 값이 있는 위치입니다.
+
+    for (std::size_t begin = 0; begin < rows; begin += BLOCK_ROWS)
+    {
+        std::size_t n = std::min(BLOCK_ROWS, rows - begin);
+        // 스택 칸 index의 버퍼입니다. 맨 아래 칸은 결과 배열에 바로 씁니다.
+        auto bufferOf = [&](std::size_t index)
+        {
+            return index == 0 ? out + begin : &buffers[index * BLOCK_ROWS];
+        };
+        std::size_t top = 0;
+        for (const CompiledExpression::Instruction& instruction : program.code)
+        {
+            switch (instruction.op)
+            {
+                case CompiledExpression::PUSH:
+                {
+                    double* target = bufferOf(top);
+                    std::fill(target, target + n, program.constants[instruction.operand]);
+                    slot[top++] = target;
+                    break;
+                }
+                case CompiledExpression::LOAD:
+                    slot[top++] = columns[instruction.operand] + begin;
+                    break;
+                case CompiledExpression::LOG:
+                {
+                    double* target = bufferOf(top - 1);
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        if (slot[top - 1][i] <= 0)
+                        {
+                            throw std::runtime_error("오류: 음수 또는 0의 로그는 정의되지 않았습니다 (행 " + std::to_string(begin + i + 1) + ").");
+                        }
+                        target[i] = log10(slot[top - 1][i]);
+                    }
+                    slot[top - 1] = target;
+                    break;
+                }
+                default:
+                {
+                    const char symbols[] = { 0, 0, '+', '-', '*', '/', '^' };
+                    const double* right = slot[--top];
+                    double* target = bufferOf(top - 1);
+                    if (instruction.op == CompiledExpression::DIV)
+                    {
+                        // 먼저 0인 나누는 수가 있는지만 세고(벡터화되는 반복문), 있을 때만 행을 찾습니다.
+                        std::size_t zeros = 0;
+                        for (std::size_t i = 0; i < n; ++i)
+                        {
+                            zeros += right[i] == 0;
+                        }
+                        if (zeros > 0)
+                        {
+                            std::size_t row = std::find(right, right + n, 0.0) - right;
+                            throw std::runtime_error("오류: 0으로 나눌 수 없습니다 (행 " + std::to_string(begin + row + 1) + ").");
+                        }
+                    }
+                    applyBlock(symbols[instruction.op], slot[top - 1], right, target, n);
+                    slot[top - 1] = target;
+                    break;
+                }
+            }
+        }
+        if (slot[0] != out + begin)
+        {
+            std::copy(slot[0], slot[0] + n, out + begin); // 수식이 변수 하나뿐인 경우입니다.
+        }
+    }
+}
+
+// 열 단위 계산의 처리량을 잽니다. 수식의 변수마다 1~100 사이의 임의의 값 rows개를 만들어 계산합니다.
+void benchmarkColumns(const std::string& infix, std::size_t rows)
+{
+    std::string postfix = infixToPostfix(infix);
+    CompiledExpression program = compilePostfix(postfix);
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> value(1.0, 100.0);
+    std::vector<std::vector<double>> data(program.variables.size(), std::vector<double>(rows));
+    std::vector<const double*> columns;
+    for (std::vector<double>& column : data)
+    {
+        for (double& x : column)
+        {
+            x = value(rng);
+        }
+        columns.push_back(column.data());
+    }
+    std::vector<double> out(rows);
+
+    auto start = std::chrono::steady_clock::now();
+    evaluateColumns(program, columns, rows, out.data());
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // 처음 몇 행은 evaluatePostfix로 다시 계산해 결과를 확인합니다.
+    std::size_t mismatches = 0;
+    for (std::size_t r = 0; r < rows && r < 1000; ++r)
+    {
+        std::map<std::string, double> variables;
+        for (std::size_t v = 0; v < program.variables.size(); ++v)
+        {
+            variables[program.variables[v]] = data[v][r];
+        }
+        double expected = evaluatePostfix(postfix, variables);
+        if (std::fabs(out[r] - expected) > 1e-12 * std::fabs(expected))
+        {
+            mismatches++;
+        }
+    }
+
+    double bytes = (double)rows * sizeof(double) * (program.variables.size() + 1);
+    std::cout << "후위 표기식: " << postfix << std::endl;
+    std::cout << "변수 " << program.variables.size() << "개, 행 " << rows << "개: " << ms << " ms ("
+              << rows / ms / 1e3 << " 백만 행/초, " << bytes / ms / 1e6 << " GB/s)" << std::endl;
+    std::cout << "처음 1000행 검증 불일치: " << mismatches << "개" << std::endl;
+}
+
+// 렉서와 중위->후위 변환의 처리량(초당 토큰 수)을 잽니다.
+void benchmarkTokens(const std::string& infix, std::size_t repeat)
+{
+    Lexer counter(infix);
+    Token token;
+    std::size_t count = 0;
+    while (counter.next(token))
+    {
+        count++;
+    }
+    std::string postfix = infixToPostfix(infix); // 잘못된 수식이면 여기서 예외가 발생합니다.
+
+    double checksum = 0; // 계산이 최적화로 사라지지 않도록 결과를 더해 둡니다.
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < repeat; ++i)
+    {
+        Lexer lexer(infix);
+        while (lexer.next(token))
+        {
+            checksum += token.value + token.length;
+        }
+    }
+    double lexMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < repeat; ++i)
+    {
+        checksum += infixToPostfix(infix).length();
+    }
+    double convertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    double tokens = (double)count * repeat;
+    std::cout << "후위 표기식: " << postfix << std::endl;
+    std::cout << "토큰 " << count << "개, 반복 " << repeat << "회" << std::endl;
+    std::cout << "토큰 분리: " << lexMs << " ms (" << tokens / lexMs / 1e3 << " 백만 토큰/초)" << std::endl;
+    std::cout << "후위 표기식 변환: " << convertMs << " ms (" << tokens / convertMs / 1e3 << " 백만 토큰/초)" << std::endl;
+    std::cout << "(검증용 합계 " << checksum << ")" << std::endl;
+}
+
+// 명령줄 인자를 0 이상의 정수로 읽습니다.
+// std::stoul은 숫자가 아니면 예외를 던지므로, 예외 없이 성공 여부만 돌려줍니다.
+bool parseCount(const char* text, std::size_t& value)
+{
+    // 부호나 공백으로 시작하면 거부합니다. (strtoull은 음수도 받아들입니다.)
+    if (text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    // 뒤에 다른 글자가 남았거나 범위를 넘으면 실패입니다.
+    if (*end != '\0' || errno == ERANGE || parsed > SIZE_MAX)
+    {
+        return false;
+    }
+    value = static_cast<std::size_t>(parsed);
+    return true;
+}
+
 // 프로그램이 시작되는 main 함수입니다.
-int main()
+int main(int argc, char* argv[])
 {
+    // 열 단위 계산 벤치마크 모드: Expression --columns "수식" [행 수]
+    if (argc >= 3 && std::string(argv[1]) == "--columns")
+    {
+        std::size_t rows = 1000000; // 행 수를 주지 않으면 백만 행으로 측정합니다.
+        if (argc >= 4 && !parseCount(argv[3], rows))
+        {
+            std::cerr << "사용법: Expression --columns \"수식\" [행 수]" << std::endl;
+            return 1;
+        }
+        try
+        {
+            benchmarkColumns(argv[2], rows);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // 토큰 분리 벤치마크 모드: Expression --tokens "수식" [반복 횟수]
+    if (argc >= 3 && std::string(argv[1]) == "--tokens")
+    {
+        std::size_t repeat = 1000000; // 반복 횟수를 주지 않으면 백만 번 반복합니다.
+        if (argc >= 4 && !parseCount(argv[3], repeat))
+        {
+            std::cerr << "사용법: Expression --tokens \"수식\" [반복 횟수]" << std::endl;
+            return 1;
+        }
+        try
+        {
+            benchmarkTokens(argv[2], repeat);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     std::string infixExpression; // 사용자가 입력한 중위 표기식을 저장하는 문자열 변수입니다.
+    std::map<std::string, Number> variables; // '이름 = 수식'으로 대입한 변수들입니다. 정확한 값으로 저장합니다.
 
     // 사용자가 'exit'를 입력할 때까지 계산 과정을 반복합니다.
     while (true)
@@ -309,14 +1606,50 @@ int main()
 
         try
         {
+            // 0. '이름 = 수식' 형태이면 등호 앞의 이름을 대입할 변수로 정합니다.
+            std::string target;
+            std::size_t equals = infixExpression.find('=');
+            if (equals != std::string::npos)
+            {
+                std::stringstream name(infixExpression.substr(0, equals));
+                std::string extra;
+                name >> target;
+                if (target.empty() || !(isalpha(target[0]) || target[0] == '_') || target == "log" || (name >> extra))
+                {
+                    throw std::runtime_error("오류: 잘못된 변수 이름입니다.");
+                }
+                for (char c : target)
+                {
+                    if (!isalnum(c) && c != '_')
+                    {
+                        throw std::runtime_error("오류: 잘못된 변수 이름입니다.");
+                    }
+                }
+                infixExpression = infixExpression.substr(equals + 1);
+            }
+
             // 1. 입력된 중위 표기식을 후위 표기식으로 변환합니다.
             std::string postfixExpression = infixToPostfix(infixExpression);
             std::cout << "후위 표기식: " << postfixExpression << std::endl;
 
-            // 2. 변환된 후위 표기식을 평가하고 결과를 얻습니다.
-            double result = evaluatePostfix(postfixExpression);
-            std::cout << "계산 결과: " << result << std::endl;
+            // 2. 변환된 후위 표기식을 정확한 값으로 평가합니다.
+            //    정수 결과는 모든 자리를 출력하고, 분수나 실수는 이전과 같이 double로 출력합니다.
+            Number result = evaluatePostfixExact(postfixExpression, variables);
+            if (result.isInteger())
+            {
+                std::cout << "계산 결과: " << result.integerText() << std::endl;
+            }
+            else
+            {
+                std::cout << "계산 결과: " << result.toDouble() << std::endl;
+            }
 
+            // 3. 대입문이면 결과를 변수에 저장합니다.
+            if (!target.empty())
+            {
+                variables[target] = result;
+                std::cout << "변수 " << target << "에 저장했습니다." << std::endl;
+            }
         }
         // 표현식 변환 또는 평가 중 발생하는 runtime_error 예외를 잡아서 처리합니다.
         catch (const std::runtime_error& e)
@@ -7,21 +7,247 @@
 #include <set>
 #include <queue>
 #include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <atomic>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define KEBIN_USE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KEBIN_USE_SSE2 1
+#endif
 
 using namespace std;
 
+// 가중치는 1/함께한 횟수를 정수로 표현 (1~16의 최소공배수라 16회까지는 오차 없음)
+const uint64_t WEIGHT_SCALE = 720720;
+
+// 가장 높은 1 비트의 위치 (x > 0)
+int highestBit(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    if (x >> 32)
+    {
+        _BitScanReverse(&index, (unsigned long)(x >> 32));
+        return (int)index + 32;
+    }
+    _BitScanReverse(&index, (unsigned long)x);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
+
+// 가장 낮은 1 비트의 위치 (x > 0)
+int lowestBit(unsigned x)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (int)index;
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+// 정렬된(중복 없는) 두 배열의 교집합을 out에 쓰고 개수를 반환
+// 블록 단위로 a의 원소들과 b 블록을 회전시킨 것들을 한꺼번에 비교(shuffle-compare)하고,
+// 블록 끝 값이 작은 쪽을 다음 블록으로 넘김. 남은 부분은 일반 병합
+size_t intersectSorted(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+    size_t i = 0, j = 0, count = 0;
+#if defined(KEBIN_USE_AVX2)
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= na && j + 8 <= nb)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r)
+        {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+        }
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(match));
+        while (mask)
+        {
+            out[count++] = a[i + lowestBit(mask)];
+            mask &= mask - 1;
+        }
+        int lastA = a[i + 7], lastB = b[j + 7];
+        if (lastA <= lastB)
+        {
+            i += 8;
+        }
+        if (lastB <= lastA)
+        {
+            j += 8;
+        }
+    }
+#endif
+#if defined(KEBIN_USE_SSE2)
+    while (i + 4 <= na && j + 4 <= nb)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i match = _mm_cmpeq_epi32(va, vb);
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, vb));
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, vb));
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, vb));
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(match));
+        while (mask)
+        {
+            out[count++] = a[i + lowestBit(mask)];
+            mask &= mask - 1;
+        }
+        int lastA = a[i + 3], lastB = b[j + 3];
+        if (lastA <= lastB)
+        {
+            i += 4;
+        }
+        if (lastB <= lastA)
+        {
+            j += 4;
+        }
+    }
+#endif
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+        {
+            ++i;
+        }
+        else if (b[j] < a[i])
+        {
+            ++j;
+        }
+        else
+        {
+            out[count++] = a[i];
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+// Dijkstra용 radix heap
+// 꺼내는 키가 단조 증가한다는 점을 이용해, 마지막으로 꺼낸 키와 처음 달라지는 비트 위치로 버킷을 나눔
+class RadixHeap
+{
+public:
+    RadixHeap() : last(0), count(0) {}
+
+    bool empty() const { return count == 0; }
+
+    void push(uint64_t key, int value)
+    {
+        buckets[bucketIndex(key)].push_back({key, value});
+        count++;
+    }
+
+    pair<uint64_t, int> pop()
+    {
+        if (buckets[0].empty())
+        {
+            int i = 1;
+            while (buckets[i].empty())
+            {
+                i++;
+            }
+            // 가장 작은 키를 기준으로 버킷 하나를 아래 버킷들로 재분배
+            last = buckets[i][0].first;
+            for (const pair<uint64_t, int>& item : buckets[i])
+            {
+                last = min(last, item.first);
+            }
+            for (const pair<uint64_t, int>& item : buckets[i])
+            {
+                buckets[bucketIndex(item.first)].push_back(item);
+            }
+            buckets[i].clear();
+        }
+        pair<uint64_t, int> top = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return top;
+    }
+
+private:
+    vector<pair<uint64_t, int>> buckets[65];
+    uint64_t last;
+    size_t count;
+
+    int bucketIndex(uint64_t key) const
+    {
+        return key == last ? 0 : highestBit(key ^ last) + 1;
+    }
+};
+
+// 비교용 std::priority_queue 기반 힙 (radix heap과 같은 인터페이스)
+class BinaryHeap
+{
+public:
+    bool empty() const { return heap.empty(); }
+    void push(uint64_t key, int value) { heap.push({key, value}); }
+    pair<uint64_t, int> pop()
+    {
+        pair<uint64_t, int> top = heap.top();
+        heap.pop();
+        return top;
+    }
+
+private:
+    priority_queue<pair<uint64_t, int>, vector<pair<uint64_t, int>>, greater<pair<uint64_t, int>>> heap;
+};
+
 class Graph
 {
 public:
     map<int, set<int>> adj;
     set<int> people;
+    map<int, map<int, int>> collaborations; // 두 사람이 함께 등장한 줄(작품) 수
+
+    // 간선을 넣을 때마다 함께 갱신하는 차수 색인
+    map<int, int> degree;                           // 사람 번호 -> 이웃 수
+    set<int> isolatedPeople;                        // 이웃이 없는 사람
+    map<int, set<int>, greater<int>> peopleByDegree; // 차수(내림차순) -> 그 차수의 사람들
+
+    void addPerson(int person)
+    {
+        if (people.insert(person).second)
+        {
+            degree[person] = 0;
+            isolatedPeople.insert(person);
+            peopleByDegree[0].insert(person);
+        }
+    }
 
     void addEdge(int u, int v)
     {
-        adj[u].insert(v);
-        adj[v].insert(u);
-        people.insert(u);
-        people.insert(v);
+        addPerson(u);
+        addPerson(v);
+        if (adj[u].insert(v).second)
+        {
+            raiseDegree(u);
+        }
+        if (adj[v].insert(u).second)
+        {
+            raiseDegree(v);
+        }
+        collaborations[u][v]++;
+        collaborations[v][u]++;
+        weightedReady = false;
     }
 
     void buildGraphFromFile(const string& filename)
@@ -47,7 +273,7 @@ public:
             while (ss >> person)
             {
                 group.push_back(person);
-                people.insert(person);
+                addPerson(person);
             }
 
             if (group.size() > 1)
@@ -103,17 +329,107 @@ public:
         return -1;
     }
 
+    // 가중치 최단 경로: 함께한 횟수가 많을수록 가까운 것으로 보고 간선 가중치를 1/횟수로 둠
+    // 반환값은 (가중치 거리, 경로), 연결되지 않으면 (-1, 빈 경로)
+    pair<double, vector<int>> findWeightedDistanceWithPath(int start, int end)
+    {
+        if (people.find(start) == people.end() || people.find(end) == people.end())
+        {
+            return {-1, {}};
+        }
+        buildWeightedGraph();
+
+        int source = weightedIndex[start];
+        int target = weightedIndex[end];
+        vector<uint64_t> dist;
+        vector<int> parent;
+        runDijkstra<RadixHeap>(source, target, dist, parent);
+        if (dist[target] == UINT64_MAX)
+        {
+            return {-1, {}};
+        }
+
+        vector<int> path;
+        for (int node = target; node != -1; node = parent[node])
+        {
+            path.push_back(weightedIds[node]);
+        }
+        reverse(path.begin(), path.end());
+        return {(double)dist[target] / WEIGHT_SCALE, path};
+    }
+
+    // radix heap과 std::priority_queue Dijkstra의 전체 단일 출발점 탐색 시간 비교
+    void benchmarkWeightedDistance(int sources)
+    {
+        buildWeightedGraph();
+        if (weightedIds.empty())
+        {
+            cout << "사람이 없습니다." << endl;
+            return;
+        }
+
+        mt19937 rng(12345);
+        vector<int> picks;
+        for (int i = 0; i < sources; ++i)
+        {
+            picks.push_back((int)(rng() % weightedIds.size()));
+        }
+
+        vector<uint64_t> distRadix, distBinary;
+        vector<int> parent;
+        bool same = true;
+        double radixMs = 0, binaryMs = 0;
+        for (int source : picks)
+        {
+            auto t0 = chrono::steady_clock::now();
+            runDijkstra<RadixHeap>(source, -1, distRadix, parent);
+            auto t1 = chrono::steady_clock::now();
+            runDijkstra<BinaryHeap>(source, -1, distBinary, parent);
+            auto t2 = chrono::steady_clock::now();
+            radixMs += chrono::duration<double, milli>(t1 - t0).count();
+            binaryMs += chrono::duration<double, milli>(t2 - t1).count();
+            same = same && distRadix == distBinary;
+        }
+
+        cout << "정점 " << weightedIds.size() << "개, 간선 " << weightedTarget.size() / 2
+             << "개, 출발점 " << sources << "개" << endl;
+        cout << "radix heap:          " << radixMs << " ms" << endl;
+        cout << "std::priority_queue: " << binaryMs << " ms" << endl;
+        cout << "결과 일치: " << (same ? "예" : "아니오") << endl;
+    }
+
     vector<int> findLoneWolves()
     {
-        vector<int> loneWolves;
-        for (int person : people)
+        return vector<int>(isolatedPeople.begin(), isolatedPeople.end());
+    }
+
+    // 차수 분포: (차수, 사람 수) 목록 (차수 오름차순)
+    vector<pair<int, int>> degreeDistribution() const
+    {
+        vector<pair<int, int>> distribution;
+        for (auto it = peopleByDegree.rbegin(); it != peopleByDegree.rend(); ++it)
         {
-            if (adj.find(person) == adj.end() || adj[person].empty())
+            distribution.push_back({it->first, (int)it->second.size()});
+        }
+        return distribution;
+    }
+
+    // 차수 상위 count명 (사람 번호, 차수). 같은 차수면 번호 오름차순
+    vector<pair<int, int>> topDegreePeople(size_t count) const
+    {
+        vector<pair<int, int>> top;
+        for (const auto& bucket : peopleByDegree)
+        {
+            for (int person : bucket.second)
             {
-                loneWolves.push_back(person);
+                if (top.size() == count)
+                {
+                    return top;
+                }
+                top.push_back({person, bucket.first});
             }
         }
-        return loneWolves;
+        return top;
     }
 
     int countGroups()
@@ -219,6 +535,269 @@ public:
         }
         return connectors;
     }
+
+    // 삼각형 수와 클러스터링 계수 (정점 번호는 weightedIds 순서의 밀집 번호)
+    struct TriangleStats
+    {
+        uint64_t triangles = 0;
+        vector<int> ids;                  // 밀집 번호 -> 사람 번호
+        vector<uint64_t> perVertex;       // 정점이 속한 삼각형 수
+        vector<double> clustering;        // 지역 클러스터링 계수 (이웃이 2명 미만이면 0)
+        double globalClustering = 0;      // 3 * 삼각형 수 / 연결된 세 쌍 수
+        double averageClustering = 0;     // 지역 계수의 평균
+    };
+
+    // 차수 순으로 방향을 준 CSR에서 간선 u -> v마다 out(u)와 out(v)의 교집합으로 삼각형을 셈
+    // (각 삼각형은 차수가 가장 작은 정점에서 한 번만 발견됨) 정점은 스레드들이 동적으로 나눠 가짐
+    TriangleStats countTriangles(unsigned threads = thread::hardware_concurrency())
+    {
+        buildWeightedGraph();
+        size_t n = weightedIds.size();
+        TriangleStats stats;
+        stats.ids = weightedIds;
+
+        // 차수(같으면 번호) 순 순위로 정점 번호를 다시 매김
+        vector<int> order(n);
+        for (size_t v = 0; v < n; ++v)
+        {
+            order[v] = (int)v;
+        }
+        sort(order.begin(), order.end(), [&](int x, int y)
+        {
+            size_t dx = weightedOffset[x + 1] - weightedOffset[x];
+            size_t dy = weightedOffset[y + 1] - weightedOffset[y];
+            return dx != dy ? dx < dy : x < y;
+        });
+        vector<int> rank(n);
+        for (size_t r = 0; r < n; ++r)
+        {
+            rank[order[r]] = (int)r;
+        }
+
+        // 순위가 높은 이웃만 남긴 방향 CSR (순위 기준 정렬)
+        vector<size_t> outOffset(n + 1, 0);
+        vector<int> outTarget;
+        outTarget.reserve(weightedTarget.size() / 2);
+        for (size_t r = 0; r < n; ++r)
+        {
+            int v = order[r];
+            size_t first = outTarget.size();
+            for (size_t e = weightedOffset[v]; e < weightedOffset[v + 1]; ++e)
+            {
+                if (rank[weightedTarget[e]] > (int)r)
+                {
+                    outTarget.push_back(rank[weightedTarget[e]]);
+                }
+            }
+            sort(outTarget.begin() + first, outTarget.end());
+            outOffset[r + 1] = outTarget.size();
+        }
+
+        if (threads == 0)
+        {
+            threads = 1;
+        }
+        vector<vector<uint64_t>> partial(threads, vector<uint64_t>(n, 0));
+        atomic<size_t> next(0);
+        const size_t CHUNK = 64;
+        auto worker = [&](unsigned t)
+        {
+            vector<uint64_t>& count = partial[t];
+            vector<int> common;
+            for (size_t begin = next.fetch_add(CHUNK); begin < n; begin = next.fetch_add(CHUNK))
+            {
+                size_t end = min(n, begin + CHUNK);
+                for (size_t u = begin; u < end; ++u)
+                {
+                    const int* outU = outTarget.data() + outOffset[u];
+                    size_t degreeU = outOffset[u + 1] - outOffset[u];
+                    common.resize(degreeU);
+                    for (size_t e = 0; e < degreeU; ++e)
+                    {
+                        int v = outU[e];
+                        size_t found = intersectSorted(outU, degreeU, outTarget.data() + outOffset[v],
+                                                       outOffset[v + 1] - outOffset[v], common.data());
+                        count[u] += found;
+                        count[v] += found;
+                        for (size_t k = 0; k < found; ++k)
+                        {
+                            count[common[k]]++;
+                        }
+                    }
+                }
+            }
+        };
+        vector<thread> workers;
+        for (unsigned t = 1; t < threads; ++t)
+        {
+            workers.emplace_back(worker, t);
+        }
+        worker(0);
+        for (thread& w : workers)
+        {
+            w.join();
+        }
+
+        // 순위 번호를 밀집 번호로 되돌리며 합산
+        stats.perVertex.assign(n, 0);
+        stats.clustering.assign(n, 0);
+        uint64_t triples = 0, corners = 0;
+        double clusteringSum = 0;
+        for (size_t r = 0; r < n; ++r)
+        {
+            uint64_t total = 0;
+            for (unsigned t = 0; t < threads; ++t)
+            {
+                total += partial[t][r];
+            }
+            int v = order[r];
+            uint64_t degree = weightedOffset[v + 1] - weightedOffset[v];
+            stats.perVertex[v] = total;
+            corners += total;
+            if (degree >= 2)
+            {
+                uint64_t pairs = degree * (degree - 1) / 2;
+                triples += pairs;
+                stats.clustering[v] = (double)total / pairs;
+            }
+            clusteringSum += stats.clustering[v];
+        }
+        stats.triangles = corners / 3;
+        stats.globalClustering = triples == 0 ? 0 : (double)corners / triples;
+        stats.averageClustering = n == 0 ? 0 : clusteringSum / n;
+        return stats;
+    }
+
+private:
+    // 새 이웃이 생긴 사람을 다음 차수 칸으로 옮김
+    void raiseDegree(int person)
+    {
+        int& d = degree[person];
+        auto bucket = peopleByDegree.find(d);
+        bucket->second.erase(person);
+        if (bucket->second.empty())
+        {
+            peopleByDegree.erase(bucket);
+        }
+        if (d == 0)
+        {
+            isolatedPeople.erase(person);
+        }
+        ++d;
+        peopleByDegree[d].insert(person);
+    }
+
+    // 가중치 모드용 CSR (collaborations에서 필요할 때 한 번 생성)
+    bool weightedReady = false;
+    vector<int> weightedIds;      // 밀집 번호 -> 사람 번호
+    map<int, int> weightedIndex;  // 사람 번호 -> 밀집 번호
+    vector<size_t> weightedOffset;
+    vector<int> weightedTarget;
+    vector<uint64_t> weightedCost;
+
+    void buildWeightedGraph()
+    {
+        if (weightedReady)
+        {
+            return;
+        }
+        weightedIds.assign(people.begin(), people.end());
+        weightedIndex.clear();
+        for (size_t i = 0; i < weightedIds.size(); ++i)
+        {
+            weightedIndex[weightedIds[i]] = (int)i;
+        }
+
+        weightedOffset.assign(1, 0);
+        weightedTarget.clear();
+        weightedCost.clear();
+        for (int person : weightedIds)
+        {
+            auto it = collaborations.find(person);
+            if (it != collaborations.end())
+            {
+                for (const pair<const int, int>& partner : it->second)
+                {
+                    weightedTarget.push_back(weightedIndex[partner.first]);
+                    weightedCost.push_back(WEIGHT_SCALE / (uint64_t)partner.second);
+                }
+            }
+            weightedOffset.push_back(weightedTarget.size());
+        }
+        weightedReady = true;
+    }
+
+    // target이 -1이면 모든 정점까지의 거리를 계산
+    template <typename Heap>
+    void runDijkstra(int source, int target, vector<uint64_t>& dist, vector<int>& parent)
+    {
+        dist.assign(weightedIds.size(), UINT64_MAX);
+        parent.assign(weightedIds.size(), -1);
+        Heap heap;
+        dist[source] = 0;
+        heap.push(0, source);
+
+        while (!heap.empty())
+        {
+            pair<uint64_t, int> top = heap.pop();
+            int current = top.second;
+            if (top.first != dist[current])
+            {
+                continue; // 이미 더 짧은 거리로 처리된 항목
+            }
+            if (current == target)
+            {
+                return;
+            }
+            for (size_t i = weightedOffset[current]; i < weightedOffset[current + 1]; ++i)
+            {
+                int next = weightedTarget[i];
+                uint64_t candidate = top.first + weightedCost[i];
+                if (candidate < dist[next])
+                {
+                    dist[next] = candidate;
+                    parent[next] = current;
+                    heap.push(candidate, next);
+                }
+            }
+        }
+    }
+};
+
+// 질의 기록: 한 줄에 "기록 시작 후 경과 마이크로초 종류 인자..." (Kevin_B --replay로 재생 가능한 형식)
+// 종류: distance A B, lonewolf, components, connectors3, weighted A B (weighted는 Kevin_B가 건너뜀)
+class QueryTrace
+{
+private:
+    ofstream out;
+    chrono::steady_clock::time_point start;
+
+public:
+    bool open(const string& path)
+    {
+        out.open(path);
+        if (!out)
+        {
+            return false;
+        }
+        out << "# kevin-bacon query trace v1: micros type args..." << endl;
+        start = chrono::steady_clock::now();
+        return true;
+    }
+
+    void record(const char* type, initializer_list<int> args)
+    {
+        if (!out.is_open())
+        {
+            return;
+        }
+        out << chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count() << " " << type;
+        for (int arg : args)
+        {
+            out << " " << arg;
+        }
+        out << endl;
+    }
 };
 
 void printMenu()
@@ -228,16 +807,28 @@ void printMenu()
     cout << "2. Lone wolf는?" << endl;
     cout << "3. 몇 개의 그룹이 존재하는가?" << endl;
     cout << "4. 3단계 이내에 모두에게 연락 하려면 누구에게 연락해야할까?" << endl;
-    cout << "5. 종료" << endl;
+    cout << "5. 함께한 횟수를 반영한 거리는?" << endl;
+    cout << "6. 가중치 거리 벤치마크 (radix heap vs priority_queue)" << endl;
+    cout << "7. 삼각형 수와 클러스터링 계수는?" << endl;
+    cout << "8. 차수 분포와 이웃이 가장 많은 사람은?" << endl;
+    cout << "9. 종료" << endl;
     cout << "-----------------------" << endl;
     cout << "선택: ";
 }
 
-int main()
+int main(int argc, char* argv[])
 {
     Graph g;
     g.buildGraphFromFile("C:/ViveCoding/KJH/kb.txt");
 
+    // kebin --record 기록파일: 받은 질의를 시각과 함께 저장
+    QueryTrace trace;
+    if (argc >= 3 && string(argv[1]) == "--record" && !trace.open(argv[2]))
+    {
+        cout << "기록 파일을 만들 수 없습니다: " << argv[2] << endl;
+        return 1;
+    }
+
     int choice;
     while (true)
     {
@@ -252,7 +843,7 @@ int main()
             continue;
         }
 
-        if (choice == 5)
+        if (choice == 9)
         {
             cout << "프로그램을 종료합니다." << endl;
             break;
@@ -272,6 +863,7 @@ int main()
                     cin.ignore(numeric_limits<streamsize>::max(), '\n');
                     break;
                 }
+                trace.record("distance", { start, end });
                 int distance = g.getDistance(start, end);
                 if (distance != -1)
                 {
@@ -285,6 +877,7 @@ int main()
             }
             case 2:
             {
+                trace.record("lonewolf", {});
                 vector<int> loneWolves = g.findLoneWolves();
                 if (loneWolves.empty())
                 {
@@ -303,11 +896,13 @@ int main()
             }
             case 3:
             {
+                trace.record("components", {});
                 cout << "총 그룹의 수: " << g.countGroups() << "개" << endl;
                 break;
             }
             case 4:
             {
+                trace.record("connectors3", {});
                 vector<int> connectors = g.findThreeStepConnectors();
                 if (connectors.empty())
                 {
@@ -324,6 +919,104 @@ int main()
                 }
                 break;
             }
+            case 5:
+            {
+                int start, end;
+                cout << "두 사람의 번호를 입력하세요 (예: 1 7): ";
+                cin >> start >> end;
+                if (cin.fail())
+                {
+                    cout << "잘못된 입력입니다. 숫자를 입력해주세요." << endl;
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    break;
+                }
+                trace.record("weighted", { start, end });
+                pair<double, vector<int>> result = g.findWeightedDistanceWithPath(start, end);
+                if (result.first < 0)
+                {
+                    cout << start << "와(과) " << end << "는(은) 연결되어 있지 않습니다." << endl;
+                }
+                else
+                {
+                    cout << start << "와(과) " << end << "의 가중치 거리는 " << result.first << "입니다." << endl;
+                    cout << "경로: ";
+                    for (size_t i = 0; i < result.second.size(); ++i)
+                    {
+                        cout << result.second[i] << (i + 1 < result.second.size() ? " -> " : "");
+                    }
+                    cout << endl;
+                }
+                break;
+            }
+            case 6:
+            {
+                int sources;
+                cout << "출발점 개수를 입력하세요 (예: 100): ";
+                cin >> sources;
+                if (cin.fail() || sources <= 0)
+                {
+                    cout << "잘못된 입력입니다. 양의 정수를 입력해주세요." << endl;
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    break;
+                }
+                g.benchmarkWeightedDistance(sources);
+                break;
+            }
+            case 7:
+            {
+                int person;
+                cout << "사람 번호를 입력하세요 (0이면 전체 출력): ";
+                cin >> person;
+                if (cin.fail())
+                {
+                    cout << "잘못된 입력입니다. 숫자를 입력해주세요." << endl;
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    break;
+                }
+                auto t0 = chrono::steady_clock::now();
+                Graph::TriangleStats stats = g.countTriangles();
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+                cout << "삼각형 수: " << stats.triangles << "개 (" << ms << " ms)" << endl;
+                cout << "전체 클러스터링 계수: " << stats.globalClustering << endl;
+                cout << "평균 지역 클러스터링 계수: " << stats.averageClustering << endl;
+                for (size_t v = 0; v < stats.ids.size(); ++v)
+                {
+                    if (person == 0 || stats.ids[v] == person)
+                    {
+                        cout << stats.ids[v] << ": 삼각형 " << stats.perVertex[v] << "개, 클러스터링 계수 "
+                             << stats.clustering[v] << endl;
+                    }
+                }
+                break;
+            }
+            case 8:
+            {
+                int count;
+                cout << "상위 몇 명을 볼까요? (예: 5): ";
+                cin >> count;
+                if (cin.fail() || count <= 0)
+                {
+                    cout << "잘못된 입력입니다. 양의 정수를 입력해주세요." << endl;
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    break;
+                }
+                cout << "차수\t사람 수" << endl;
+                for (const pair<int, int>& entry : g.degreeDistribution())
+                {
+                    cout << entry.first << "\t" << entry.second << endl;
+                }
+                cout << "이웃이 가장 많은 사람: ";
+                for (const pair<int, int>& entry : g.topDegreePeople(count))
+                {
+                    cout << entry.first << "(" << entry.second << ") ";
+                }
+                cout << endl;
+                break;
+            }
             default:
                 cout << "잘못된 선택입니다. 다시 시도하세요." << endl;
                 break;
@@ -1,5 +1,6 @@
 // Compile Command: cl /EHsc /W4 /Fe:calculator.exe main.cpp
 #include <iostream>
+#include <iomanip>
 #include <string>
 #include <vector>
 #include <stack>
@@ -9,310 +10,1686 @@
 #include <stdexcept>
 #include <cctype>
 #include <algorithm>
+#include <map>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+#include <climits>
+#include <memory>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CALC_USE_SSE2 1
+#endif
 
 using namespace std;
 
-// Լ 
-string preprocess(const string& expr);
-vector<string> infixToPostfix(const string& infix);
-double evaluatePostfix(const vector<string>& postfix);
+/**
+ * @brief 렉서가 잘라 낸 토큰 하나. 원본 문자열 안의 위치만 가리키므로 토큰마다 문자열을 만들지 않습니다.
+ */
+struct Token {
+    enum Kind { END, NUMBER, NAME, OPERATOR, OPEN, CLOSE, INVALID };
+    Kind kind;
+    char symbol;   // 연산자나 괄호 문자 ('**'는 '^'). 지원하지 않는 문자이면 그 문자, 잘못된 숫자이면 0
+    bool negative; // 단항 '-'가 붙은 숫자나 변수 이름
+    double value;  // NUMBER의 값 (부호 포함)
+    size_t offset; // 원본에서 숫자/이름/문자가 시작하는 위치 (부호 제외)
+    size_t length; // 원본에서 차지하는 길이 (부호 제외)
+};
+
+// 함수 선언
+vector<Token> infixToPostfix(const string& infix);
+vector<Token> tokenizePostfix(const string& expr);
+double evaluatePostfix(const vector<Token>& postfix, const string& source);
+double evaluatePostfix(const vector<Token>& postfix, const string& source, const map<string, double>& variables);
 bool isPostfix(const string& expr);
-int getPrecedence(const string& op);
-double applyOperation(double a, double b, const string& op);
-bool isNumber(const string& s);
+int getPrecedence(char op);
+double applyOperation(double a, double b, char op);
+bool isVariableName(const string& s);
+bool isVariableName(const char* s, size_t length);
 
 /**
- * @brief  켱 ȯմϴ.
- * @param op  ڿ
- * @return 켱  ( 켱 )
+ * @brief 연산자의 우선순위를 반환합니다.
+ * @param op 연산자 문자
+ * @return 우선순위 값 (높을수록 우선순위가 높음)
  */
-int getPrecedence(const string& op) {
-    if (op == "^") return 3;
-    if (op == "*" || op == "/") return 2;
-    if (op == "+" || op == "-") return 1;
+int getPrecedence(char op) {
+    if (op == '^') return 3;
+    if (op == '*' || op == '/') return 2;
+    if (op == '+' || op == '-') return 1;
     return 0;
 }
 
 /**
- * @brief  ǿڿ ڸ ޾  մϴ.
- * @param a ù ° ǿ
- * @param b  ° ǿ
- * @param op 
- * @return  
+ * @brief 두 피연산자와 연산자를 받아 계산을 수행합니다.
+ * @param a 첫 번째 피연산자
+ * @param b 두 번째 피연산자
+ * @param op 연산자 문자
+ * @return 계산 결과
  */
-double applyOperation(double a, double b, const string& op) {
-    if (op == "+") return a + b;
-    if (op == "-") return a - b;
-    if (op == "*") return a * b;
-    if (op == "/") {
-        if (b == 0) throw runtime_error(": 0   ϴ.");
+double applyOperation(double a, double b, char op) {
+    if (op == '+') return a + b;
+    if (op == '-') return a - b;
+    if (op == '*') return a * b;
+    if (op == '/') {
+        if (b == 0) throw runtime_error("오류: 0으로 나눌 수 없습니다.");
         return a / b;
     }
-    if (op == "^") return pow(a, b);
-    throw runtime_error(":  ʴ  '" + op + "'.");
+    if (op == '^') return pow(a, b);
+    throw runtime_error(string("오류: 지원하지 않는 연산자 '") + op + "'.");
 }
 
+/*
+ * 정확한 계산용 수 체계 (numeric tower)
+ *   INTEGER  : long long 정수. 연산마다 오버플로를 검사해 넘치면 BIG으로 올림
+ *   RATIONAL : long long 분자/분모의 기약분수 (0.1, 1/3 등)
+ *   BIG      : 임의 정밀도 정수로 된 기약분수. 결과가 다시 long long에 들어오면 내려옴
+ *   REAL     : double. 지수가 정수가 아닌 거듭제곱이나 BIG이 너무 커졌을 때만 씀
+ */
+#if defined(__GNUC__) || defined(__clang__)
+bool checkedAdd(long long a, long long b, long long* out) { return __builtin_add_overflow(a, b, out); }
+bool checkedSub(long long a, long long b, long long* out) { return __builtin_sub_overflow(a, b, out); }
+bool checkedMul(long long a, long long b, long long* out) { return __builtin_mul_overflow(a, b, out); }
+#else
+// 내장 함수가 없는 컴파일러(MSVC)용. 넘치면 true
+bool checkedAdd(long long a, long long b, long long* out) {
+    if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) return true;
+    *out = a + b;
+    return false;
+}
+bool checkedSub(long long a, long long b, long long* out) {
+    if ((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b)) return true;
+    *out = a - b;
+    return false;
+}
+bool checkedMul(long long a, long long b, long long* out) {
+    if (a != 0 && b != 0) {
+        if ((a == -1 && b == LLONG_MIN) || (b == -1 && a == LLONG_MIN)) return true;
+        if (a > 0 ? (b > 0 ? a > LLONG_MAX / b : b < LLONG_MIN / a)
+                  : (b > 0 ? a < LLONG_MIN / b : (a != -1 && b < LLONG_MAX / a))) return true;
+    }
+    *out = a * b;
+    return false;
+}
+#endif
+
 /**
- * @brief ǥ Ľϱ  óմϴ.
- *        - `**` ŵ  `^` ȯմϴ.
- *        - `3(4)` `(3)4`  Ͻ  `3*(4)`, `(3)*4`    ٲߴϴ.
- * @param expr  ǥ ڿ
- * @return ó ǥ ڿ
+ * @brief 부호 있는 임의 정밀도 정수. 10^9 단위(limb)로 낮은 자리부터 저장합니다. (0이면 limbs가 비어 있음)
+ *        long long을 넘는 분수의 분자/분모에만 쓰므로 학교에서 배우는 곱셈과 나눗셈으로 구현합니다.
  */
-string preprocess(const string& expr) {
-    string temp = expr;
-    size_t pos = 0;
-    // `**` `^` 
-    while ((pos = temp.find("**", pos)) != string::npos) {
-        temp.replace(pos, 2, "^");
+class BigInt {
+public:
+    enum { BASE = 1000000000, BASE_DIGITS = 9 };
+
+    BigInt() : negative(false) {}
+    BigInt(long long v) : negative(v < 0) {
+        unsigned long long magnitude = v < 0 ? 0ULL - static_cast<unsigned long long>(v) : static_cast<unsigned long long>(v);
+        while (magnitude > 0) {
+            limbs.push_back(static_cast<uint32_t>(magnitude % BASE));
+            magnitude /= BASE;
+        }
     }
 
-    string result; //ȯ ڿ
-    result.reserve(temp.length() * 2); // ڿ ι ũ 
-    for (size_t i = 0; i < temp.length(); ++i) {
-        result += temp[i];
+    /**
+     * @brief 10진수 숫자로만 된 문자열을 읽습니다.
+     */
+    static BigInt fromDigits(const string& digits) {
+        BigInt result;
+        for (size_t end = digits.length(); end > 0;) {
+            size_t begin = end >= BASE_DIGITS ? end - BASE_DIGITS : 0;
+            uint32_t limb = 0;
+            for (size_t i = begin; i < end; ++i) limb = limb * 10 + static_cast<uint32_t>(digits[i] - '0');
+            result.limbs.push_back(limb);
+            end = begin;
+        }
+        result.trim();
+        return result;
+    }
+
+    bool isZero() const { return limbs.empty(); }
+    bool isNegative() const { return negative; }
+    size_t size() const { return limbs.size(); }
 
-        size_t next_i = i + 1;
-        while (next_i < temp.length() && isspace(temp[next_i])) {
-            next_i++;
+    /**
+     * @brief long long 범위에 들어오면 out에 넣고 true를 반환합니다.
+     */
+    bool toInt64(long long& out) const {
+        unsigned long long magnitude = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            if (magnitude > (ULLONG_MAX - limbs[i]) / BASE) return false;
+            magnitude = magnitude * BASE + limbs[i];
         }
+        if (magnitude > static_cast<unsigned long long>(LLONG_MAX) + (negative ? 1 : 0)) return false;
+        out = negative ? static_cast<long long>(0ULL - magnitude) : static_cast<long long>(magnitude);
+        return true;
+    }
 
-        if (next_i < temp.length()) {
-            char current_char = temp[i];
-            char next_char = temp[next_i];
+    /**
+     * @brief 값을 mantissa * BASE^exponent로 어림합니다. (위쪽 세 limb만 사용, double로 넘치지 않음)
+     */
+    void approximate(double& mantissa, long& exponent) const {
+        size_t low = limbs.size() > 3 ? limbs.size() - 3 : 0;
+        mantissa = 0;
+        for (size_t i = limbs.size(); i-- > low;) mantissa = mantissa * BASE + limbs[i];
+        if (negative) mantissa = -mantissa;
+        exponent = static_cast<long>(low);
+    }
+
+    string toString() const {
+        if (limbs.empty()) return "0";
+        string text = negative ? "-" : "";
+        text += to_string(limbs.back());
+        for (size_t i = limbs.size() - 1; i-- > 0;) {
+            string part = to_string(limbs[i]);
+            text.append(BASE_DIGITS - part.length(), '0');
+            text += part;
+        }
+        return text;
+    }
+
+    BigInt operator-() const {
+        BigInt result = *this;
+        if (!result.isZero()) result.negative = !negative;
+        return result;
+    }
+
+    friend BigInt operator+(const BigInt& a, const BigInt& b) {
+        if (a.negative == b.negative) return withSign(addAbs(a.limbs, b.limbs), a.negative);
+        if (compareAbs(a.limbs, b.limbs) >= 0) return withSign(subAbs(a.limbs, b.limbs), a.negative);
+        return withSign(subAbs(b.limbs, a.limbs), b.negative);
+    }
 
-            //  ڿ  ȣ, ݴ ȣ ڿ , ȣ ڿ ȣ   (*) ߰
-            if ((isdigit(current_char) && next_char == '(') ||
-                (current_char == ')' && isdigit(next_char)) ||
-                (current_char == ')' && next_char == '(')) {
-                result += '*';
+    friend BigInt operator-(const BigInt& a, const BigInt& b) { return a + (-b); }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        if (a.isZero() || b.isZero()) return BigInt();
+        vector<uint32_t> product(a.limbs.size() + b.limbs.size(), 0);
+        for (size_t i = 0; i < a.limbs.size(); ++i) {
+            unsigned long long carry = 0;
+            for (size_t j = 0; j < b.limbs.size() || carry > 0; ++j) {
+                unsigned long long current = product[i + j] + carry +
+                    (j < b.limbs.size() ? static_cast<unsigned long long>(a.limbs[i]) * b.limbs[j] : 0);
+                product[i + j] = static_cast<uint32_t>(current % BASE);
+                carry = current / BASE;
             }
         }
+        return withSign(product, a.negative != b.negative);
     }
-    return result;
-}
+
+    /**
+     * @brief 몫과 나머지 (몫은 0 쪽으로 버림, 나머지의 부호는 a를 따름). b는 0이 아니어야 합니다.
+     */
+    static void divide(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+        vector<uint32_t> q(a.limbs.size(), 0);
+        vector<uint32_t> r;
+        double divisor_mantissa;
+        long divisor_exponent;
+        b.approximate(divisor_mantissa, divisor_exponent);
+        divisor_mantissa = abs(divisor_mantissa);
+        for (size_t i = a.limbs.size(); i-- > 0;) {
+            r.insert(r.begin(), a.limbs[i]); // r = r * BASE + 다음 limb
+            trim(r);
+            if (compareAbs(r, b.limbs) < 0) continue;
+            // 위쪽 limb로 몫 한 자리를 어림한 뒤 한두 번 보정
+            BigInt rest = withSign(r, false);
+            double mantissa;
+            long exponent;
+            rest.approximate(mantissa, exponent);
+            double estimate = mantissa / divisor_mantissa * pow(static_cast<double>(BASE), static_cast<double>(exponent - divisor_exponent));
+            uint32_t digit = static_cast<uint32_t>(min(max(estimate, 0.0), static_cast<double>(BASE - 1)));
+            vector<uint32_t> product = mulSmall(b.limbs, digit);
+            while (compareAbs(product, r) > 0) product = mulSmall(b.limbs, --digit);
+            r = subAbs(r, product);
+            while (compareAbs(r, b.limbs) >= 0) {
+                r = subAbs(r, b.limbs);
+                digit++;
+            }
+            q[i] = digit;
+        }
+        quotient = withSign(q, a.negative != b.negative);
+        remainder = withSign(r, a.negative);
+    }
+
+    /**
+     * @brief 최대공약수 (항상 0 이상)
+     */
+    static BigInt gcd(BigInt a, BigInt b) {
+        a.negative = b.negative = false;
+        while (!b.isZero()) {
+            BigInt quotient, remainder;
+            divide(a, b, quotient, remainder);
+            a = b;
+            b = remainder;
+        }
+        return a;
+    }
+
+    bool isOne() const { return !negative && limbs.size() == 1 && limbs[0] == 1; }
+
+private:
+    bool negative;
+    vector<uint32_t> limbs;
+
+    void trim() { trim(limbs); if (limbs.empty()) negative = false; }
+    static void trim(vector<uint32_t>& v) { while (!v.empty() && v.back() == 0) v.pop_back(); }
+
+    static BigInt withSign(const vector<uint32_t>& magnitude, bool is_negative) {
+        BigInt result;
+        result.limbs = magnitude;
+        result.negative = is_negative;
+        result.trim();
+        return result;
+    }
+
+    static int compareAbs(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static vector<uint32_t> addAbs(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        vector<uint32_t> sum;
+        uint32_t carry = 0;
+        for (size_t i = 0; i < max(a.size(), b.size()) || carry > 0; ++i) {
+            uint32_t current = carry + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+            carry = current >= static_cast<uint32_t>(BASE) ? 1 : 0;
+            sum.push_back(carry ? current - static_cast<uint32_t>(BASE) : current);
+        }
+        return sum;
+    }
+
+    // |a| >= |b|일 때 |a| - |b|
+    static vector<uint32_t> subAbs(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+        vector<uint32_t> difference(a);
+        uint32_t borrow = 0;
+        for (size_t i = 0; i < difference.size(); ++i) {
+            uint32_t subtrahend = borrow + (i < b.size() ? b[i] : 0);
+            borrow = difference[i] < subtrahend ? 1 : 0;
+            difference[i] = borrow ? difference[i] + static_cast<uint32_t>(BASE) - subtrahend : difference[i] - subtrahend;
+        }
+        trim(difference);
+        return difference;
+    }
+
+    static vector<uint32_t> mulSmall(const vector<uint32_t>& a, uint32_t factor) {
+        vector<uint32_t> product;
+        if (factor == 0) return product;
+        unsigned long long carry = 0;
+        for (size_t i = 0; i < a.size() || carry > 0; ++i) {
+            unsigned long long current = carry + (i < a.size() ? static_cast<unsigned long long>(a[i]) * factor : 0);
+            product.push_back(static_cast<uint32_t>(current % BASE));
+            carry = current / BASE;
+        }
+        return product;
+    }
+};
 
 /**
- * @brief  ǥ   ǥ ȯմϴ. (unting-yard ˰ )
- *         (+, -) óϴ  ԵǾ ֽϴ.
- * @param infix  ǥ ڿ
- * @return  ǥ ȯ ū 
+ * @brief 계산 결과 하나. 정수와 분수는 정확하게, 그 밖의 값만 double로 다룹니다.
+ *        INTEGER와 RATIONAL은 힙을 쓰지 않고, BIG일 때만 분자/분모를 따로 할당합니다.
  */
-vector<string> infixToPostfix(const string& infix) {
-    vector<string> postfix;
-    stack<string> operators;
-    bool is_unary = true; //  ġ  ڰ   ִ 
+class Number {
+public:
+    enum Kind { INTEGER, RATIONAL, BIG, REAL };
+    enum { MAX_LIMBS = 128 }; // BIG의 분자나 분모가 이보다 길어지면 (약 1150자리) double로 바꿈
 
-    for (size_t i = 0; i < infix.length(); ++i) {
-        char c = infix[i];
+    Number() : kind(INTEGER), num(0), den(1), real(0) {}
 
-        if (isspace(c)) {
-            continue;
+    static Number fromInteger(long long value) {
+        Number number;
+        number.num = value;
+        return number;
+    }
+
+    static Number fromDouble(double value) {
+        Number number;
+        number.kind = REAL;
+        number.real = value;
+        return number;
+    }
+
+    /**
+     * @brief numerator / denominator를 기약분수로 만듭니다. (denominator는 0이 아님)
+     */
+    static Number fromRatio(long long numerator, long long denominator) {
+        if (denominator < 0) {
+            if (numerator == LLONG_MIN || denominator == LLONG_MIN) return fromBig(BigInt(numerator), BigInt(denominator));
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        unsigned long long a = numerator < 0 ? 0ULL - static_cast<unsigned long long>(numerator) : static_cast<unsigned long long>(numerator);
+        unsigned long long b = static_cast<unsigned long long>(denominator);
+        while (b != 0) {
+            unsigned long long t = a % b;
+            a = b;
+            b = t;
+        }
+        Number number;
+        number.num = numerator / static_cast<long long>(a);
+        number.den = denominator / static_cast<long long>(a);
+        number.kind = number.den == 1 ? INTEGER : RATIONAL;
+        return number;
+    }
+
+    /**
+     * @brief 임의 정밀도 분수를 기약분수로 만들고, long long에 들어오면 INTEGER/RATIONAL로 내립니다.
+     *        너무 커지면 double로 바꿉니다.
+     */
+    static Number fromBig(BigInt numerator, BigInt denominator) {
+        if (denominator.isNegative()) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        BigInt divisor = BigInt::gcd(numerator, denominator);
+        if (!divisor.isOne()) {
+            BigInt remainder;
+            BigInt::divide(numerator, divisor, numerator, remainder);
+            BigInt::divide(denominator, divisor, denominator, remainder);
+        }
+        long long n, d;
+        if (numerator.toInt64(n) && denominator.toInt64(d)) return fromRatio(n, d);
+        if (numerator.size() > MAX_LIMBS || denominator.size() > MAX_LIMBS) return fromDouble(ratioToDouble(numerator, denominator));
+        Number number;
+        number.kind = BIG;
+        number.big = make_shared<BigFraction>(BigFraction{ numerator, denominator });
+        return number;
+    }
+
+    /**
+     * @brief 숫자 토큰(숫자와 소수점 하나)을 정확한 값으로 읽습니다. 0.1은 1/10입니다.
+     */
+    static Number parse(const char* text, size_t length, bool negative) {
+        static const long long powers[] = { 1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+                                            1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+                                            100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+                                            1000000000000000000LL };
+        long long mantissa = 0;
+        size_t digits = 0, fraction = 0;
+        bool after_dot = false;
+        for (size_t i = 0; i < length; ++i) {
+            if (text[i] == '.') {
+                after_dot = true;
+                continue;
+            }
+            if (digits < 18) mantissa = mantissa * 10 + (text[i] - '0');
+            digits++;
+            if (after_dot) fraction++;
+        }
+        if (digits <= 18 && fraction == 0) return fromInteger(negative ? -mantissa : mantissa);
+        if (digits <= 18) return fromRatio(negative ? -mantissa : mantissa, powers[fraction]);
+
+        // 18자리보다 긴 숫자
+        string all_digits;
+        for (size_t i = 0; i < length; ++i) {
+            if (text[i] != '.') all_digits += text[i];
+        }
+        BigInt numerator = BigInt::fromDigits(all_digits);
+        BigInt denominator = BigInt::fromDigits("1" + string(fraction, '0'));
+        return fromBig(negative ? -numerator : numerator, denominator);
+    }
+
+    Kind getKind() const { return kind; }
+    long long toInteger() const { return num; } // INTEGER일 때의 값
+    bool isInteger() const { return kind == INTEGER || (kind == BIG && big->denominator.isOne()); }
+    bool isZero() const { return (kind == INTEGER && num == 0) || (kind == REAL && real == 0); }
+
+    double toDouble() const {
+        switch (kind) {
+        case INTEGER: return static_cast<double>(num);
+        case RATIONAL: return static_cast<double>(num) / static_cast<double>(den);
+        case BIG: return ratioToDouble(big->numerator, big->denominator);
+        default: return real;
+        }
+    }
+
+    /**
+     * @brief 정수는 모든 자리, 분수는 "분자/분모", double은 기본 형식으로 씁니다.
+     */
+    string toString() const {
+        switch (kind) {
+        case INTEGER: return to_string(num);
+        case RATIONAL: return to_string(num) + "/" + to_string(den);
+        case BIG: return big->numerator.toString() + (big->denominator.isOne() ? "" : "/" + big->denominator.toString());
+        default: {
+            ostringstream text;
+            text << real;
+            return text.str();
+        }
+        }
+    }
+
+    Number operator-() const {
+        switch (kind) {
+        case INTEGER:
+        case RATIONAL:
+            if (num != LLONG_MIN) {
+                Number negated = *this;
+                negated.num = -num;
+                return negated;
+            }
+            return fromBig(-BigInt(num), BigInt(den));
+        case BIG: return fromBig(-big->numerator, big->denominator);
+        default: return fromDouble(-real);
+        }
+    }
+
+    /**
+     * @brief a op b. 둘 다 정확한 값이면 long long으로 먼저 계산하고, 넘치면 임의 정밀도로 다시 계산합니다.
+     */
+    friend Number applyExact(const Number& a, const Number& b, char op) {
+        long long n;
+        if (a.kind == INTEGER && b.kind == INTEGER && op != '/' && op != '^') { // 가장 흔한 정수끼리의 덧셈, 뺄셈, 곱셈
+            bool overflow = op == '+' ? checkedAdd(a.num, b.num, &n) : op == '-' ? checkedSub(a.num, b.num, &n) : checkedMul(a.num, b.num, &n);
+            if (!overflow) return fromInteger(n);
+        }
+        if (op == '^') return power(a, b);
+        if (op == '/' && ((b.kind != REAL && b.kind != BIG && b.num == 0) || (b.kind == REAL && b.real == 0))) {
+            throw runtime_error("오류: 0으로 나눌 수 없습니다.");
+        }
+        if (a.kind == REAL || b.kind == REAL) return fromDouble(applyOperation(a.toDouble(), b.toDouble(), op));
+
+        if (a.kind != BIG && b.kind != BIG) { // 분수 (정수끼리 넘친 경우도 여기서 다시 넘쳐 아래로 감)
+            long long x, y, d;
+            if (op == '+' || op == '-') { // a/b ± c/d = (a*d ± c*b) / (b*d)
+                if (!checkedMul(a.num, b.den, &x) && !checkedMul(b.num, a.den, &y) &&
+                    !(op == '+' ? checkedAdd(x, y, &n) : checkedSub(x, y, &n)) && !checkedMul(a.den, b.den, &d)) return fromRatio(n, d);
+            } else if (op == '*') {
+                if (!checkedMul(a.num, b.num, &n) && !checkedMul(a.den, b.den, &d)) return fromRatio(n, d);
+            } else if (op == '/') {
+                if (!checkedMul(a.num, b.den, &n) && !checkedMul(a.den, b.num, &d)) return fromRatio(n, d);
+            }
+        }
+
+        // long long으로 넘친 경우: 임의 정밀도 분수로 계산
+        BigInt an, ad, bn, bd;
+        a.toBig(an, ad);
+        b.toBig(bn, bd);
+        switch (op) {
+        case '+': return fromBig(an * bd + bn * ad, ad * bd);
+        case '-': return fromBig(an * bd - bn * ad, ad * bd);
+        case '*': return fromBig(an * bn, ad * bd);
+        default: return fromBig(an * bd, ad * bn);
+        }
+    }
+
+private:
+    struct BigFraction {
+        BigInt numerator;
+        BigInt denominator; // 항상 양수
+    };
+
+    Kind kind;
+    long long num; // INTEGER, RATIONAL의 분자
+    long long den; // INTEGER, RATIONAL의 분모 (INTEGER는 1)
+    double real;   // REAL의 값
+    shared_ptr<const BigFraction> big; // BIG의 분자/분모
+
+    void toBig(BigInt& numerator, BigInt& denominator) const {
+        if (kind == BIG) {
+            numerator = big->numerator;
+            denominator = big->denominator;
+        } else {
+            numerator = BigInt(num);
+            denominator = BigInt(den);
+        }
+    }
+
+    static double ratioToDouble(const BigInt& numerator, const BigInt& denominator) {
+        double n, d;
+        long n_exponent, d_exponent;
+        numerator.approximate(n, n_exponent);
+        denominator.approximate(d, d_exponent);
+        return n / d * pow(static_cast<double>(BigInt::BASE), static_cast<double>(n_exponent - d_exponent));
+    }
+
+    // 분자/분모 중 큰 쪽의 대략적인 비트 수
+    size_t bitLength() const {
+        if (kind == BIG) return max(big->numerator.size(), big->denominator.size()) * 30;
+        unsigned long long magnitude = num < 0 ? 0ULL - static_cast<unsigned long long>(num) : static_cast<unsigned long long>(num);
+        magnitude = max(magnitude, static_cast<unsigned long long>(den));
+        size_t bits = 0;
+        while (magnitude > 0) {
+            bits++;
+            magnitude >>= 1;
         }
+        return bits;
+    }
+
+    /**
+     * @brief 거듭제곱. 지수가 정수이면 제곱을 반복하는 방식(exponentiation by squaring)으로 정확히 계산하고,
+     *        결과가 MAX_LIMBS를 넘을 만큼 크거나 지수가 정수가 아니면 pow로 계산합니다.
+     */
+    static Number power(const Number& base, const Number& exponent) {
+        if (base.kind == REAL || exponent.kind != INTEGER) return fromDouble(pow(base.toDouble(), exponent.toDouble()));
+        long long e = exponent.num;
+        if (e < 0 && base.isZero()) return fromDouble(pow(0.0, static_cast<double>(e))); // 0의 음수 제곱은 pow처럼 inf
+        unsigned long long remaining = e < 0 ? 0ULL - static_cast<unsigned long long>(e) : static_cast<unsigned long long>(e);
+        size_t bits = base.bitLength(); // 결과는 대략 (bits - 1) * 지수 비트 (어림이 모자라도 fromBig이 double로 바꿈)
+        if (bits > 1 && remaining > static_cast<unsigned long long>(MAX_LIMBS) * 29 / (bits - 1)) {
+            return fromDouble(pow(base.toDouble(), exponent.toDouble()));
+        }
+
+        Number factor = e < 0 ? applyExact(fromInteger(1), base, '/') : base;
+        Number result = fromInteger(1);
+        while (remaining > 0) {
+            if (remaining & 1) result = applyExact(result, factor, '*');
+            remaining >>= 1;
+            if (remaining > 0) factor = applyExact(factor, factor, '*');
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief 수식을 앞에서부터 한 토큰씩 잘라 주는 렉서. 원본 문자열을 가리키기만 하고 메모리를 할당하지 않습니다.
+ *        중위 표기에서는 단항 '-'를 infixToPostfix가 처리하고, 후위 표기에서는 숫자/이름에 붙은 '-', '+'를 부호로 읽습니다.
+ *        `**`는 `^` 하나로 읽고, 중위 표기의 암시적 곱셈(`3(4)`, `(3)4`, `(3)(4)`)은 그 자리에 길이 0인 `*` 토큰을 넣으므로
+ *        수식을 미리 고쳐 쓰는 전처리 없이 한 번 훑는 것으로 끝납니다.
+ */
+class Lexer {
+public:
+    explicit Lexer(const string& text, bool postfix = false) : source(text), pos(0), postfix_mode(postfix), previous(Token::END) {}
+
+    /**
+     * @brief 다음 토큰을 token에 채웁니다.
+     * @return 수식이 끝났으면 false
+     */
+    bool next(Token& token) {
+        while (pos < source.length() && isspace(static_cast<unsigned char>(source[pos]))) pos++;
+        token.symbol = 0;
+        token.negative = false;
+        token.value = 0;
+        if (pos == source.length()) {
+            token.kind = Token::END;
+            token.offset = pos;
+            token.length = 0;
+            return false;
+        }
+
+        char c = source[pos];
+        // 숫자나 닫는 괄호 뒤에 여는 괄호, 닫는 괄호 뒤에 숫자가 오면 곱셈
+        if (!postfix_mode && ((previous == Token::NUMBER && c == '(') ||
+                              (previous == Token::CLOSE && (c == '(' || isdigit(static_cast<unsigned char>(c)) || c == '.')))) {
+            token.kind = Token::OPERATOR;
+            token.symbol = '*';
+            token.offset = pos;
+            token.length = 0;
+            previous = token.kind;
+            return true;
+        }
+        if (postfix_mode && (c == '-' || c == '+') && pos + 1 < source.length() && startsOperand(source[pos + 1])) {
+            token.negative = c == '-';
+            c = source[++pos];
+        }
+        token.offset = pos;
+
+        if (isdigit(static_cast<unsigned char>(c)) || c == '.') { // 숫자 (소수점이 둘 이상이면 잘못된 숫자)
+            token.kind = scanNumber(token.value) ? Token::NUMBER : Token::INVALID;
+            if (token.negative) token.value = -token.value;
+        } else if (isalpha(static_cast<unsigned char>(c)) || c == '_') { // 변수 이름
+            while (pos < source.length() && (isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) pos++;
+            token.kind = Token::NAME;
+        } else {
+            if (c == '(') token.kind = Token::OPEN;
+            else if (c == ')') token.kind = Token::CLOSE;
+            else if (c == '+' || c == '-' || c == '*' || c == '/' || c == '^') token.kind = Token::OPERATOR;
+            else token.kind = Token::INVALID;
+            if (c == '*' && pos + 1 < source.length() && source[pos + 1] == '*') { // `**`는 거듭제곱
+                c = '^';
+                pos++;
+            }
+            token.symbol = c;
+            pos++;
+        }
+        token.length = pos - token.offset;
+        previous = token.kind;
+        return true;
+    }
 
-        if (isdigit(c) || c == '.') { //  
-            string number;
-            while (i < infix.length() && (isdigit(infix[i]) || infix[i] == '.')) {
-                number += infix[i];
-                i++;
+    /**
+     * @brief 다음 토큰을 읽되 위치는 옮기지 않습니다.
+     */
+    bool peek(Token& token) {
+        size_t saved = pos;
+        Token::Kind saved_previous = previous;
+        bool found = next(token);
+        pos = saved;
+        previous = saved_previous;
+        return found;
+    }
+
+private:
+    const string& source;
+    size_t pos;
+    bool postfix_mode;
+    Token::Kind previous; // 직전 토큰 종류 (암시적 곱셈 판단용)
+
+    static bool startsOperand(char c) {
+        return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+    }
+
+    /**
+     * @brief pos에서 시작하는 숫자를 읽어 value에 넣습니다.
+     *        짧은 숫자는 나눗셈 한 번으로 구하고(근거는 JWY formula_operations.cpp의 Lexer::scanNumber),
+     *        그보다 긴 숫자만 잘라 복사해서 strtod로 변환합니다.
+     * @return 소수점이 둘 이상이거나 숫자가 없거나 double 범위를 넘으면 false
+     */
+    bool scanNumber(double& value) {
+        static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        size_t start = pos;
+        unsigned long long mantissa = 0;
+        int digits = 0, fraction = 0, dots = 0;
+        for (; pos < source.length() && (isdigit(static_cast<unsigned char>(source[pos])) || source[pos] == '.'); ++pos) {
+            if (source[pos] == '.') {
+                dots++;
+                continue;
             }
-            i--;
-            postfix.push_back(number);
+            if (digits < 19) mantissa = mantissa * 10 + static_cast<unsigned>(source[pos] - '0');
+            digits++;
+            if (dots > 0) fraction++;
+        }
+        if (dots > 1 || digits == 0) return false;
+        if (digits <= 15 && fraction <= 22) {
+            value = static_cast<double>(mantissa) / powers[fraction];
+            return true;
+        }
+        char buffer[64];
+        size_t length = pos - start;
+        if (length < sizeof(buffer)) {
+            memcpy(buffer, source.data() + start, length);
+            buffer[length] = '\0';
+            value = strtod(buffer, nullptr);
+        } else {
+            value = strtod(source.substr(start, length).c_str(), nullptr);
+        }
+        return !isinf(value);
+    }
+};
+
+/**
+ * @brief 오류 메시지에 넣을 토큰의 원래 글자를 돌려줍니다. (오류가 날 때만 문자열을 만듦)
+ */
+string tokenText(const string& source, const Token& token) {
+    if (token.kind == Token::OPERATOR) return string(1, token.symbol);
+    return (token.negative ? "-" : "") + source.substr(token.offset, token.length);
+}
+
+/**
+ * @brief 중위 표기법 수식을 후위 표기법으로 변환합니다. (샤unting-yard 알고리즘 기반)
+ *        단항 연산자(+, -)를 처리하는 기능이 포함되어 있습니다.
+ *        토큰은 렉서에서 하나씩 받으므로 토큰마다 문자열을 만들지 않습니다.
+ * @param infix 중위 표기법 문자열
+ * @return 후위 표기법 순서의 토큰 (infix를 가리키므로 infix가 살아 있는 동안만 사용)
+ */
+vector<Token> infixToPostfix(const string& infix) {
+    vector<Token> postfix;
+    vector<Token> operators; // 연산자 스택 (지원하지 않는 문자도 우선순위 0인 연산자로 쌓였다가 계산할 때 오류)
+    bool is_unary = true; // 현재 위치에 단항 연산자가 올 수 있는지 여부
+    Lexer lexer(infix);
+    Token token;
+
+    while (lexer.next(token)) {
+        if (token.kind == Token::NUMBER || token.kind == Token::NAME) { // 숫자나 변수 이름
+            postfix.push_back(token);
             is_unary = false;
-        } else if (c == '(') { //  ȣ
-            operators.push("(");
+        } else if (token.kind == Token::OPEN) { // 여는 괄호
+            operators.push_back(token);
             is_unary = true;
-        } else if (c == ')') { // ݴ ȣ
-            while (!operators.empty() && operators.top() != "(") {
-                postfix.push_back(operators.top());
-                operators.pop();
+        } else if (token.kind == Token::CLOSE) { // 닫는 괄호
+            while (!operators.empty() && operators.back().kind != Token::OPEN) {
+                postfix.push_back(operators.back());
+                operators.pop_back();
             }
-            if (!operators.empty()) operators.pop(); // '(' 
-            else throw runtime_error(": ȣ   ʽϴ.");
+            if (!operators.empty()) operators.pop_back(); // '(' 제거
+            else throw runtime_error("오류: 괄호 쌍이 맞지 않습니다.");
             is_unary = false;
-        } else { //  
-            string op(1, c);
-            if (is_unary && (c == '-' || c == '+')) { //   ó
-                if (c == '+') { //  '+' 
-                    is_unary = true;
-                    continue;
-                }
-                //  '-' ó
-                string number = "-";
-                i++;
-                while (i < infix.length() && isspace(infix[i])) i++;
-                while (i < infix.length() && (isdigit(infix[i]) || infix[i] == '.')) {
-                    number += infix[i];
-                    i++;
+        } else if (token.kind == Token::INVALID && token.symbol == 0) { // 소수점이 둘 이상인 숫자는 계산할 때 오류
+            postfix.push_back(token);
+            is_unary = false;
+        } else { // 연산자인 경우
+            if (is_unary && (token.symbol == '-' || token.symbol == '+')) { // 단항 연산자 처리
+                if (token.symbol == '+') continue; // 단항 '+'는 무시
+                // 단항 '-' 처리 (뒤의 숫자나 변수 이름에 부호를 붙인 토큰 하나로 만듦)
+                Token operand;
+                if (lexer.peek(operand) && (operand.kind == Token::NUMBER || operand.kind == Token::NAME ||
+                                            (operand.kind == Token::INVALID && operand.symbol == 0))) {
+                    lexer.next(operand);
+                    operand.negative = true;
+                    operand.value = -operand.value;
+                    token = operand;
                 }
-                i--;
-                postfix.push_back(number);
+                postfix.push_back(token); // 부호를 붙일 수 없으면 '-' 그대로 (계산할 때 구조 오류)
                 is_unary = false;
-            } else { //   ó
-                while (!operators.empty() && operators.top() != "(" && getPrecedence(op) <= getPrecedence(operators.top())) {
-                    postfix.push_back(operators.top());
-                    operators.pop();
+            } else { // 이항 연산자 처리
+                while (!operators.empty() && operators.back().kind != Token::OPEN &&
+                       getPrecedence(token.symbol) <= getPrecedence(operators.back().symbol)) {
+                    postfix.push_back(operators.back());
+                    operators.pop_back();
                 }
-                operators.push(op);
+                operators.push_back(token);
                 is_unary = true;
             }
         }
     }
 
-    // ÿ  ڵ   ߰
+    // 스택에 남은 연산자들을 모두 결과에 추가
     while (!operators.empty()) {
-        if (operators.top() == "(") throw runtime_error(": ȣ   ʽϴ.");
-        postfix.push_back(operators.top());
-        operators.pop();
+        if (operators.back().kind == Token::OPEN) throw runtime_error("오류: 괄호 쌍이 맞지 않습니다.");
+        postfix.push_back(operators.back());
+        operators.pop_back();
     }
 
     return postfix;
 }
 
 /**
- * @brief ־ ڿ ȿ  Ȯմϴ.
- * @param s Ȯ ڿ
- * @return ̸ true, ƴϸ false
+ * @brief 후위 표기법 수식을 토큰으로 나눕니다. 숫자나 이름에 붙은 '-', '+'는 부호이고 `**`는 `^`입니다.
+ * @param expr 후위 표기법 문자열
+ * @return 토큰 (expr을 가리키므로 expr이 살아 있는 동안만 사용)
  */
-bool isNumber(const string& s) {
-    if (s.empty()) return false;
-    try {
-        (void)stod(s); // ڿ double ȯ õ. ȯ  Ͽ C4834  մϴ.
-        return true;
-    } catch (const invalid_argument&) {
-        return false;
-    } catch (const out_of_range&) {
-        return false;
+vector<Token> tokenizePostfix(const string& expr) {
+    vector<Token> tokens;
+    Lexer lexer(expr, true);
+    Token token;
+    while (lexer.next(token)) tokens.push_back(token);
+    return tokens;
+}
+
+/**
+ * @brief 주어진 문자열이 변수 이름인지 확인합니다. (영문자나 '_'로 시작, 앞에 단항 '-' 허용)
+ * @param s 확인할 문자열
+ * @return 변수 이름이면 true, 아니면 false
+ */
+bool isVariableName(const string& s) {
+    return isVariableName(s.data(), s.length());
+}
+
+/**
+ * @brief 문자열 s[0..length)가 변수 이름인지 확인합니다. (문자열을 복사하지 않는 판정)
+ */
+bool isVariableName(const char* s, size_t length) {
+    size_t start = (length > 0 && s[0] == '-') ? 1 : 0;
+    if (start >= length || !(isalpha(static_cast<unsigned char>(s[start])) || s[start] == '_')) return false;
+    for (size_t i = start + 1; i < length; ++i) {
+        if (!isalnum(static_cast<unsigned char>(s[i])) && s[i] != '_') return false;
     }
+    return true;
+}
+
+/**
+ * @brief 후위 표기법으로 표현된 수식을 계산합니다.
+ * @param postfix 후위 표기법 토큰
+ * @param source 토큰이 가리키는 원본 문자열
+ * @return 계산 결과
+ */
+double evaluatePostfix(const vector<Token>& postfix, const string& source) {
+    return evaluatePostfix(postfix, source, map<string, double>());
 }
 
 /**
- * @brief  ǥ ǥ  մϴ.
- * @param postfix  ǥ ū 
- * @return  
+ * @brief 변수가 들어 있는 후위 표기법 수식을 계산합니다.
+ * @param postfix 후위 표기법 토큰
+ * @param source 토큰이 가리키는 원본 문자열
+ * @param variables 변수 이름과 값
+ * @return 계산 결과
  */
-double evaluatePostfix(const vector<string>& postfix) {
+double evaluatePostfix(const vector<Token>& postfix, const string& source, const map<string, double>& variables) {
     if (postfix.empty()) {
-        throw runtime_error(":  ǥԴϴ.");
+        throw runtime_error("오류: 빈 표현식입니다.");
     }
     stack<double> values;
-    for (const string& token : postfix) {
-        if (isNumber(token)) { // ū ̸ ÿ push
-            values.push(stod(token));
-        } else if (token == "+" || token == "-" || token == "*" || token == "/" || token == "^") { // ū ̸
-            if (values.size() < 2) throw runtime_error(": ǥ  ߸Ǿϴ.");
+    string name; // 변수를 찾을 때 이름을 담는 버퍼 (토큰마다 새로 만들지 않고 다시 씀)
+    for (const Token& token : postfix) {
+        if (token.kind == Token::NAME) { // 변수이면 저장된 값을 push
+            name.assign(source, token.offset, token.length);
+            map<string, double>::const_iterator it = variables.find(name);
+            if (it == variables.end()) throw runtime_error("오류: 정의되지 않은 변수입니다: " + tokenText(source, token));
+            values.push(token.negative ? -it->second : it->second);
+        } else if (token.kind == Token::NUMBER) { // 토큰이 숫자이면 스택에 push
+            values.push(token.value);
+        } else if (token.kind == Token::OPERATOR) { // 토큰이 연산자이면
+            if (values.size() < 2) throw runtime_error("오류: 표현식 구조가 잘못되었습니다.");
             double val2 = values.top(); values.pop();
             double val1 = values.top(); values.pop();
-            values.push(applyOperation(val1, val2, token)); //     ٽ ÿ push
+            values.push(applyOperation(val1, val2, token.symbol)); // 연산 수행 후 결과를 다시 스택에 push
         } else {
-            throw runtime_error(": ǥĿ ߸ ū ֽϴ: " + token);
+            throw runtime_error("오류: 표현식에 잘못된 토큰이 있습니다: " + tokenText(source, token));
         }
     }
-    if (values.size() != 1) throw runtime_error(":  ǥ ߸Ǿϴ.");
+    if (values.size() != 1) throw runtime_error("오류: 최종 표현식이 잘못되었습니다.");
     return values.top();
 }
 
 /**
- * @brief ǥ  ǥ (heuristic)Ͽ Ȯմϴ.
- *         Լ Ϻ , Ϲ 츦  ϰ Ǵϱ  ˴ϴ.
- * @param expr Ȯ ǥ ڿ
- * @return  ǥ ǴܵǸ true, ƴϸ false
+ * @brief 모든 값이 정수이고 long long 범위를 넘지 않는 수식을 Number 없이 바로 계산합니다.
+ *        나누어떨어지지 않는 나눗셈, 소수, 오버플로, 잘못된 구조를 만나면 false를 반환하고
+ *        evaluateExact가 처음부터 다시 계산합니다. (오류 메시지도 그쪽에서 만듦)
+ * @param result 성공하면 계산 결과
+ * @return 끝까지 정수로 계산했으면 true
+ */
+bool evaluateInteger(const vector<Token>& postfix, const string& source, const map<string, Number>& variables, long long& result) {
+    vector<long long> values;
+    values.reserve(postfix.size());
+    string name;
+    for (const Token& token : postfix) {
+        long long value;
+        if (token.kind == Token::NUMBER) {
+            if (token.length > 18) return false;
+            value = 0;
+            for (size_t i = token.offset; i < token.offset + token.length; ++i) {
+                if (source[i] == '.') return false;
+                value = value * 10 + (source[i] - '0');
+            }
+            values.push_back(token.negative ? -value : value);
+        } else if (token.kind == Token::NAME) {
+            name.assign(source, token.offset, token.length);
+            map<string, Number>::const_iterator it = variables.find(name);
+            if (it == variables.end() || it->second.getKind() != Number::INTEGER) return false;
+            value = it->second.toInteger();
+            if (token.negative && checkedSub(0, value, &value)) return false;
+            values.push_back(value);
+        } else if (token.kind == Token::OPERATOR && values.size() >= 2) {
+            long long b = values.back();
+            values.pop_back();
+            long long& a = values.back();
+            bool overflow;
+            switch (token.symbol) {
+            case '+': overflow = checkedAdd(a, b, &a); break;
+            case '-': overflow = checkedSub(a, b, &a); break;
+            case '*': overflow = checkedMul(a, b, &a); break;
+            case '/':
+                if (b == 0 || (a == LLONG_MIN && b == -1) || a % b != 0) return false;
+                a /= b;
+                overflow = false;
+                break;
+            case '^': { // 제곱을 반복하는 거듭제곱 (exponentiation by squaring)
+                if (b < 0) return false;
+                long long base = a;
+                a = 1;
+                overflow = false;
+                for (unsigned long long e = static_cast<unsigned long long>(b); e > 0 && !overflow; e >>= 1) {
+                    if (e & 1) overflow = checkedMul(a, base, &a);
+                    if (e > 1 && !overflow) overflow = checkedMul(base, base, &base);
+                }
+                break;
+            }
+            default: return false;
+            }
+            if (overflow) return false;
+        } else {
+            return false;
+        }
+    }
+    if (values.size() != 1) return false;
+    result = values.back();
+    return true;
+}
+
+/**
+ * @brief evaluatePostfix와 같은 방식으로 계산하되, 정수와 분수를 반올림 없이 정확하게 계산합니다.
+ *        (예: 0.1 + 0.2 = 3/10, 2 ^ 100 = 1267650600228229401496703205376)
+ * @param postfix 후위 표기법 토큰
+ * @param source 토큰이 가리키는 원본 문자열
+ * @param variables 변수 이름과 값
+ * @return 계산 결과
+ */
+Number evaluateExact(const vector<Token>& postfix, const string& source, const map<string, Number>& variables) {
+    if (postfix.empty()) {
+        throw runtime_error("오류: 빈 표현식입니다.");
+    }
+    long long integer;
+    if (evaluateInteger(postfix, source, variables, integer)) return Number::fromInteger(integer);
+
+    vector<Number> values; // Number는 복사 비용이 있어 stack 대신 vector를 직접 씀
+    values.reserve(postfix.size());
+    string name;
+    for (const Token& token : postfix) {
+        if (token.kind == Token::NAME) {
+            name.assign(source, token.offset, token.length);
+            map<string, Number>::const_iterator it = variables.find(name);
+            if (it == variables.end()) throw runtime_error("오류: 정의되지 않은 변수입니다: " + tokenText(source, token));
+            values.push_back(token.negative ? -it->second : it->second);
+        } else if (token.kind == Token::NUMBER) { // 숫자는 double 값 대신 원본 글자에서 정확히 읽음
+            values.push_back(Number::parse(source.data() + token.offset, token.length, token.negative));
+        } else if (token.kind == Token::OPERATOR) {
+            if (values.size() < 2) throw runtime_error("오류: 표현식 구조가 잘못되었습니다.");
+            Number result = applyExact(values[values.size() - 2], values.back(), token.symbol);
+            values.pop_back();
+            values.back() = move(result);
+        } else {
+            throw runtime_error("오류: 표현식에 잘못된 토큰이 있습니다: " + tokenText(source, token));
+        }
+    }
+    if (values.size() != 1) throw runtime_error("오류: 최종 표현식이 잘못되었습니다.");
+    return values.back();
+}
+
+/**
+ * @brief 표현식이 후위 표기법인지 어림짐작(heuristic)하여 확인합니다.
+ *        이 함수는 완벽하지 않지만, 일반적인 경우를 빠르고 간단하게 판단하기 위해 사용됩니다.
+ * @param expr 확인할 표현식 문자열
+ * @return 후위 표기법으로 판단되면 true, 아니면 false
  */
 bool isPostfix(const string& expr) {
-    // 1. ȣ Ȯ:  ǥ ȣ ϴ. ȣ ϳ   ǥ մϴ.
+    // 1. 괄호 확인: 후위 표기법에는 괄호가 없습니다. 괄호가 하나라도 있으면 중위 표기법으로 간주합니다.
     if (expr.find('(') != string::npos || expr.find(')') != string::npos) {
         return false;
     }
 
-    // 2. ū и:   ڿ ū(, ) ϴ.
-    stringstream ss(expr);
-    string token;
-    vector<string> tokens;
-    while (ss >> token) { //stringstreaem >>ڸ Ͽ   ū и
-        tokens.push_back(token);
-    }
-
-    //  ǥ ּ 3 ū(: 3 4 +) ʿ, 2(: 3 4)   Ƿ ּ 2 ˻մϴ.
-    if (tokens.size() < 2) return false;
+    // 2. 토큰 분리: 공백을 기준으로 문자열을 토큰(숫자, 연산자)으로 나눕니다.
+    //    토큰을 복사하지 않고 원본에서의 시작 위치와 길이만 봅니다.
+    const char* text = expr.c_str(); // 널 문자로 끝나므로 strtod가 토큰 뒤의 공백이나 끝에서 멈춤
+    auto isOperand = [](const char* t, size_t length) {
+        char* end = nullptr;
+        errno = 0;
+        (void)strtod(t, &end); // stod와 같은 판정이지만 예외를 쓰지 않음 (예외 처리는 일괄 계산 스레드들이 서로 기다리게 함)
+        return (end != t && errno != ERANGE) || isVariableName(t, length);
+    };
+    auto isOperatorToken = [](const char* t, size_t length) {
+        return (length == 2 && t[0] == '*' && t[1] == '*') ||
+               (length == 1 && (t[0] == '^' || t[0] == '*' || t[0] == '/' || t[0] == '+' || t[0] == '-'));
+    };
 
-    // 3. ǿڿ   
+    // 3. 피연산자와 연산자 개수 세기
+    size_t token_count = 0;
     int num_count = 0;
     int op_count = 0;
-    for (const auto& t : tokens) {
-        if (isNumber(t)) {
+    bool first_two_operands = true; // 처음 두 토큰이 모두 피연산자인지
+    bool last_is_op = false;        // 마지막 토큰이 연산자인지
+    for (size_t i = 0; i < expr.length();) {
+        if (isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while (i < expr.length() && !isspace(static_cast<unsigned char>(text[i]))) i++;
+        bool operand = isOperand(text + start, i - start);
+        last_is_op = isOperatorToken(text + start, i - start);
+        if (operand) {
             num_count++;
-        } else if (t == "**" || t == "^" || t == "*" || t == "/" || t == "+" || t == "-") {
+        } else if (last_is_op) {
             op_count++;
         }
+        if (token_count < 2 && !operand) first_two_operands = false;
+        token_count++;
     }
 
-    // 4.  ǥ ֿ Ư¡ ̿ ޸ƽ() ˻
-    
-    // ޸ƽ 1: " ū "̰ "ǿ  =   + 1" Ģ ϴ°?
-    // ̴  ǥ   Ư¡  ϳԴϴ. (: 3 4 + -> ǿ 2,  1)
-    const string& last_token = tokens.back();
-    bool last_is_op = (last_token == "**" || last_token == "^" || last_token == "*" || last_token == "/" || last_token == "+" || last_token == "-");
+    // 후위 표기법은 최소 3개의 토큰(예: 3 4 +)이 필요하지만, 2개(예: 3 4)만 들어올 수도 있으므로 최소 2개로 검사합니다.
+    if (token_count < 2) return false;
 
+    // 4. 후위 표기법의 주요 특징을 이용한 휴리스틱(어림짐작) 검사
+    
+    // 휴리스틱 1: "마지막 토큰은 연산자"이고 "피연산자 수 = 연산자 수 + 1" 규칙을 만족하는가?
+    // 이는 후위 표기법의 가장 강력한 특징 중 하나입니다. (예: 3 4 + -> 피연산자 2개, 연산자 1개)
     if (last_is_op && num_count == op_count + 1) {
         return true;
     }
     
-    // ޸ƽ 2: "ó  ū  ΰ?"
-    //  ǥ  '  ' ,  ǥ '  '  մϴ.
-    //  '3 4 +'   ó   ؼ ڰ   ǥ ɼ ϴ.
-    if (tokens.size() >= 3 && isNumber(tokens[0]) && isNumber(tokens[1])) {
+    // 휴리스틱 2: "처음 두 토큰이 모두 숫자인가?"
+    // 중위 표기법은 보통 '숫자 연산자 숫자' 순서이지만, 후위 표기법은 '숫자 숫자 연산자' 순서로 시작합니다.
+    // 따라서 '3 4 +' 와 같이 처음 두 개가 연속해서 숫자가 나오면 후위 표기법일 가능성이 높습니다.
+    if (token_count >= 3 && first_two_operands) {
         return true;
     }
 
-    //  ޸ƽ ˻縦   ϸ  ǥ մϴ.
+    // 위의 휴리스틱 검사를 모두 통과하지 못하면 중위 표기법으로 간주합니다.
     return false;
 }
 
+/**
+ * @brief 후위 표기법 토큰을 한 번만 해석해 만든 프로그램.
+ *        숫자는 constants에, 변수는 variables에 모아 두고 명령어는 그 번호만 가리킵니다.
+ */
+struct BytecodeProgram {
+    enum Op { PUSH, LOAD, NEG_LOAD, ADD, SUB, MUL, DIV, POW };
+    struct Instruction {
+        Op op;
+        size_t operand; // PUSH: 상수 번호, LOAD / NEG_LOAD: 변수 번호
+    };
+    vector<Instruction> code;
+    vector<double> constants;
+    vector<string> variables; // 수식에 처음 나온 순서
+    size_t max_depth = 0;     // 계산 스택의 최대 깊이
+};
+
+const size_t BLOCK_ROWS = 1024; // 열 단위 계산에서 명령어 하나가 한 번에 처리하는 행 수
 
 /**
- * @brief  Լ. input.txt Ͽ  پ  оɴϴ.
- *          ǥ  ǥ ǴϿ  ´ ó  ,
- *          մϴ.
+ * @brief 후위 표기법 토큰을 BytecodeProgram으로 컴파일합니다.
+ * @param postfix 후위 표기법 토큰 (infixToPostfix의 결과)
+ * @param source 토큰이 가리키는 원본 문자열
+ * @return 컴파일된 프로그램
  */
-int main() {
-    ifstream inputFile("input.txt");
-    if (!inputFile.is_open()) {
-        cerr << ": input.txt    ϴ." << endl;
-        return 1;
+BytecodeProgram compileProgram(const vector<Token>& postfix, const string& source) {
+    BytecodeProgram program;
+    size_t depth = 0;
+    for (const Token& token : postfix) {
+        BytecodeProgram::Instruction instruction = { BytecodeProgram::PUSH, 0 };
+        if (token.kind == Token::NAME) {
+            // 이름은 원본을 가리킨 채 비교하고, 처음 나온 이름만 복사
+            size_t index = 0;
+            while (index < program.variables.size() && source.compare(token.offset, token.length, program.variables[index]) != 0) index++;
+            instruction.op = token.negative ? BytecodeProgram::NEG_LOAD : BytecodeProgram::LOAD;
+            instruction.operand = index;
+            if (index == program.variables.size()) program.variables.push_back(source.substr(token.offset, token.length));
+            depth++;
+        } else if (token.kind == Token::NUMBER) {
+            program.constants.push_back(token.value);
+            instruction.operand = program.constants.size() - 1;
+            depth++;
+        } else if (token.kind == Token::OPERATOR) {
+            if (depth < 2) throw runtime_error("오류: 표현식 구조가 잘못되었습니다.");
+            instruction.op = token.symbol == '+' ? BytecodeProgram::ADD : token.symbol == '-' ? BytecodeProgram::SUB
+                : token.symbol == '*' ? BytecodeProgram::MUL : token.symbol == '/' ? BytecodeProgram::DIV : BytecodeProgram::POW;
+            depth--;
+        } else {
+            throw runtime_error("오류: 표현식에 잘못된 토큰이 있습니다: " + tokenText(source, token));
+        }
+        program.code.push_back(instruction);
+        program.max_depth = max(program.max_depth, depth);
+    }
+    if (depth != 1) throw runtime_error("오류: 최종 표현식이 잘못되었습니다.");
+    return program;
+}
+
+// 블록 연산자: 한 행짜리와 (SSE2가 있으면) 두 행짜리 계산을 함께 제공
+struct AddOp {
+    double operator()(double a, double b) const { return a + b; }
+#ifdef CALC_USE_SSE2
+    __m128d operator()(__m128d a, __m128d b) const { return _mm_add_pd(a, b); }
+#endif
+};
+struct SubOp {
+    double operator()(double a, double b) const { return a - b; }
+#ifdef CALC_USE_SSE2
+    __m128d operator()(__m128d a, __m128d b) const { return _mm_sub_pd(a, b); }
+#endif
+};
+struct MulOp {
+    double operator()(double a, double b) const { return a * b; }
+#ifdef CALC_USE_SSE2
+    __m128d operator()(__m128d a, __m128d b) const { return _mm_mul_pd(a, b); }
+#endif
+};
+struct DivOp {
+    double operator()(double a, double b) const { return a / b; }
+#ifdef CALC_USE_SSE2
+    __m128d operator()(__m128d a, __m128d b) const { return _mm_div_pd(a, b); }
+#endif
+};
+
+/**
+ * @brief 블록 하나에 이항 연산을 적용합니다. (out[i] = op(a[i], b[i]), out은 a와 같아도 됨)
+ */
+template <typename Op>
+void applyBlock(const double* a, const double* b, double* out, size_t n, Op op) {
+    size_t i = 0;
+#ifdef CALC_USE_SSE2
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, op(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
     }
+#endif
+    for (; i < n; ++i) out[i] = op(a[i], b[i]);
+}
 
-    string line;
-    while (getline(inputFile, line)) { //   
-        if (line.empty() || line.find_first_not_of(" \t\n\r") == string::npos) continue; // ̸  ٷ
+/**
+ * @brief 컴파일된 수식을 열(column) 단위 데이터 전체에 적용합니다.
+ *        BLOCK_ROWS행씩 끊어 명령어 하나를 블록 전체에 적용하므로 명령어 해석은 블록마다 한 번뿐이고,
+ *        변수 열은 복사하지 않고 가리키기만 하며 스택 맨 아래 칸의 결과는 out에 바로 씁니다.
+ * @param program 컴파일된 프로그램
+ * @param columns columns[i]는 program.variables[i]의 값 rows개
+ * @param rows 행 수
+ * @param out 결과를 쓸 배열 (rows개)
+ */
+void evaluateColumns(const BytecodeProgram& program, const vector<const double*>& columns, size_t rows, double* out) {
+    if (columns.size() != program.variables.size()) throw runtime_error("오류: 열 개수가 변수 개수와 다릅니다.");
+    vector<double> scratch(program.max_depth * BLOCK_ROWS);
+    vector<const double*> slot(program.max_depth); // 스택 칸마다 현재 값이 있는 위치
 
-        cout << "Է: " << line << endl; //Է¹  
-        try {
-            double result;
-            if (isPostfix(line)) { //  ǥ ó,  ǥ   
-                stringstream ss(line);
-                string token;
-                vector<string> tokens;
-                while (ss >> token) {
-                    if (token == "**") token = "^"; //  ǥ ** ^ ȯ
-                    tokens.push_back(token);
+    for (size_t begin = 0; begin < rows; begin += BLOCK_ROWS) {
+        size_t n = min(BLOCK_ROWS, rows - begin);
+        size_t top = 0;
+        for (const BytecodeProgram::Instruction& instruction : program.code) {
+            if (instruction.op == BytecodeProgram::LOAD) {
+                slot[top++] = columns[instruction.operand] + begin;
+                continue;
+            }
+            // 결과를 쓸 스택 칸 (PUSH, NEG_LOAD는 새 칸, 이항 연산은 두 피연산자 중 아래 칸)
+            size_t index = (instruction.op == BytecodeProgram::PUSH || instruction.op == BytecodeProgram::NEG_LOAD) ? top : top - 2;
+            double* target = index == 0 ? out + begin : &scratch[index * BLOCK_ROWS];
+            switch (instruction.op) {
+            case BytecodeProgram::PUSH:
+                fill(target, target + n, program.constants[instruction.operand]);
+                top++;
+                break;
+            case BytecodeProgram::NEG_LOAD: {
+                const double* source = columns[instruction.operand] + begin;
+                for (size_t i = 0; i < n; ++i) target[i] = -source[i];
+                top++;
+                break;
+            }
+            case BytecodeProgram::ADD: applyBlock(slot[top - 2], slot[top - 1], target, n, AddOp()); top--; break;
+            case BytecodeProgram::SUB: applyBlock(slot[top - 2], slot[top - 1], target, n, SubOp()); top--; break;
+            case BytecodeProgram::MUL: applyBlock(slot[top - 2], slot[top - 1], target, n, MulOp()); top--; break;
+            case BytecodeProgram::DIV: {
+                // 0으로 나누는 행이 있는지 먼저 세고 (분기 없는 반복이라 벡터화됨), 있으면 첫 행을 찾아 보고
+                const double* divisor = slot[top - 1];
+                size_t zeros = 0;
+                for (size_t i = 0; i < n; ++i) zeros += divisor[i] == 0;
+                if (zeros > 0) {
+                    size_t row = static_cast<size_t>(find(divisor, divisor + n, 0.0) - divisor);
+                    throw runtime_error("오류: 0으로 나눌 수 없습니다. (" + to_string(begin + row + 1) + "번째 행)");
                 }
-                result = evaluatePostfix(tokens); //  
-            } else { //  ǥ ó
-                string processed_line = preprocess(line);
-                vector<string> postfix = infixToPostfix(processed_line);
-                result = evaluatePostfix(postfix);
+                applyBlock(slot[top - 2], divisor, target, n, DivOp());
+                top--;
+                break;
             }
-            
-            //    ſ   
-            if (abs(result - round(result)) < 1e-9) {
-                 cout << ": " << static_cast<long long>(round(result)) << endl;
-            } else {
-                 cout << ": " << result << endl;
+            default: // POW는 벡터 명령이 없어 한 행씩 계산
+                for (size_t i = 0; i < n; ++i) target[i] = pow(slot[top - 2][i], slot[top - 1][i]);
+                top--;
+                break;
             }
+            slot[top - 1] = target;
+        }
+        if (slot[0] != out + begin) copy(slot[0], slot[0] + n, out + begin); // 변수 하나뿐인 수식
+    }
+}
+
+/**
+ * @brief 열 단위 계산의 처리량을 측정합니다. 변수마다 1~100 사이의 임의의 값으로 된 열을 만듭니다.
+ * @param expr 중위 표기법 수식
+ * @param rows 행 수
+ */
+void benchmarkColumns(const string& expr, size_t rows) {
+    vector<Token> postfix = infixToPostfix(expr);
+    BytecodeProgram program = compileProgram(postfix, expr);
+
+    mt19937 rng(12345);
+    uniform_real_distribution<double> value(1.0, 100.0);
+    vector<vector<double>> data(program.variables.size(), vector<double>(rows));
+    vector<const double*> columns;
+    for (vector<double>& column : data) {
+        for (double& x : column) x = value(rng);
+        columns.push_back(column.data());
+    }
+    vector<double> out(rows);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    evaluateColumns(program, columns, rows, out.data());
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    // 앞쪽 1000행은 evaluatePostfix 결과와 비교
+    size_t mismatches = 0;
+    for (size_t r = 0; r < rows && r < 1000; ++r) {
+        map<string, double> variables;
+        for (size_t v = 0; v < program.variables.size(); ++v) variables[program.variables[v]] = data[v][r];
+        double expected = evaluatePostfix(postfix, expr, variables);
+        if (abs(out[r] - expected) > 1e-12 * abs(expected)) mismatches++;
+    }
+
+    double bytes = static_cast<double>(rows) * sizeof(double) * (program.variables.size() + 1);
+    cout << "변수 " << program.variables.size() << "개, " << rows << "행: " << ms << " ms ("
+         << rows / ms / 1e3 << " 백만 행/초, " << bytes / ms / 1e6 << " GB/s), 앞쪽 1000행 불일치 " << mismatches << "개" << endl;
+}
+
+/**
+ * @brief 렉서와 중위 -> 후위 변환의 처리량(초당 토큰 수)을 측정합니다.
+ * @param expr 중위 표기법 수식
+ * @param repeat 반복 횟수
+ */
+void benchmarkTokens(const string& expr, size_t repeat) {
+    const string& infix = expr;
+    Lexer counter(infix);
+    Token token;
+    size_t count = 0;
+    while (counter.next(token)) count++;
+    (void)infixToPostfix(infix); // 잘못된 수식이면 여기서 예외
+
+    double checksum = 0; // 반복이 최적화로 사라지지 않도록 결과를 더해 둠
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < repeat; ++i) {
+        Lexer lexer(infix);
+        while (lexer.next(token)) checksum += token.value + static_cast<double>(token.length);
+    }
+    double lex_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < repeat; ++i) checksum += static_cast<double>(infixToPostfix(infix).size());
+    double convert_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    double tokens = static_cast<double>(count) * static_cast<double>(repeat);
+    cout << "토큰 " << count << "개, " << repeat << "회 반복" << endl;
+    cout << "  토큰 분리: " << lex_ms << " ms (" << tokens / lex_ms / 1e3 << " 백만 토큰/초)" << endl;
+    cout << "  후위 표기 변환: " << convert_ms << " ms (" << tokens / convert_ms / 1e3 << " 백만 토큰/초)" << endl;
+    cout << "  (검증용 합계 " << checksum << ")" << endl;
+}
+
+/**
+ * @brief 같은 수식을 double 계산(evaluatePostfix)과 정확한 계산(evaluateExact)으로 반복해 시간을 비교합니다.
+ * @param expr 중위 또는 후위 표기법 수식 (변수 없음)
+ * @param repeat 반복 횟수
+ */
+void benchmarkNumeric(const string& expr, size_t repeat) {
+    vector<Token> postfix = isPostfix(expr) ? tokenizePostfix(expr) : infixToPostfix(expr);
+    map<string, double> real_variables;
+    map<string, Number> exact_variables;
+    double real = evaluatePostfix(postfix, expr, real_variables);
+    Number exact = evaluateExact(postfix, expr, exact_variables);
+
+    double checksum = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < repeat; ++i) checksum += evaluatePostfix(postfix, expr, real_variables);
+    double real_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < repeat; ++i) checksum += evaluateExact(postfix, expr, exact_variables).isZero() ? 0 : 1;
+    double exact_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    static const char* const kinds[] = { "정수", "분수", "큰 수", "실수" };
+    cout << setprecision(17);
+    cout << "double 계산: " << real << " (" << real_ms * 1e6 / static_cast<double>(repeat) << " ns/회)" << endl;
+    cout << "정확한 계산: " << exact.toString() << " [" << kinds[exact.getKind()] << "] ("
+         << exact_ms * 1e6 / static_cast<double>(repeat) << " ns/회)" << endl;
+    cout << "  (검증용 합계 " << checksum << ")" << endl;
+}
+
+/**
+ * @brief 수식 한 줄을 계산해 "입력: / 결과: / ----" 형식으로 out에 씁니다.
+ *        "이름 = 수식" 줄이면 결과를 variables에 저장합니다.
+ * @param line 수식 한 줄 (빈 줄은 호출하지 않음)
+ * @param variables 지금까지 저장된 변수
+ * @param out 출력 스트림
+ * @param error 실패하면 오류 메시지를 받음 (nullptr이면 무시)
+ * @return 계산에 성공하면 true
+ */
+bool processLine(const string& line, map<string, Number>& variables, ostream& out, string* error = nullptr) {
+    bool ok = true;
+    out << "입력: " << line << '\n'; //입력받은 수식 출력
+    try {
+        // 대입문이면 등호 앞의 이름을 저장할 변수로, 뒤를 계산할 수식으로 나눔
+        string target;
+        size_t equals = line.find('=');
+        string expr = line;
+        if (equals != string::npos) {
+            stringstream name(line.substr(0, equals));
+            string extra;
+            name >> target;
+            if (!isVariableName(target) || target[0] == '-' || (name >> extra)) throw runtime_error("오류: 잘못된 변수 이름입니다.");
+            expr = line.substr(equals + 1);
+        }
+
+        Number result;
+        if (isPostfix(expr)) { // 후위 표기법 처리, 후위 표기면 후위 연산으로 진행 (렉서가 **도 ^로 읽음)
+            vector<Token> tokens = tokenizePostfix(expr);
+            result = evaluateExact(tokens, expr, variables); //후위 연산 진행
+        } else { // 중위 표기법 처리
+            vector<Token> postfix = infixToPostfix(expr); // **와 암시적 곱셈은 렉서가 처리
+            result = evaluateExact(postfix, expr, variables);
+        }
+
+        // 정확한 정수는 모든 자리를 출력하고, 나머지는 double로 바꿔 정수에 매우 가까우면 정수로 출력
+        double value = result.toDouble();
+        if (result.isInteger()) {
+             out << "결과: " << result.toString() << '\n';
+        } else if (abs(value - round(value)) < 1e-9 && abs(value) < 9e18) {
+             out << "결과: " << static_cast<long long>(round(value)) << '\n';
+        } else {
+             out << "결과: " << value << '\n';
+        }
+        if (!target.empty()) {
+            variables[target] = result;
+            out << "변수 저장: " << target << '\n';
+        }
+    } catch (const runtime_error& e) {
+        out << e.what() << '\n';
+        if (error) *error = e.what();
+        ok = false;
+    }
+    out << "--------------------" << '\n';
+    return ok;
+}
+
+/**
+ * @brief 읽기 전용으로 메모리에 매핑한 파일. 실패하면 생성자에서 runtime_error를 던집니다.
+ */
+class MappedInput {
+public:
+    explicit MappedInput(const string& path) : bytes(nullptr), length(0) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        mapping = nullptr;
+        if (file == INVALID_HANDLE_VALUE) throw runtime_error("오류: " + path + " 파일을 열 수 없습니다.");
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!bytes) {
+                release();
+                throw runtime_error("오류: " + path + " 파일을 메모리에 매핑할 수 없습니다.");
+            }
+        }
+#else
+        descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) throw runtime_error("오류: " + path + " 파일을 열 수 없습니다.");
+        struct stat st;
+        fstat(descriptor, &st);
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (view == MAP_FAILED) {
+                release();
+                throw runtime_error("오류: " + path + " 파일을 메모리에 매핑할 수 없습니다.");
+            }
+            bytes = static_cast<const char*>(view);
+            madvise(view, length, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    ~MappedInput() { release(); }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes;
+    size_t length;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int descriptor;
+#endif
+
+    void release() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+        if (descriptor >= 0) close(descriptor);
+        descriptor = -1;
+#endif
+        bytes = nullptr;
+    }
+
+    MappedInput(const MappedInput&);
+    MappedInput& operator=(const MappedInput&);
+};
+
+/**
+ * @brief [begin, end) 구간의 줄마다 callback(줄 번호, 줄)을 호출합니다. 빈 줄은 건너뛰고 줄 끝의 '\r'은 뗍니다.
+ */
+template <typename Callback>
+void forEachLine(const char* begin, const char* end, size_t first_line, Callback callback) {
+    size_t line_number = first_line;
+    string line;
+    while (begin < end) {
+        const char* newline = static_cast<const char*>(memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        const char* line_end = newline ? newline : end;
+        const char* content_end = (line_end > begin && line_end[-1] == '\r') ? line_end - 1 : line_end;
+        line.assign(begin, content_end);
+        if (!line.empty() && line.find_first_not_of(" \t\n\r") != string::npos) callback(line_number, line);
+        line_number++;
+        begin = newline ? newline + 1 : end;
+    }
+}
+
+/**
+ * @brief 큰 수식 파일을 여러 스레드로 계산하고 결과는 원래 줄 순서대로 씁니다.
+ *        파일을 메모리에 매핑해 줄 경계에 맞춘 조각(chunk)으로 나누고, 작업 스레드가 조각을 하나씩 가져가 계산합니다.
+ *        끝난 조각은 재정렬 버퍼에 두었다가 앞 조각이 모두 쓰인 뒤에 쓰므로 출력은 한 줄씩 계산한 결과와 같습니다.
+ *        재정렬 버퍼에는 최대 threads * 4개의 조각만 두어 출력이 밀려도 메모리가 무한히 늘지 않습니다.
+ *        대입문("이름 = 수식")은 뒤 줄에 영향을 주므로, 먼저 대입문만 순서대로 계산해 조각마다 시작 시점의 변수를 정해 둡니다.
+ * @param input_path 입력 파일
+ * @param out 결과를 쓸 스트림
+ * @param threads 작업 스레드 수 (0이면 하드웨어 스레드 수)
+ * @return 실패한 줄이 없으면 0, 있으면 1
+ */
+int runBatch(const string& input_path, ostream& out, unsigned threads) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    MappedInput input(input_path);
+    const char* data = input.data();
+    size_t size = input.size();
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    // 1. 줄 경계에 맞춰 조각 나누기 (스레드당 여러 개가 되도록 하되 너무 잘게 쪼개지 않음)
+    const size_t chunk_bytes = max<size_t>(64 * 1024, size / (threads * 16) + 1);
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        size_t first_line;             // 조각 첫 줄의 줄 번호 (1부터)
+        map<string, Number> variables; // 조각 시작 시점의 변수
+    };
+    vector<Chunk> chunks;
+    size_t line_number = 1;
+    map<string, Number> variables;
+    for (const char* begin = data; begin < data + size;) {
+        const char* end = begin + min(chunk_bytes, static_cast<size_t>(data + size - begin));
+        if (end < data + size) {
+            const char* newline = static_cast<const char*>(memchr(end, '\n', static_cast<size_t>(data + size - end)));
+            end = newline ? newline + 1 : data + size;
+        }
+        Chunk chunk = { begin, end, line_number, variables };
+
+        // 2. 대입문만 순서대로 계산해 다음 조각의 시작 변수를 만듦 ('='가 없는 조각은 줄 수만 셈)
+        if (memchr(begin, '=', static_cast<size_t>(end - begin))) {
+            ostringstream ignored;
+            forEachLine(begin, end, line_number, [&](size_t, const string& line) {
+                if (line.find('=') != string::npos) processLine(line, variables, ignored);
+            });
+        }
+        line_number += static_cast<size_t>(count(begin, end, '\n'));
+        chunks.push_back(chunk);
+        begin = end;
+    }
+
+    // 3. 작업 스레드가 조각을 계산하고, 이 스레드는 재정렬 버퍼에서 순서대로 꺼내 씀
+    struct Result {
+        bool ready = false;
+        string text;
+        size_t lines = 0;
+        vector<pair<size_t, string>> errors; // (줄 번호, 오류 메시지)
+    };
+    vector<Result> results(chunks.size());
+    const size_t window = threads * 4;
+    mutex lock;
+    condition_variable produced, consumed;
+    size_t written = 0; // 지금까지 쓴 조각 수
+    atomic<size_t> next(0);
+
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t index = next++; index < chunks.size(); index = next++) {
+                {
+                    unique_lock<mutex> guard(lock);
+                    consumed.wait(guard, [&]() { return index < written + window; });
+                }
+                Chunk& chunk = chunks[index];
+                Result result;
+                ostringstream text;
+                forEachLine(chunk.begin, chunk.end, chunk.first_line, [&](size_t number, const string& line) {
+                    string error;
+                    if (!processLine(line, chunk.variables, text, &error)) result.errors.push_back(make_pair(number, error));
+                    result.lines++;
+                });
+                result.text = text.str();
+                result.ready = true;
+                {
+                    lock_guard<mutex> guard(lock);
+                    results[index] = move(result);
+                }
+                produced.notify_one();
+            }
+        });
+    }
+
+    size_t total_lines = 0, failed_lines = 0;
+    vector<pair<size_t, string>> first_errors;
+    for (size_t index = 0; index < chunks.size(); ++index) {
+        Result result;
+        {
+            unique_lock<mutex> guard(lock);
+            produced.wait(guard, [&]() { return results[index].ready; });
+            result = move(results[index]);
+            results[index] = Result();
+        }
+        out << result.text;
+        total_lines += result.lines;
+        failed_lines += result.errors.size();
+        for (size_t e = 0; e < result.errors.size() && first_errors.size() < 10; ++e) first_errors.push_back(result.errors[e]);
+        {
+            lock_guard<mutex> guard(lock);
+            written = index + 1;
+        }
+        consumed.notify_all();
+    }
+    for (thread& worker : workers) worker.join();
+    out.flush();
+
+    // 4. 요약 (결과와 섞이지 않도록 표준 오류로)
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "일괄 계산: " << total_lines << "줄 (실패 " << failed_lines << "줄), 스레드 " << threads << "개, 조각 "
+         << chunks.size() << "개" << endl;
+    cerr << "  " << seconds << " 초, " << total_lines / seconds << " 줄/초, " << size / seconds / 1e6 << " MB/s" << endl;
+    for (const pair<size_t, string>& error : first_errors) {
+        cerr << "  " << error.first << "번째 줄: " << error.second << endl;
+    }
+    if (failed_lines > first_errors.size()) cerr << "  ... 외 " << failed_lines - first_errors.size() << "줄" << endl;
+    return failed_lines == 0 ? 0 : 1;
+}
+
+/**
+ * @brief 명령줄의 개수 인자를 읽습니다. stoul과 달리 숫자가 아니어도 예외를 던지지 않습니다.
+ * @param text 인자 문자열
+ * @param value 읽은 값
+ * @return 0 이상의 정수이면 true
+ */
+bool parseCount(const char* text, size_t& value) {
+    if (text[0] < '0' || text[0] > '9') return false;
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > SIZE_MAX) return false;
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+/**
+ * @brief 메인 함수. input.txt 파일에서 한 줄씩 수식을 읽어옵니다.
+ *        수식이 중위 표기법인지 후위 표기법인지 판단하여 각각에 맞는 처리를 한 후,
+ *        계산 결과를 출력합니다. "이름 = 수식" 줄은 결과를 변수에 저장해 다음 줄부터 쓸 수 있게 합니다.
+ *        main --columns "수식" [행 수]로 실행하면 열 단위 계산 처리량을 측정합니다.
+ *        main --tokens "수식" [반복 횟수]로 실행하면 토큰 분리 처리량을 측정합니다.
+ *        main --numeric "수식" [반복 횟수]로 실행하면 double 계산과 정확한 계산의 속도를 비교합니다.
+ *        main --batch [입력 파일] [출력 파일 또는 -] [스레드 수]로 실행하면 여러 스레드로 일괄 계산합니다.
+ */
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && string(argv[1]) == "--columns") {
+        size_t rows = 1000000;
+        if (argc >= 4 && !parseCount(argv[3], rows)) {
+            cerr << "사용법: main --columns \"수식\" [행 수]" << endl;
+            return 1;
+        }
+        try {
+            benchmarkColumns(argv[2], rows);
+        } catch (const runtime_error& e) {
+            cout << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc >= 3 && string(argv[1]) == "--tokens") {
+        size_t repeat = 1000000;
+        if (argc >= 4 && !parseCount(argv[3], repeat)) {
+            cerr << "사용법: main --tokens \"수식\" [반복 횟수]" << endl;
+            return 1;
+        }
+        try {
+            benchmarkTokens(argv[2], repeat);
+        } catch (const runtime_error& e) {
+            cout << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc >= 3 && string(argv[1]) == "--numeric") {
+        size_t repeat = 1000000;
+        if (argc >= 4 && !parseCount(argv[3], repeat)) {
+            cerr << "사용법: main --numeric \"수식\" [반복 횟수]" << endl;
+            return 1;
+        }
+        try {
+            benchmarkNumeric(argv[2], repeat);
         } catch (const runtime_error& e) {
             cout << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc >= 2 && string(argv[1]) == "--batch") {
+        string input_path = argc >= 3 ? argv[2] : "input.txt";
+        string output_path = argc >= 4 ? argv[3] : "-";
+        size_t threads = 0;
+        if (argc >= 5 && (!parseCount(argv[4], threads) || threads > 1024)) {
+            cerr << "사용법: main --batch [입력 파일] [출력 파일 또는 -] [스레드 수(0~1024, 0이면 코어 수)]" << endl;
+            return 1;
+        }
+        try {
+            if (output_path == "-") return runBatch(input_path, cout, static_cast<unsigned>(threads));
+            ofstream output(output_path, ios::binary);
+            if (!output.is_open()) {
+                cerr << "오류: " << output_path << " 파일을 만들 수 없습니다." << endl;
+                return 1;
+            }
+            return runBatch(input_path, output, static_cast<unsigned>(threads));
+        } catch (const runtime_error& e) {
+            cerr << e.what() << endl;
+            return 1;
         }
-        cout << "--------------------" << endl;
+    }
+
+    ifstream inputFile("input.txt");
+    if (!inputFile.is_open()) {
+        cerr << "오류: input.txt 파일을 열 수 없습니다." << endl;
+        return 1;
+    }
+
+    map<string, Number> variables; // "이름 = 수식" 줄로 저장한 변수
+    string line;
+    while (getline(inputFile, line)) { //여러 줄의 수식 대응
+        if (line.empty() || line.find_first_not_of(" \t\n\r") == string::npos) continue; //빈 줄이면 다음 줄로
+        processLine(line, variables, cout);
+        cout.flush();
     }
 
     inputFile.close();